@@ -34,8 +34,8 @@ BASE_NAME='libdataset';   # Base name for the project.
 PROJECT_PATH=$(pwd);   # Root path of the project.
 
 # Dependencies for tests and library (add as needed).
-TEST_DEPENDENCIES='-lmatrixmath -lstr';
-LIBRARY_DEPENDENCIES='-lmatrixmath -lstr';
+TEST_DEPENDENCIES='-lmatrixmath -lstr -lm -lpthread';
+LIBRARY_DEPENDENCIES='-lmatrixmath -lstr -lm -lpthread';
 
 # Search paths for library and test code.
 LIBRARY_CODE_SEARCH_PATHS="$PROJECT_PATH/include $PROJECT_PATH/src";
@@ -1,6 +1,11 @@
 #ifndef DATASET_H
 #define DATASET_H
 
+#include <stdint.h>
+
+struct dataset_storage;
+struct dataset_journal;
+
 /**
  * Represents a single data entry in the dataset.
  *
@@ -29,9 +34,9 @@ struct data_entries {
   /**
    * The number of data entries in the collection.
    *
-   * @var int
+   * @var int64_t
    */
-  int size;
+  int64_t size;
 
   /**
    * Array of pointers to data entries.
@@ -76,6 +81,17 @@ struct data_row {
    * @var struct data_row *
    */
   struct data_row *next;
+
+  /**
+   * The bulk storage holding the row, its entries and their values, or NULL if
+   * they were allocated one by one.
+   *
+   * The parts of a row held by a storage must not be freed or reallocated
+   * individually, destroying the row releases its reference to the storage.
+   *
+   * @var struct dataset_storage *
+   */
+  struct dataset_storage *storage;
 };
 
 /**
@@ -89,9 +105,9 @@ struct dataset {
   /**
    * The total number of rows in the dataset.
    *
-   * @var int
+   * @var int64_t
    */
-  int size;
+  int64_t size;
 
   /**
    * Iterator to traverse through the rows of the dataset.
@@ -108,6 +124,62 @@ struct dataset {
    * @var struct data_row *
    */
   struct data_row *last;
+
+  /**
+   * The journal the appended rows are logged to, or NULL.
+   *
+   * @var struct dataset_journal *
+   */
+  struct dataset_journal *journal;
+};
+
+/**
+ * Identifies the type of the value stored in a data entry.
+ *
+ * Data entries store untyped pointers, so the functions that need to read the
+ * stored values (statistics, normalization, batching, etc) receive the type of
+ * the entries from the caller.
+ */
+enum data_entry_type {
+  /**
+   * The entry stores a pointer to an `int`.
+   */
+  DATA_ENTRY_TYPE_INT,
+
+  /**
+   * The entry stores a pointer to a `double`.
+   */
+  DATA_ENTRY_TYPE_DOUBLE,
+
+  /**
+   * The entry stores a null-terminated string.
+   */
+  DATA_ENTRY_TYPE_STRING,
+
+  /**
+   * The entry stores a `struct vector`.
+   */
+  DATA_ENTRY_TYPE_VECTOR,
+
+  /**
+   * The entry stores a `struct dataset_sparse_vector`.
+   */
+  DATA_ENTRY_TYPE_SPARSE,
+};
+
+/**
+ * Identifies one of the two collections of data entries of a data row.
+ */
+enum data_row_side {
+  /**
+   * The input data entries of the row.
+   */
+  DATA_ROW_INPUTS,
+
+  /**
+   * The output data entries of the row.
+   */
+  DATA_ROW_OUTPUTS,
 };
 
 /**
@@ -132,6 +204,17 @@ struct data_entry *data_entry_create(void *value);
  */
 struct data_entry *data_entry_create_int(int value);
 
+/**
+ * Creates a data entry with a double value.
+ *
+ * @param double value
+ *   The double value to store in the data entry.
+ *
+ * @return struct data_entry *
+ *   A pointer to the newly created data entry, or NULL on failure.
+ */
+struct data_entry *data_entry_create_double(double value);
+
 /**
  * Destroys a data entry, freeing all allocated memory.
  *
@@ -143,13 +226,14 @@ void data_entry_destroy(struct data_entry *entry);
 /**
  * Creates a collection of data entries with the specified size.
  *
- * @param int size
+ * @param int64_t size
  *   The number of data entries to create.
  *
  * @return struct data_entries*
- *   A pointer to the newly created data entries collection, or NULL on failure.
+ *   A pointer to the newly created data entries collection, or NULL on failure,
+ *   including a negative size or one whose array would not fit in memory.
  */
-struct data_entries *data_entries_create(int size);
+struct data_entries *data_entries_create(int64_t size);
 
 /**
  * Destroys a collection of data entries, freeing all allocated memory.
@@ -179,6 +263,19 @@ struct data_row *data_row_create();
  */
 void data_row_destroy(struct data_row *row);
 
+/**
+ * Gets the input or output data entries of a data row.
+ *
+ * @param struct data_row *row
+ *   A pointer to the data row.
+ * @param enum data_row_side side
+ *   The collection of data entries to retrieve.
+ *
+ * @return struct data_entries*
+ *   A pointer to the requested data entries, or NULL if the row is NULL.
+ */
+struct data_entries *data_row_get_entries(struct data_row *row, enum data_row_side side);
+
 /**
  * Creates a new dataset instance.
  *
@@ -199,7 +296,9 @@ void dataset_destroy(struct dataset *data);
  * Appends a new row to the dataset.
  *
  * This function adds a new row to the end of the dataset. It uses the last_row
- * property to quickly find the current last row and attach the new row.
+ * property to quickly find the current last row and attach the new row. The row
+ * is appended on its own, any previous links of the row are replaced. When the
+ * dataset has a journal, the row is logged to it before being appended.
  *
  * @param struct dataset *data
  *   A pointer to the dataset to which the row will be appended.
@@ -207,10 +306,125 @@ void dataset_destroy(struct dataset *data);
  *   A pointer to the row to be appended to the dataset.
  *
  * @return int
- *   Returns 0 on success, or -1 if the operation fails (e.g., if data or new_row is NULL).
+ *   Returns 0 on success, or -1 if the operation fails (e.g., if data or new_row is NULL,
+ *   or the row could not be logged to the journal).
  */
 int dataset_append_row(struct dataset *data, struct data_row *row);
 
+/**
+ * Moves every row of a dataset to the end of another one in O(1).
+ *
+ * The row chain of the source is spliced after the last row of the destination,
+ * which takes ownership of the rows. The source is left empty and must still be
+ * destroyed by the caller. When the destination has a journal, the rows are
+ * logged to it first with `dataset_journal_write_rows`, which takes O(n): a row
+ * that can not be serialized fails the call with both datasets and the journal
+ * untouched, while a write failure also leaves the journal in error.
+ *
+ * @param struct dataset *destination
+ *   A pointer to the dataset receiving the rows.
+ * @param struct dataset *source
+ *   A pointer to the dataset giving its rows, different from the destination.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if a dataset is NULL, both are the same, or the
+ *   rows could not be logged to the journal.
+ */
+int dataset_concat(struct dataset *destination, struct dataset *source);
+
+/**
+ * Represents an independent read position over the rows of a dataset.
+ *
+ * Cursors are separate from the dataset and never modify it, so any number of
+ * threads can traverse the same dataset at once without locks, each with its own
+ * cursor, as long as no thread modifies the dataset meanwhile.
+ */
+struct dataset_cursor {
+  /**
+   * The dataset being traversed.
+   *
+   * @var const struct dataset *
+   */
+  const struct dataset *data;
+
+  /**
+   * The current row, or NULL when the cursor is past either end.
+   *
+   * @var struct data_row *
+   */
+  struct data_row *row;
+
+  /**
+   * The position of the current row, -1 before the first row and the size of
+   * the dataset past the last row.
+   *
+   * @var int64_t
+   */
+  int64_t position;
+};
+
+/**
+ * Places a cursor on the first row of a dataset.
+ *
+ * @param struct dataset_cursor *cursor
+ *   A pointer to the cursor.
+ * @param const struct dataset *data
+ *   A pointer to the dataset to traverse.
+ *
+ * @return struct data_row*
+ *   The first row, or NULL if the dataset is empty.
+ */
+struct data_row *dataset_cursor_begin(struct dataset_cursor *cursor, const struct dataset *data);
+
+/**
+ * Moves a cursor to the next row.
+ *
+ * @param struct dataset_cursor *cursor
+ *   A pointer to the cursor.
+ *
+ * @return struct data_row*
+ *   The next row, or NULL if the cursor moved past the last row.
+ */
+struct data_row *dataset_cursor_next(struct dataset_cursor *cursor);
+
+/**
+ * Moves a cursor to the previous row.
+ *
+ * @param struct dataset_cursor *cursor
+ *   A pointer to the cursor.
+ *
+ * @return struct data_row*
+ *   The previous row, or NULL if the cursor moved before the first row.
+ */
+struct data_row *dataset_cursor_prev(struct dataset_cursor *cursor);
+
+/**
+ * Moves a cursor to the row at the given position.
+ *
+ * The cursor walks from whichever of the first row, the current row or the last
+ * row is the closest to the position.
+ *
+ * @param struct dataset_cursor *cursor
+ *   A pointer to the cursor.
+ * @param int64_t position
+ *   The position of the row, from 0 to the size of the dataset (past the end).
+ *
+ * @return struct data_row*
+ *   The row at the position, or NULL if the position is out of range.
+ */
+struct data_row *dataset_cursor_seek(struct dataset_cursor *cursor, int64_t position);
+
+/**
+ * Checks whether a cursor is past either end of the dataset.
+ *
+ * @param const struct dataset_cursor *cursor
+ *   A pointer to the cursor.
+ *
+ * @return int
+ *   1 if the cursor has no current row, 0 otherwise.
+ */
+int dataset_cursor_at_end(const struct dataset_cursor *cursor);
+
 #endif // DATASET_H
 
 #ifndef DATASET_PRINT_H
@@ -238,6 +452,17 @@ void data_entry_print_int(struct data_entry *entry);
  */
 void data_entry_print_string(struct data_entry *entry);
 
+/**
+ * Prints the double value stored in a data entry.
+ *
+ * This function assumes that the value stored in the data entry is a double
+ * and prints it to the standard output.
+ *
+ * @param struct data_entry *entry
+ *   A pointer to the data entry containing the double value to print.
+ */
+void data_entry_print_double(struct data_entry *entry);
+
 /**
  * Prints the contents of a vector stored in a data entry.
  *
@@ -249,6 +474,18 @@ void data_entry_print_string(struct data_entry *entry);
  */
 void data_entry_print_vector(struct data_entry *entry);
 
+/**
+ * Prints the contents of a sparse vector stored in a data entry.
+ *
+ * This function assumes that the value stored in the data entry is a
+ * `struct dataset_sparse_vector` and prints its index/value pairs to the
+ * standard output.
+ *
+ * @param struct data_entry *entry
+ *   A pointer to the data entry containing the sparse vector to print.
+ */
+void data_entry_print_sparse(struct data_entry *entry);
+
 /**
  * Prints the contents of a collection of data entries.
  *
@@ -367,4 +604,2642 @@ struct dataset *dataset_string_encode(struct dataset *int_dataset);
  */
 struct dataset *dataset_one_hot_encode(struct dataset *int_encoded_dataset, int tokens_size);
 
+/**
+ * Decodes a one-hot (or probability) encoded dataset back into an integer dataset.
+ *
+ * This is the inverse of `dataset_one_hot_encode`: each vector entry is replaced by
+ * an integer entry holding the index of its largest value. The result can then be
+ * converted with `dataset_string_encode`.
+ *
+ * @param struct dataset *one_hot_dataset
+ *   A pointer to the dataset containing vector entries.
+ *
+ * @return struct dataset*
+ *   A new dataset containing the decoded integer values, or NULL if decoding fails.
+ */
+struct dataset *dataset_one_hot_decode(struct dataset *one_hot_dataset);
+
+/**
+ * Computes the index of the largest value of each row of a contiguous matrix.
+ *
+ * Ties are resolved to the lowest index.
+ *
+ * @param const double *matrix
+ *   The row-major matrix.
+ * @param int rows
+ *   The number of rows of the matrix.
+ * @param int columns
+ *   The number of columns of the matrix, greater than 0.
+ * @param int *indices
+ *   The array that receives one index per row.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the parameters are invalid.
+ */
+int dataset_argmax_rows(const double *matrix, int rows, int columns, int *indices);
+
+/**
+ * Decodes a contiguous matrix of one-hot vectors or probabilities into integer entries.
+ *
+ * Each row of the matrix is decoded into one integer entry holding its argmax, so a
+ * `rows x tokens_size` model output becomes the integer encoded sequence of a row.
+ *
+ * @param const double *matrix
+ *   The row-major matrix.
+ * @param int rows
+ *   The number of rows of the matrix.
+ * @param int columns
+ *   The number of columns of the matrix, greater than 0.
+ *
+ * @return struct data_entries*
+ *   A new data entries containing one integer entry per row, or NULL on failure.
+ */
+struct data_entries *data_entries_one_hot_decode(const double *matrix, int rows, int columns);
+
+/**
+ * Represents an encoder that keeps an encoded copy of a growing dataset up to date.
+ *
+ * The encoder remembers the last source row it processed, so each call to
+ * `dataset_encoder_sync` only encodes the rows appended since the previous call.
+ * Rows of the source dataset must only be appended while the encoder exists.
+ */
+struct dataset_encoder {
+  /**
+   * The dataset being encoded.
+   *
+   * @var struct dataset *
+   */
+  struct dataset *source;
+
+  /**
+   * The dataset holding the encoded rows, owned by the encoder.
+   *
+   * @var struct dataset *
+   */
+  struct dataset *output;
+
+  /**
+   * The last source row that was encoded, or NULL if none was.
+   *
+   * @var struct data_row *
+   */
+  struct data_row *last;
+
+  /**
+   * The array of tokens passed to the encoding function.
+   *
+   * @var char *
+   */
+  char *tokens;
+
+  /**
+   * The size of the tokens array.
+   *
+   * @var int
+   */
+  int tokens_size;
+
+  /**
+   * The function used to encode individual data entries.
+   *
+   * @var struct data_entries *(*)(struct data_entry *, char *, int)
+   */
+  struct data_entries *(*encode_entry)(struct data_entry *, char *, int);
+};
+
+/**
+ * Creates an incremental encoder with a custom encoding function.
+ *
+ * @param struct dataset *source
+ *   A pointer to the dataset to encode.
+ * @param char *tokens
+ *   The array of tokens passed to the encoding function, which must outlive the encoder.
+ * @param int tokens_size
+ *   The size of the tokens array.
+ * @param struct data_entries *(*encode_entry)(struct data_entry *, char *, int)
+ *   The function used to encode individual data entries, as in `dataset_encode`.
+ *
+ * @return struct dataset_encoder*
+ *   A pointer to the newly created encoder, or NULL on failure.
+ */
+struct dataset_encoder *dataset_encoder_create(struct dataset *source, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int));
+
+/**
+ * Creates an incremental encoder equivalent to `dataset_int_encode`.
+ *
+ * @param struct dataset *string_dataset
+ *   A pointer to the dataset containing string values to be encoded.
+ * @param char *tokens
+ *   A string containing the supported tokens, which must outlive the encoder.
+ * @param int tokens_size
+ *   The size of the tokens string.
+ *
+ * @return struct dataset_encoder*
+ *   A pointer to the newly created encoder, or NULL on failure.
+ */
+struct dataset_encoder *dataset_encoder_create_int(struct dataset *string_dataset, char *tokens, int tokens_size);
+
+/**
+ * Creates an incremental encoder equivalent to `dataset_string_encode`.
+ *
+ * @param struct dataset *int_dataset
+ *   A pointer to the dataset containing integer values to be converted to strings.
+ *
+ * @return struct dataset_encoder*
+ *   A pointer to the newly created encoder, or NULL on failure.
+ */
+struct dataset_encoder *dataset_encoder_create_string(struct dataset *int_dataset);
+
+/**
+ * Creates an incremental encoder equivalent to `dataset_one_hot_encode`.
+ *
+ * @param struct dataset *int_encoded_dataset
+ *   A pointer to the dataset containing integer encoded values to be one-hot encoded.
+ * @param int tokens_size
+ *   The size of the tokens string.
+ *
+ * @return struct dataset_encoder*
+ *   A pointer to the newly created encoder, or NULL on failure.
+ */
+struct dataset_encoder *dataset_encoder_create_one_hot(struct dataset *int_encoded_dataset, int tokens_size);
+
+/**
+ * Encodes the rows appended to the source dataset since the last call.
+ *
+ * The encoded rows are appended to the output dataset of the encoder. Since the
+ * output only grows, encoders can be chained, e.g. a one-hot encoder reading the
+ * output of an integer encoder.
+ *
+ * @param struct dataset_encoder *encoder
+ *   A pointer to the encoder.
+ *
+ * @return int
+ *   The number of rows encoded, or -1 if a row could not be encoded, in which case
+ *   the rows before it are kept and the next call resumes from the failed row.
+ */
+int dataset_encoder_sync(struct dataset_encoder *encoder);
+
+/**
+ * Destroys an encoder and its output dataset. The source dataset is not affected.
+ *
+ * @param struct dataset_encoder *encoder
+ *   A pointer to the encoder to be destroyed.
+ */
+void dataset_encoder_destroy(struct dataset_encoder *encoder);
+
 #endif // DATASET_ENCODE_H
+
+#ifndef DATASET_STATS_H
+#define DATASET_STATS_H
+
+#include <stddef.h>
+
+/**
+ * Represents the summary statistics of a numeric column of a dataset.
+ *
+ * The statistics are accumulated in a single pass using Welford's algorithm, and
+ * partial statistics computed over disjoint parts of a dataset (for example by
+ * different threads) can be combined with `dataset_column_stats_merge`.
+ */
+struct dataset_column_stats {
+  /**
+   * The number of values accumulated.
+   *
+   * @var size_t
+   */
+  size_t count;
+
+  /**
+   * The minimum accumulated value.
+   *
+   * @var double
+   */
+  double min;
+
+  /**
+   * The maximum accumulated value.
+   *
+   * @var double
+   */
+  double max;
+
+  /**
+   * The running mean of the accumulated values.
+   *
+   * @var double
+   */
+  double mean;
+
+  /**
+   * The running sum of squared differences from the mean.
+   *
+   * @var double
+   */
+  double m2;
+};
+
+/**
+ * Initializes an empty set of column statistics.
+ *
+ * @param struct dataset_column_stats *stats
+ *   A pointer to the statistics to initialize.
+ */
+void dataset_column_stats_init(struct dataset_column_stats *stats);
+
+/**
+ * Accumulates a single value into the column statistics.
+ *
+ * @param struct dataset_column_stats *stats
+ *   A pointer to the statistics to update.
+ * @param double value
+ *   The value to accumulate.
+ */
+void dataset_column_stats_update(struct dataset_column_stats *stats, double value);
+
+/**
+ * Accumulates a contiguous array of values into the column statistics.
+ *
+ * The values are processed in cache sized blocks using independent accumulators,
+ * which allows the compiler to vectorize the loops, and each block is merged into
+ * the running statistics.
+ *
+ * @param struct dataset_column_stats *stats
+ *   A pointer to the statistics to update.
+ * @param const double *values
+ *   The array of values to accumulate.
+ * @param size_t size
+ *   The number of values in the array.
+ */
+void dataset_column_stats_update_array(struct dataset_column_stats *stats, const double *values, size_t size);
+
+/**
+ * Merges the statistics of a disjoint set of values into the given statistics.
+ *
+ * @param struct dataset_column_stats *stats
+ *   A pointer to the statistics to update.
+ * @param const struct dataset_column_stats *other
+ *   A pointer to the statistics to merge.
+ */
+void dataset_column_stats_merge(struct dataset_column_stats *stats, const struct dataset_column_stats *other);
+
+/**
+ * Gets the population variance of the accumulated values.
+ *
+ * @param const struct dataset_column_stats *stats
+ *   A pointer to the statistics.
+ *
+ * @return double
+ *   The population variance, or 0 if no values were accumulated.
+ */
+double dataset_column_stats_variance(const struct dataset_column_stats *stats);
+
+/**
+ * Computes the statistics of a numeric column of the dataset in a single pass.
+ *
+ * Rows that have fewer entries than the requested column are skipped.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param enum data_row_side side
+ *   Whether the column belongs to the inputs or to the outputs of the rows.
+ * @param int column
+ *   The index of the column within the data entries of each row.
+ * @param enum data_entry_type type
+ *   The type of the column entries, either DATA_ENTRY_TYPE_INT or DATA_ENTRY_TYPE_DOUBLE.
+ * @param struct dataset_column_stats *stats
+ *   A pointer to the statistics to populate.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the parameters are invalid.
+ */
+int dataset_column_stats(struct dataset *data, enum data_row_side side, int column, enum data_entry_type type, struct dataset_column_stats *stats);
+
+/**
+ * Rescales a numeric column of the dataset in place to the range [0, 1].
+ *
+ * The entries of the column are converted to double entries, so after this call
+ * the column must be read as DATA_ENTRY_TYPE_DOUBLE.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param enum data_row_side side
+ *   Whether the column belongs to the inputs or to the outputs of the rows.
+ * @param int column
+ *   The index of the column within the data entries of each row.
+ * @param enum data_entry_type type
+ *   The type of the column entries, either DATA_ENTRY_TYPE_INT or DATA_ENTRY_TYPE_DOUBLE.
+ * @param const struct dataset_column_stats *stats
+ *   The statistics used for the rescaling, or NULL to compute them from the column.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure, in which case the column is unchanged.
+ */
+int dataset_normalize(struct dataset *data, enum data_row_side side, int column, enum data_entry_type type, const struct dataset_column_stats *stats);
+
+/**
+ * Standardizes a numeric column of the dataset in place to zero mean and unit variance.
+ *
+ * The entries of the column are converted to double entries, so after this call
+ * the column must be read as DATA_ENTRY_TYPE_DOUBLE.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param enum data_row_side side
+ *   Whether the column belongs to the inputs or to the outputs of the rows.
+ * @param int column
+ *   The index of the column within the data entries of each row.
+ * @param enum data_entry_type type
+ *   The type of the column entries, either DATA_ENTRY_TYPE_INT or DATA_ENTRY_TYPE_DOUBLE.
+ * @param const struct dataset_column_stats *stats
+ *   The statistics used for the standardization, or NULL to compute them from the column.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure, in which case the column is unchanged.
+ */
+int dataset_standardize(struct dataset *data, enum data_row_side side, int column, enum data_entry_type type, const struct dataset_column_stats *stats);
+
+/**
+ * Rescales a contiguous array of values in place to the range [0, 1].
+ *
+ * @param double *values
+ *   The array of values to rescale.
+ * @param size_t size
+ *   The number of values in the array.
+ * @param const struct dataset_column_stats *stats
+ *   The statistics used for the rescaling.
+ */
+void dataset_normalize_array(double *values, size_t size, const struct dataset_column_stats *stats);
+
+/**
+ * Standardizes a contiguous array of values in place to zero mean and unit variance.
+ *
+ * @param double *values
+ *   The array of values to standardize.
+ * @param size_t size
+ *   The number of values in the array.
+ * @param const struct dataset_column_stats *stats
+ *   The statistics used for the standardization.
+ */
+void dataset_standardize_array(double *values, size_t size, const struct dataset_column_stats *stats);
+
+#endif // DATASET_STATS_H
+
+#ifndef DATASET_BATCH_H
+#define DATASET_BATCH_H
+
+/**
+ * Describes how one side (inputs or outputs) of a data row is encoded into a batch.
+ *
+ * Each row contributes `entries * entry_width` values to the batch. Rows with fewer
+ * entries are padded with zeros and rows with more entries are truncated.
+ */
+struct dataset_batch_layout {
+  /**
+   * The type of the data entries, either DATA_ENTRY_TYPE_INT or DATA_ENTRY_TYPE_DOUBLE.
+   *
+   * @var enum data_entry_type
+   */
+  enum data_entry_type type;
+
+  /**
+   * The number of data entries taken from each row.
+   *
+   * @var int
+   */
+  int entries;
+
+  /**
+   * The number of values each entry is encoded into.
+   *
+   * A width of 1 copies the value of the entry. For integer entries, a width greater
+   * than 1 one-hot encodes the value of the entry into that many values.
+   *
+   * @var int
+   */
+  int entry_width;
+};
+
+/**
+ * Represents a batch of rows gathered into contiguous row-major matrices.
+ */
+struct dataset_batch {
+  /**
+   * The maximum number of rows the batch can hold.
+   *
+   * @var int
+   */
+  int capacity;
+
+  /**
+   * The number of rows currently stored in the batch.
+   *
+   * @var int
+   */
+  int size;
+
+  /**
+   * The sequence number of the batch within its epoch.
+   *
+   * @var int
+   */
+  int index;
+
+  /**
+   * The number of values stored per row in the inputs matrix.
+   *
+   * @var int
+   */
+  int input_width;
+
+  /**
+   * The number of values stored per row in the outputs matrix.
+   *
+   * @var int
+   */
+  int output_width;
+
+  /**
+   * The inputs matrix, with `capacity * input_width` values.
+   *
+   * @var double *
+   */
+  double *inputs;
+
+  /**
+   * The outputs matrix, with `capacity * output_width` values.
+   *
+   * @var double *
+   */
+  double *outputs;
+};
+
+/**
+ * Opaque handle of a background batch loader.
+ */
+struct dataset_loader;
+
+/**
+ * Gets the number of values a layout produces per row.
+ *
+ * @param const struct dataset_batch_layout *layout
+ *   A pointer to the layout.
+ *
+ * @return int
+ *   The number of values per row, or -1 if the layout is invalid.
+ */
+int dataset_batch_layout_width(const struct dataset_batch_layout *layout);
+
+/**
+ * Creates a new batch with preallocated matrices.
+ *
+ * @param int capacity
+ *   The maximum number of rows of the batch.
+ * @param int input_width
+ *   The number of values stored per row in the inputs matrix.
+ * @param int output_width
+ *   The number of values stored per row in the outputs matrix.
+ *
+ * @return struct dataset_batch*
+ *   A pointer to the newly created batch, or NULL on failure.
+ */
+struct dataset_batch *dataset_batch_create(int capacity, int input_width, int output_width);
+
+/**
+ * Destroys a batch, freeing all allocated memory.
+ *
+ * @param struct dataset_batch *batch
+ *   A pointer to the batch to be destroyed.
+ */
+void dataset_batch_destroy(struct dataset_batch *batch);
+
+/**
+ * Gathers and encodes a set of rows into a batch.
+ *
+ * @param struct dataset_batch *batch
+ *   A pointer to the batch to fill. Its widths must match the given layouts.
+ * @param struct data_row **rows
+ *   The rows to gather.
+ * @param int count
+ *   The number of rows to gather, no greater than the capacity of the batch.
+ * @param const struct dataset_batch_layout *input_layout
+ *   The layout used to encode the inputs of the rows.
+ * @param const struct dataset_batch_layout *output_layout
+ *   The layout used to encode the outputs of the rows.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the parameters are invalid.
+ */
+int dataset_batch_gather(struct dataset_batch *batch, struct data_row **rows, int count, const struct dataset_batch_layout *input_layout, const struct dataset_batch_layout *output_layout);
+
+/**
+ * Creates a loader that gathers the batches of a dataset on background threads.
+ *
+ * The loader owns a ring of `buffers` preallocated batches. Worker threads fill
+ * free batches in order while the consumer processes the ready ones, and block
+ * when every batch is waiting to be consumed. The dataset must not be modified
+ * while the loader exists.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset to load.
+ * @param int batch_size
+ *   The number of rows per batch. The last batch may be smaller.
+ * @param int buffers
+ *   The number of preallocated batches, at least 2 for double buffering.
+ * @param int threads
+ *   The number of worker threads, at least 1.
+ * @param const struct dataset_batch_layout *input_layout
+ *   The layout used to encode the inputs of the rows.
+ * @param const struct dataset_batch_layout *output_layout
+ *   The layout used to encode the outputs of the rows.
+ *
+ * @return struct dataset_loader*
+ *   A pointer to the newly created loader, or NULL on failure.
+ */
+struct dataset_loader *dataset_loader_create(struct dataset *data, int batch_size, int buffers, int threads, const struct dataset_batch_layout *input_layout, const struct dataset_batch_layout *output_layout);
+
+/**
+ * Waits for the next batch of the dataset.
+ *
+ * Batches are returned in dataset order and must be handed back with
+ * `dataset_loader_release_batch` once consumed, so their buffer can be refilled.
+ * If a batch fails to be gathered, the epoch ends there: this call and every
+ * later one return NULL.
+ *
+ * @param struct dataset_loader *loader
+ *   A pointer to the loader.
+ *
+ * @return struct dataset_batch*
+ *   A pointer to the next batch, or NULL once every batch was returned, a batch
+ *   failed or the loader is being destroyed.
+ */
+struct dataset_batch *dataset_loader_next_batch(struct dataset_loader *loader);
+
+/**
+ * Hands a consumed batch back to the loader.
+ *
+ * @param struct dataset_loader *loader
+ *   A pointer to the loader.
+ * @param struct dataset_batch *batch
+ *   A pointer to a batch returned by `dataset_loader_next_batch`.
+ */
+void dataset_loader_release_batch(struct dataset_loader *loader, struct dataset_batch *batch);
+
+/**
+ * Stops the worker threads of a loader and frees all allocated memory.
+ *
+ * @param struct dataset_loader *loader
+ *   A pointer to the loader to be destroyed.
+ */
+void dataset_loader_destroy(struct dataset_loader *loader);
+
+#endif // DATASET_BATCH_H
+
+#ifndef DATASET_HASH_H
+#define DATASET_HASH_H
+
+/**
+ * Represents a sparse vector as sorted index/value pairs.
+ *
+ * The structure and both arrays are stored in a single allocation, so a sparse
+ * vector held by a data entry is released by `data_entry_destroy`.
+ */
+struct dataset_sparse_vector {
+  /**
+   * The dimension of the dense vector represented.
+   *
+   * @var int
+   */
+  int dimension;
+
+  /**
+   * The number of non-zero values stored.
+   *
+   * @var int
+   */
+  int size;
+
+  /**
+   * The indices of the non-zero values, in increasing order.
+   *
+   * @var int *
+   */
+  int *indices;
+
+  /**
+   * The non-zero values.
+   *
+   * @var double *
+   */
+  double *values;
+};
+
+/**
+ * Creates a sparse vector with room for the given number of non-zero values.
+ *
+ * @param int dimension
+ *   The dimension of the dense vector represented.
+ * @param int size
+ *   The number of non-zero values.
+ *
+ * @return struct dataset_sparse_vector*
+ *   A pointer to the newly created sparse vector, to be released with `free`, or NULL on failure.
+ */
+struct dataset_sparse_vector *dataset_sparse_vector_create(int dimension, int size);
+
+/**
+ * Encodes a string dataset with the hashing trick.
+ *
+ * Each string entry is split into features, either the whole string or its byte
+ * n-grams, and each feature is hashed into one of `buckets` indices. Every entry
+ * is replaced by a single entry holding a `struct dataset_sparse_vector` with
+ * the accumulated counts, so memory is bounded by the number of buckets instead
+ * of the size of the vocabulary.
+ *
+ * @param struct dataset *string_dataset
+ *   A pointer to the dataset containing string values to be encoded.
+ * @param int buckets
+ *   The number of hash buckets, which is the dimension of the sparse vectors.
+ * @param int ngram
+ *   The length of the byte n-grams, or 0 to hash each string as a whole.
+ * @param int signed_hash
+ *   Whether a second hash bit picks the sign of each feature (+1 or -1), which
+ *   makes the collisions cancel out in expectation.
+ *
+ * @return struct dataset*
+ *   A new dataset containing sparse vector entries, or NULL if encoding fails.
+ */
+struct dataset *dataset_hash_encode(struct dataset *string_dataset, int buckets, int ngram, int signed_hash);
+
+#endif // DATASET_HASH_H
+
+#ifndef DATASET_TOKENIZER_H
+#define DATASET_TOKENIZER_H
+
+/**
+ * Represents a tokenizer compiled from a vocabulary of byte strings.
+ *
+ * The vocabulary is compiled into a trie stored as a flat transition table. Bytes
+ * that do not appear in the vocabulary share a single column of the table, so the
+ * table has one row per trie node and one column per distinct vocabulary byte.
+ */
+struct dataset_tokenizer {
+  /**
+   * The column of the transition table used by each byte value.
+   *
+   * @var int[256]
+   */
+  int byte_class[256];
+
+  /**
+   * The number of columns of the transition table.
+   *
+   * @var int
+   */
+  int classes;
+
+  /**
+   * The number of trie nodes, node 0 being the root.
+   *
+   * @var int
+   */
+  int states;
+
+  /**
+   * The transition table, `states * classes` node indices, -1 for no transition.
+   *
+   * @var int *
+   */
+  int *transitions;
+
+  /**
+   * The token id accepted by each node, -1 if no token ends at the node.
+   *
+   * @var int *
+   */
+  int *accepts;
+};
+
+/**
+ * Compiles a vocabulary of byte strings into a tokenizer.
+ *
+ * The id of each token is its index in the vocabulary. If a token appears more
+ * than once, the first index is used. Empty tokens are ignored.
+ *
+ * @param char **vocabulary
+ *   The array of null-terminated tokens, which can hold multi-byte UTF-8 sequences.
+ * @param int vocabulary_size
+ *   The number of tokens in the vocabulary.
+ *
+ * @return struct dataset_tokenizer*
+ *   A pointer to the newly created tokenizer, or NULL on failure.
+ */
+struct dataset_tokenizer *dataset_tokenizer_create(char **vocabulary, int vocabulary_size);
+
+/**
+ * Destroys a tokenizer, freeing all allocated memory.
+ *
+ * @param struct dataset_tokenizer *tokenizer
+ *   A pointer to the tokenizer to be destroyed.
+ */
+void dataset_tokenizer_destroy(struct dataset_tokenizer *tokenizer);
+
+/**
+ * Encodes a string into token ids with greedy longest-match.
+ *
+ * The string is read from left to right. At each position the trie is walked as
+ * far as the string allows and the longest vocabulary token found on the way is
+ * emitted, so bytes past that token may be read again from the next position and
+ * the cost is O(n * m) for a string of n bytes and tokens of at most m bytes.
+ * When no token matches, a single -1 is emitted for the whole UTF-8 character at
+ * that position, which is then skipped.
+ *
+ * @param const struct dataset_tokenizer *tokenizer
+ *   A pointer to the tokenizer.
+ * @param const char *string
+ *   The null-terminated string to encode.
+ * @param int *ids
+ *   The array that receives the token ids, with room for `strlen(string)` ids.
+ *
+ * @return int
+ *   The number of token ids written, or -1 if the parameters are invalid.
+ */
+int dataset_tokenizer_encode(const struct dataset_tokenizer *tokenizer, const char *string, int *ids);
+
+/**
+ * Encodes a string dataset into an integer dataset with a compiled tokenizer.
+ *
+ * This is the multi-byte counterpart of `dataset_int_encode`: the token ids of all
+ * the string entries of a row are stored as integer entries. With a vocabulary of
+ * single ASCII characters both functions produce the same dataset for ASCII
+ * strings. They differ on a character of several bytes missing from the
+ * vocabulary, which gives a single -1 here and one -1 per byte in
+ * `dataset_int_encode`.
+ *
+ * @param struct dataset *string_dataset
+ *   A pointer to the dataset containing string values to be encoded.
+ * @param const struct dataset_tokenizer *tokenizer
+ *   A pointer to the tokenizer.
+ *
+ * @return struct dataset*
+ *   A new dataset containing the token ids, or NULL if encoding fails.
+ */
+struct dataset *dataset_tokenizer_encode_dataset(struct dataset *string_dataset, const struct dataset_tokenizer *tokenizer);
+
+#endif // DATASET_TOKENIZER_H
+
+#ifndef DATASET_RANDOM_H
+#define DATASET_RANDOM_H
+
+#include <stdint.h>
+
+/**
+ * Represents a seeded pseudo-random number generator.
+ *
+ * The generator is SplitMix64: each output is a bijective mix of a counter that
+ * advances by a fixed odd constant, so the n-th output of a seed can also be
+ * computed directly with `dataset_random_at`.
+ */
+struct dataset_random {
+  /**
+   * The current counter of the generator.
+   *
+   * @var uint64_t
+   */
+  uint64_t state;
+};
+
+/**
+ * Seeds a pseudo-random number generator.
+ *
+ * @param struct dataset_random *random
+ *   A pointer to the generator.
+ * @param uint64_t seed
+ *   The seed of the sequence.
+ */
+void dataset_random_seed(struct dataset_random *random, uint64_t seed);
+
+/**
+ * Gets the next 64 random bits of a generator.
+ *
+ * @param struct dataset_random *random
+ *   A pointer to the generator.
+ *
+ * @return uint64_t
+ *   The next random value.
+ */
+uint64_t dataset_random_next(struct dataset_random *random);
+
+/**
+ * Gets the random value at a given position of the sequence of a seed.
+ *
+ * @param uint64_t seed
+ *   The seed of the sequence.
+ * @param uint64_t counter
+ *   The position in the sequence, starting at 0.
+ *
+ * @return uint64_t
+ *   The random value, equal to the `counter + 1`-th value of `dataset_random_next`.
+ */
+uint64_t dataset_random_at(uint64_t seed, uint64_t counter);
+
+/**
+ * Gets a uniformly distributed double in the interval (0, 1].
+ *
+ * @param struct dataset_random *random
+ *   A pointer to the generator.
+ *
+ * @return double
+ *   The random value.
+ */
+double dataset_random_uniform(struct dataset_random *random);
+
+/**
+ * Gets a uniformly distributed integer in the interval [0, bound).
+ *
+ * @param struct dataset_random *random
+ *   A pointer to the generator.
+ * @param uint64_t bound
+ *   The exclusive upper bound, greater than 0.
+ *
+ * @return uint64_t
+ *   The random value.
+ */
+uint64_t dataset_random_below(struct dataset_random *random, uint64_t bound);
+
+#endif // DATASET_RANDOM_H
+
+#ifndef DATASET_VIEW_H
+#define DATASET_VIEW_H
+
+/**
+ * Represents a read-only selection of rows of a dataset.
+ *
+ * A view borrows the rows of its source dataset instead of copying them, so it
+ * must not outlive the dataset and the selected rows must not be destroyed while
+ * the view is in use. A view can also select and reorder the columns of the rows,
+ * see `dataset_view_project`.
+ */
+struct dataset_view {
+  /**
+   * The dataset the rows belong to.
+   *
+   * @var struct dataset *
+   */
+  struct dataset *source;
+
+  /**
+   * The number of rows selected.
+   *
+   * @var int
+   */
+  int size;
+
+  /**
+   * The maximum number of rows the view can hold.
+   *
+   * @var int
+   */
+  int capacity;
+
+  /**
+   * The selected rows.
+   *
+   * @var struct data_row **
+   */
+  struct data_row **rows;
+
+  /**
+   * The input columns selected by a projection, or NULL to keep every input column.
+   *
+   * Column i of the view reads the column `input_columns[i]` of the rows.
+   *
+   * @var int *
+   */
+  int *input_columns;
+
+  /**
+   * The number of input columns selected by the projection.
+   *
+   * @var int
+   */
+  int input_columns_size;
+
+  /**
+   * The output columns selected by a projection, or NULL to keep every output column.
+   *
+   * @var int *
+   */
+  int *output_columns;
+
+  /**
+   * The number of output columns selected by the projection.
+   *
+   * @var int
+   */
+  int output_columns_size;
+};
+
+/**
+ * Creates an empty view of a dataset.
+ *
+ * @param struct dataset *source
+ *   A pointer to the dataset the rows belong to.
+ * @param int capacity
+ *   The maximum number of rows of the view.
+ *
+ * @return struct dataset_view*
+ *   A pointer to the newly created view, or NULL on failure.
+ */
+struct dataset_view *dataset_view_create(struct dataset *source, int capacity);
+
+/**
+ * Creates a view of every row of a dataset, in order.
+ *
+ * @param struct dataset *source
+ *   A pointer to the dataset.
+ *
+ * @return struct dataset_view*
+ *   A pointer to the newly created view, or NULL on failure.
+ */
+struct dataset_view *dataset_view_from_dataset(struct dataset *source);
+
+/**
+ * Destroys a view. The rows of the source dataset are not affected.
+ *
+ * @param struct dataset_view *view
+ *   A pointer to the view to be destroyed.
+ */
+void dataset_view_destroy(struct dataset_view *view);
+
+#endif // DATASET_VIEW_H
+
+#ifndef DATASET_SAMPLING_H
+#define DATASET_SAMPLING_H
+
+/**
+ * Represents a uniform sample of fixed size over a stream of rows.
+ *
+ * The reservoir uses Algorithm L: after the first `capacity` rows it draws how
+ * many rows to skip before the next replacement, so the cost of a skipped row is a
+ * single comparison and the memory is O(capacity).
+ */
+struct dataset_reservoir {
+  /**
+   * The sampled rows, in stream order once `dataset_reservoir_finish` is called.
+   *
+   * @var struct dataset_view *
+   */
+  struct dataset_view *sample;
+
+  /**
+   * The stream position of each sampled row.
+   *
+   * @var int64_t *
+   */
+  int64_t *positions;
+
+  /**
+   * The number of rows offered so far.
+   *
+   * @var int64_t
+   */
+  int64_t seen;
+
+  /**
+   * The stream position of the next row that enters the sample.
+   *
+   * @var int64_t
+   */
+  int64_t next;
+
+  /**
+   * The running weight W of Algorithm L.
+   *
+   * @var double
+   */
+  double weight;
+
+  /**
+   * The generator used to draw the skips and the replaced slots.
+   *
+   * @var struct dataset_random
+   */
+  struct dataset_random random;
+};
+
+/**
+ * Creates a reservoir that samples up to `capacity` rows.
+ *
+ * @param struct dataset *source
+ *   A pointer to the dataset the offered rows belong to.
+ * @param int capacity
+ *   The size of the sample, greater than 0.
+ * @param uint64_t seed
+ *   The seed of the sample.
+ *
+ * @return struct dataset_reservoir*
+ *   A pointer to the newly created reservoir, or NULL on failure.
+ */
+struct dataset_reservoir *dataset_reservoir_create(struct dataset *source, int capacity, uint64_t seed);
+
+/**
+ * Offers the next row of the stream to the reservoir.
+ *
+ * This can be called right after `dataset_append_row` to sample a dataset that
+ * is still being built.
+ *
+ * @param struct dataset_reservoir *reservoir
+ *   A pointer to the reservoir.
+ * @param struct data_row *row
+ *   A pointer to the row.
+ */
+void dataset_reservoir_offer(struct dataset_reservoir *reservoir, struct data_row *row);
+
+/**
+ * Sorts the sample of a reservoir back into stream order.
+ *
+ * @param struct dataset_reservoir *reservoir
+ *   A pointer to the reservoir.
+ */
+void dataset_reservoir_finish(struct dataset_reservoir *reservoir);
+
+/**
+ * Destroys a reservoir and its sample view.
+ *
+ * @param struct dataset_reservoir *reservoir
+ *   A pointer to the reservoir to be destroyed.
+ */
+void dataset_reservoir_destroy(struct dataset_reservoir *reservoir);
+
+/**
+ * Draws a uniform sample of k rows of a dataset in a single pass.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param int k
+ *   The number of rows to sample. The whole dataset is returned if it has fewer rows.
+ * @param uint64_t seed
+ *   The seed of the sample.
+ *
+ * @return struct dataset_view*
+ *   A view of the sampled rows in dataset order, or NULL on failure.
+ */
+struct dataset_view *dataset_sample_reservoir(struct dataset *data, int k, uint64_t seed);
+
+/**
+ * Draws a uniform sample of up to `per_class` rows of each class in a single pass.
+ *
+ * The class of a row is given by its output entries, read as integers. Rows with
+ * the same output values belong to the same class.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param int per_class
+ *   The number of rows to sample per class.
+ * @param uint64_t seed
+ *   The seed of the sample.
+ *
+ * @return struct dataset_view*
+ *   A view of the sampled rows in dataset order, or NULL on failure.
+ */
+struct dataset_view *dataset_sample_stratified(struct dataset *data, int per_class, uint64_t seed);
+
+/**
+ * Opaque handle of a weighted row sampler.
+ *
+ * With replacement, rows are drawn in O(1) each from a Walker/Vose alias table.
+ * Without replacement, each epoch is a weighted random permutation of the rows of
+ * positive weight, built in O(n log n) when the epoch starts, and every row of the
+ * epoch is returned exactly once.
+ */
+struct dataset_weighted_sampler;
+
+/**
+ * Creates a weighted sampler over the rows of a dataset.
+ *
+ * The dataset must not be modified while the sampler exists.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param const double *weights
+ *   The weight of each row in dataset order, finite and not negative, or NULL to
+ *   balance the classes: the class of a row is given by its output entries, read
+ *   as integers, and every class gets the same total weight.
+ * @param int replacement
+ *   Whether the rows are drawn with replacement, or without replacement per epoch.
+ * @param uint64_t seed
+ *   The seed of the draws.
+ *
+ * @return struct dataset_weighted_sampler*
+ *   A pointer to the newly created sampler, or NULL on failure, including when no
+ *   row has a positive weight.
+ */
+struct dataset_weighted_sampler *dataset_weighted_sampler_create(struct dataset *data, const double *weights, int replacement, uint64_t seed);
+
+/**
+ * Destroys a weighted sampler, freeing all allocated memory.
+ *
+ * @param struct dataset_weighted_sampler *sampler
+ *   A pointer to the sampler to be destroyed.
+ */
+void dataset_weighted_sampler_destroy(struct dataset_weighted_sampler *sampler);
+
+/**
+ * Draws rows from a weighted sampler.
+ *
+ * Without replacement, fewer rows are returned at the end of an epoch, and 0 once
+ * the epoch is over. The next call starts the next epoch.
+ *
+ * @param struct dataset_weighted_sampler *sampler
+ *   A pointer to the sampler.
+ * @param struct data_row **rows
+ *   Receives the drawn rows.
+ * @param int count
+ *   The number of rows to draw.
+ *
+ * @return int
+ *   The number of rows drawn, or -1 if the parameters are invalid.
+ */
+int dataset_weighted_sampler_draw(struct dataset_weighted_sampler *sampler, struct data_row **rows, int count);
+
+/**
+ * Draws up to `batch->capacity` rows from a weighted sampler and gathers them into a batch.
+ *
+ * The index of the batch counts the batches of the current epoch, or every batch
+ * when drawing with replacement.
+ *
+ * @param struct dataset_weighted_sampler *sampler
+ *   A pointer to the sampler.
+ * @param struct dataset_batch *batch
+ *   A pointer to the batch to fill. Its widths must match the given layouts.
+ * @param const struct dataset_batch_layout *input_layout
+ *   The layout used to encode the inputs of the rows.
+ * @param const struct dataset_batch_layout *output_layout
+ *   The layout used to encode the outputs of the rows.
+ *
+ * @return int
+ *   The number of rows of the batch, 0 once an epoch without replacement is over,
+ *   or -1 if the parameters are invalid.
+ */
+int dataset_weighted_sampler_next_batch(struct dataset_weighted_sampler *sampler, struct dataset_batch *batch, const struct dataset_batch_layout *input_layout, const struct dataset_batch_layout *output_layout);
+
+#endif // DATASET_SAMPLING_H
+
+#ifndef DATASET_SORT_H
+#define DATASET_SORT_H
+
+/**
+ * Identifies the order of a sort.
+ */
+enum dataset_sort_order {
+  /**
+   * Sort from the lowest to the highest key.
+   */
+  DATASET_SORT_ASCENDING,
+
+  /**
+   * Sort from the highest to the lowest key.
+   */
+  DATASET_SORT_DESCENDING,
+};
+
+/**
+ * Sorts the rows of a dataset by the value of one column.
+ *
+ * The sort is stable. Integer and double keys are sorted with an LSD radix sort
+ * in O(n), skipping the digits shared by every key, and string keys are sorted
+ * with a merge sort. The rows are relinked in place, no row is copied. Rows that
+ * have fewer entries than the requested column are placed last, in their
+ * original order.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset to sort.
+ * @param enum data_row_side side
+ *   Whether the column belongs to the inputs or to the outputs of the rows.
+ * @param int column
+ *   The index of the column within the data entries of each row.
+ * @param enum data_entry_type type
+ *   The type of the column entries: DATA_ENTRY_TYPE_INT, DATA_ENTRY_TYPE_DOUBLE or DATA_ENTRY_TYPE_STRING.
+ * @param enum dataset_sort_order order
+ *   The order of the sort.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure, in which case the dataset is not modified.
+ */
+int dataset_sort_by(struct dataset *data, enum data_row_side side, int column, enum data_entry_type type, enum dataset_sort_order order);
+
+/**
+ * Merges datasets already sorted by the same column into a single sorted dataset.
+ *
+ * The rows are moved, not copied: the merged dataset takes ownership of every row
+ * and the given datasets are left empty. The merge is stable, rows with equal keys
+ * keep the order of the datasets they come from. It uses a binary heap over the
+ * head row of each dataset, in O(n log k). Rows without the column are expected
+ * last, as `dataset_sort_by` places them, and stay last.
+ *
+ * @param struct dataset **datasets
+ *   The datasets to merge, each sorted with `dataset_sort_by` in the same order.
+ * @param int count
+ *   The number of datasets.
+ * @param enum data_row_side side
+ *   Whether the column belongs to the inputs or to the outputs of the rows.
+ * @param int column
+ *   The index of the column within the data entries of each row.
+ * @param enum data_entry_type type
+ *   The type of the column entries: DATA_ENTRY_TYPE_INT, DATA_ENTRY_TYPE_DOUBLE or DATA_ENTRY_TYPE_STRING.
+ * @param enum dataset_sort_order order
+ *   The order the datasets are sorted in.
+ *
+ * @return struct dataset*
+ *   A pointer to the merged dataset, or NULL on failure, in which case the given
+ *   datasets are not modified.
+ */
+struct dataset *dataset_merge_sorted(struct dataset **datasets, int count, enum data_row_side side, int column, enum data_entry_type type, enum dataset_sort_order order);
+
+#endif // DATASET_SORT_H
+
+#ifndef DATASET_CACHE_H
+#define DATASET_CACHE_H
+
+/**
+ * Opaque handle of a bounded cache of encoded data entries.
+ */
+struct dataset_encode_cache;
+
+/**
+ * Represents the usage statistics of an encode cache.
+ */
+struct dataset_encode_cache_stats {
+  /**
+   * The number of lookups answered from the cache.
+   *
+   * @var size_t
+   */
+  size_t hits;
+
+  /**
+   * The number of lookups that had to run the encoding function.
+   *
+   * @var size_t
+   */
+  size_t misses;
+
+  /**
+   * The number of results evicted to make room for new ones.
+   *
+   * @var size_t
+   */
+  size_t evictions;
+
+  /**
+   * The number of results currently cached.
+   *
+   * @var int
+   */
+  int size;
+};
+
+/**
+ * Creates a bounded cache of encoded data entries.
+ *
+ * The cache maps the content of a raw entry to the result of encoding it, and
+ * evicts results with the CLOCK algorithm once it is full. Cached results are
+ * immutable and lent to the caller by each lookup. The cached encoders bind the
+ * cache to their configuration (function and tokens) with
+ * `dataset_encode_cache_bind`, so results of another vocabulary are never reused.
+ *
+ * @param int capacity
+ *   The maximum number of cached results, greater than 0.
+ * @param enum data_entry_type key_type
+ *   The type of the raw entries: DATA_ENTRY_TYPE_INT, DATA_ENTRY_TYPE_DOUBLE or DATA_ENTRY_TYPE_STRING.
+ * @param enum data_entry_type value_type
+ *   The type of the encoded entries: DATA_ENTRY_TYPE_INT, DATA_ENTRY_TYPE_DOUBLE,
+ *   DATA_ENTRY_TYPE_STRING or DATA_ENTRY_TYPE_VECTOR.
+ *
+ * @return struct dataset_encode_cache*
+ *   A pointer to the newly created cache, or NULL on failure.
+ */
+struct dataset_encode_cache *dataset_encode_cache_create(int capacity, enum data_entry_type key_type, enum data_entry_type value_type);
+
+/**
+ * Destroys an encode cache, freeing all the cached results.
+ *
+ * @param struct dataset_encode_cache *cache
+ *   A pointer to the cache to be destroyed.
+ */
+void dataset_encode_cache_destroy(struct dataset_encode_cache *cache);
+
+/**
+ * Binds an encode cache to an encoding configuration.
+ *
+ * If the cache holds results of a different function or tokens, they are
+ * dropped and counted as evictions. The tokens are copied.
+ *
+ * @param struct dataset_encode_cache *cache
+ *   A pointer to the cache.
+ * @param char *tokens
+ *   A pointer to the array of tokens used for encoding, or NULL.
+ * @param int tokens_size
+ *   The size of the tokens array.
+ * @param struct data_entries *(*encode_entry)(struct data_entry *, char *, int)
+ *   The encoding function.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+int dataset_encode_cache_bind(struct dataset_encode_cache *cache, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int));
+
+/**
+ * Gets the type of the encoded entries of a cache.
+ *
+ * @param struct dataset_encode_cache *cache
+ *   A pointer to the cache, not NULL.
+ *
+ * @return enum data_entry_type
+ *   The type of the encoded entries.
+ */
+enum data_entry_type dataset_encode_cache_get_value_type(struct dataset_encode_cache *cache);
+
+/**
+ * Looks up the encoded result of a raw entry.
+ *
+ * @param struct dataset_encode_cache *cache
+ *   A pointer to the cache.
+ * @param struct data_entry *entry
+ *   The raw entry.
+ *
+ * @return const struct data_entries*
+ *   The cached result, owned by the cache and valid until the next call to
+ *   `dataset_encode_cache_put`, `dataset_encode_cache_bind` or
+ *   `dataset_encode_cache_destroy`, or NULL on a miss.
+ */
+const struct data_entries *dataset_encode_cache_get(struct dataset_encode_cache *cache, struct data_entry *entry);
+
+/**
+ * Stores a copy of the encoded result of a raw entry.
+ *
+ * @param struct dataset_encode_cache *cache
+ *   A pointer to the cache.
+ * @param struct data_entry *entry
+ *   The raw entry.
+ * @param struct data_entries *encoded
+ *   The encoded result, which remains owned by the caller.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the result could not be cached.
+ */
+int dataset_encode_cache_put(struct dataset_encode_cache *cache, struct data_entry *entry, struct data_entries *encoded);
+
+/**
+ * Gets the usage statistics of an encode cache.
+ *
+ * @param struct dataset_encode_cache *cache
+ *   A pointer to the cache.
+ * @param struct dataset_encode_cache_stats *stats
+ *   A pointer to the statistics to populate.
+ */
+void dataset_encode_cache_get_stats(struct dataset_encode_cache *cache, struct dataset_encode_cache_stats *stats);
+
+/**
+ * Encodes a dataset like `dataset_encode`, memoizing the result of each raw entry.
+ *
+ * The cache is bound to the function and tokens first. Every encoded row keeps
+ * its entries in a single storage block copied from the cached results.
+ *
+ * @param struct dataset *raw_dataset
+ *   A pointer to the raw dataset to be encoded.
+ * @param char *tokens
+ *   A pointer to the array of tokens used for encoding.
+ * @param int tokens_size
+ *   The size of the tokens array.
+ * @param struct data_entries *(*encode_entry)(struct data_entry *, char *, int)
+ *   A function pointer to the encoding function that transforms individual data entries.
+ * @param struct dataset_encode_cache *cache
+ *   A pointer to the cache, or NULL to encode every entry.
+ *
+ * @return struct dataset*
+ *   A pointer to the newly created dataset containing the encoded data, or NULL on failure.
+ */
+struct dataset *dataset_encode_cached(struct dataset *raw_dataset, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int), struct dataset_encode_cache *cache);
+
+/**
+ * Encodes a string dataset like `dataset_int_encode`, memoizing the result of each string.
+ *
+ * @param struct dataset *string_dataset
+ *   A pointer to the dataset containing string values to be encoded.
+ * @param char *tokens
+ *   A string containing the supported tokens for encoding.
+ * @param int tokens_size
+ *   The size of the tokens string.
+ * @param struct dataset_encode_cache *cache
+ *   A cache created with DATA_ENTRY_TYPE_STRING keys and DATA_ENTRY_TYPE_INT values.
+ *
+ * @return struct dataset*
+ *   A new dataset containing integer representations of the strings, or NULL if encoding fails.
+ */
+struct dataset *dataset_int_encode_cached(struct dataset *string_dataset, char *tokens, int tokens_size, struct dataset_encode_cache *cache);
+
+/**
+ * Converts an integer dataset like `dataset_string_encode`, memoizing the result of each integer.
+ *
+ * @param struct dataset *int_dataset
+ *   A pointer to the dataset containing integer values to be converted to strings.
+ * @param struct dataset_encode_cache *cache
+ *   A cache created with DATA_ENTRY_TYPE_INT keys and DATA_ENTRY_TYPE_STRING values.
+ *
+ * @return struct dataset*
+ *   A new dataset containing string representations of the integer values, or NULL on failure.
+ */
+struct dataset *dataset_string_encode_cached(struct dataset *int_dataset, struct dataset_encode_cache *cache);
+
+/**
+ * One-hot encodes an integer dataset like `dataset_one_hot_encode`, memoizing the vector of each integer.
+ *
+ * @param struct dataset *int_encoded_dataset
+ *   A pointer to the dataset containing integer encoded values to be one-hot encoded.
+ * @param int tokens_size
+ *   The size of the tokens string.
+ * @param struct dataset_encode_cache *cache
+ *   A cache created with DATA_ENTRY_TYPE_INT keys and DATA_ENTRY_TYPE_VECTOR values.
+ *
+ * @return struct dataset*
+ *   A new dataset containing one-hot encoded representations of the integers, or NULL if encoding fails.
+ */
+struct dataset *dataset_one_hot_encode_cached(struct dataset *int_encoded_dataset, int tokens_size, struct dataset_encode_cache *cache);
+
+#endif // DATASET_CACHE_H
+
+#ifndef DATASET_CONCURRENT_H
+#define DATASET_CONCURRENT_H
+
+/**
+ * Represents a chain of rows built by a single producer thread.
+ *
+ * Rows are linked locally without any synchronization and the whole chain is
+ * spliced onto a dataset with a single atomic operation.
+ */
+struct dataset_append_buffer {
+  /**
+   * The first row of the chain.
+   *
+   * @var struct data_row *
+   */
+  struct data_row *first;
+
+  /**
+   * The last row of the chain.
+   *
+   * @var struct data_row *
+   */
+  struct data_row *last;
+
+  /**
+   * The number of rows of the chain.
+   *
+   * @var int64_t
+   */
+  int64_t size;
+};
+
+/**
+ * Appends a row to a dataset from any number of producer threads without locks.
+ *
+ * The tail of the dataset is swapped with an atomic exchange and the previous tail
+ * is linked to the row afterwards, so concurrent producers never wait on each
+ * other. While producers are running, the chain may be momentarily incomplete.
+ * Once every producer has been joined, `size`, `last` and the traversal in both
+ * directions are consistent. The order of rows appended by different threads is
+ * the order in which their exchanges happened.
+ *
+ * This function must not be mixed with `dataset_append_row` or with readers while
+ * producers are running.
+ *
+ * When the dataset has a journal, the row is logged before it is linked, the
+ * journal taking a lock. The journal holds the rows of different threads in the
+ * order they were logged, which may differ from their order in the dataset.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset to which the row will be appended.
+ * @param struct data_row *row
+ *   A pointer to the row to be appended to the dataset.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if data or row is NULL or the row could not be logged.
+ */
+int dataset_append_row_concurrent(struct dataset *data, struct data_row *row);
+
+/**
+ * Initializes an empty append buffer.
+ *
+ * @param struct dataset_append_buffer *buffer
+ *   A pointer to the buffer to initialize.
+ */
+void dataset_append_buffer_init(struct dataset_append_buffer *buffer);
+
+/**
+ * Appends a row to a thread-local append buffer.
+ *
+ * @param struct dataset_append_buffer *buffer
+ *   A pointer to the buffer.
+ * @param struct data_row *row
+ *   A pointer to the row to be appended.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if buffer or row is NULL.
+ */
+int dataset_append_buffer_push(struct dataset_append_buffer *buffer, struct data_row *row);
+
+/**
+ * Splices the rows of an append buffer onto a dataset without locks and empties the buffer.
+ *
+ * The rows of the buffer stay contiguous in the dataset. The same rules as for
+ * `dataset_append_row_concurrent` apply, and the rows of the buffer are logged
+ * with `dataset_journal_write_rows` before the chain is linked. If logging fails,
+ * the buffer is kept and nothing is linked.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param struct dataset_append_buffer *buffer
+ *   A pointer to the buffer.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if data or buffer is NULL or the rows could not be logged.
+ */
+int dataset_append_buffer_flush(struct dataset *data, struct dataset_append_buffer *buffer);
+
+#endif // DATASET_CONCURRENT_H
+
+#ifndef DATASET_IO_H
+#define DATASET_IO_H
+
+#include <stddef.h>
+
+/**
+ * Serializes a data row into a buffer.
+ *
+ * The row is stored as the number of inputs and outputs (32-bit) followed by the
+ * payload of each entry: 32-bit integers, 64-bit doubles, or strings prefixed by
+ * their 32-bit length. Values are stored in the byte order of the host.
+ *
+ * @param struct data_row *row
+ *   A pointer to the row to serialize.
+ * @param enum data_entry_type type
+ *   The type of the entries: DATA_ENTRY_TYPE_INT, DATA_ENTRY_TYPE_DOUBLE or DATA_ENTRY_TYPE_STRING.
+ * @param unsigned char *buffer
+ *   The buffer that receives the row, may be NULL to only compute the size.
+ * @param size_t capacity
+ *   The number of bytes available in the buffer.
+ *
+ * @return size_t
+ *   The number of bytes of the serialized row, which were only written if they fit
+ *   in the buffer, or 0 if the row cannot be serialized.
+ */
+size_t dataset_row_serialize(struct data_row *row, enum data_entry_type type, unsigned char *buffer, size_t capacity);
+
+/**
+ * Rebuilds a data row from its serialized form.
+ *
+ * @param const unsigned char *buffer
+ *   The serialized row.
+ * @param size_t size
+ *   The number of bytes of the serialized row.
+ * @param enum data_entry_type type
+ *   The type of the entries, as given to `dataset_row_serialize`.
+ *
+ * @return struct data_row*
+ *   A pointer to the newly created row, or NULL if the buffer is malformed.
+ */
+struct data_row *dataset_row_deserialize(const unsigned char *buffer, size_t size, enum data_entry_type type);
+
+/**
+ * Writes a dataset to a binary file.
+ *
+ * The file holds a header (magic, version, entry type and number of rows) followed
+ * by every row serialized with `dataset_row_serialize` and prefixed by its 32-bit size.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset to write.
+ * @param const char *path
+ *   The path of the file.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+int dataset_save(struct dataset *data, const char *path, enum data_entry_type type);
+
+/**
+ * Reads a dataset from a binary file written by `dataset_save` or `dataset_save_shards`.
+ *
+ * @param const char *path
+ *   The path of the file.
+ *
+ * @return struct dataset*
+ *   A pointer to the newly created dataset, or NULL on failure.
+ */
+struct dataset *dataset_load(const char *path);
+
+#endif // DATASET_IO_H
+
+#ifndef DATASET_SHARD_H
+#define DATASET_SHARD_H
+
+/**
+ * Identifies how the rows of a dataset are distributed among shards.
+ */
+enum dataset_shard_mode {
+  /**
+   * Each shard holds a contiguous range of rows.
+   */
+  DATASET_SHARD_CONTIGUOUS,
+
+  /**
+   * Row i belongs to shard `i % n_shards`.
+   */
+  DATASET_SHARD_ROUND_ROBIN,
+};
+
+/**
+ * Gets the index of the shard a row belongs to.
+ *
+ * @param int64_t position
+ *   The position of the row in the dataset.
+ * @param int64_t size
+ *   The number of rows of the dataset.
+ * @param int n_shards
+ *   The number of shards.
+ * @param enum dataset_shard_mode mode
+ *   How the rows are distributed among shards.
+ *
+ * @return int
+ *   The index of the shard.
+ */
+int dataset_shard_of(int64_t position, int64_t size, int n_shards, enum dataset_shard_mode mode);
+
+/**
+ * Selects the rows of one shard of a dataset.
+ *
+ * Shards are disjoint, together they cover the whole dataset, and their sizes
+ * differ by at most one row.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param int shard_index
+ *   The index of the shard, from 0 to `n_shards - 1`.
+ * @param int n_shards
+ *   The number of shards, greater than 0.
+ * @param enum dataset_shard_mode mode
+ *   How the rows are distributed among shards.
+ *
+ * @return struct dataset_view*
+ *   A view of the rows of the shard in dataset order, or NULL on failure.
+ */
+struct dataset_view *dataset_shard(struct dataset *data, int shard_index, int n_shards, enum dataset_shard_mode mode);
+
+/**
+ * Writes every shard of a dataset to its own binary file in a single pass.
+ *
+ * Shard i is written to `<path>.<i>` in the format of `dataset_save`, so each
+ * worker can load its shard with `dataset_load` without reading the others.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param const char *path
+ *   The base path of the shard files.
+ * @param int n_shards
+ *   The number of shards, greater than 0.
+ * @param enum dataset_shard_mode mode
+ *   How the rows are distributed among shards.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+int dataset_save_shards(struct dataset *data, const char *path, int n_shards, enum dataset_shard_mode mode, enum data_entry_type type);
+
+#endif // DATASET_SHARD_H
+
+#ifndef DATASET_STORAGE_H
+#define DATASET_STORAGE_H
+
+#include <stddef.h>
+
+/**
+ * Represents a block of memory shared by many rows, their entries and values.
+ *
+ * The storage counts the rows that reference it and is freed when the last of
+ * them is destroyed. Integer values held by a storage always have room for a
+ * double, so they can be converted in place.
+ */
+struct dataset_storage {
+  /**
+   * The number of rows referencing the storage.
+   *
+   * @var size_t
+   */
+  size_t references;
+
+  /**
+   * The size of the memory block in bytes.
+   *
+   * @var size_t
+   */
+  size_t size;
+
+  /**
+   * The memory block.
+   *
+   * @var unsigned char *
+   */
+  unsigned char *memory;
+};
+
+/**
+ * The alignment of the memory block of a storage, suitable for aligned SIMD loads.
+ */
+#define DATASET_STORAGE_ALIGNMENT 64
+
+/**
+ * Creates a new storage with a memory block of the given size.
+ *
+ * The memory block is aligned to `DATASET_STORAGE_ALIGNMENT` bytes.
+ *
+ * @param size_t size
+ *   The size of the memory block in bytes.
+ *
+ * @return struct dataset_storage*
+ *   A pointer to the newly created storage, without references, or NULL on failure.
+ */
+struct dataset_storage *dataset_storage_create(size_t size);
+
+/**
+ * Creates a new storage whose memory block is backed by transparent huge pages when possible.
+ *
+ * The memory block is aligned to 2 MiB and the kernel is advised with
+ * `madvise(MADV_HUGEPAGE)`, which reduces the TLB misses of large datasets. The
+ * advice is ignored on systems that do not support it.
+ *
+ * @param size_t size
+ *   The size of the memory block in bytes.
+ *
+ * @return struct dataset_storage*
+ *   A pointer to the newly created storage, without references, or NULL on failure.
+ */
+struct dataset_storage *dataset_storage_create_huge(size_t size);
+
+/**
+ * Adds references to a storage, one for each row that will point to it.
+ *
+ * @param struct dataset_storage *storage
+ *   A pointer to the storage.
+ * @param size_t references
+ *   The number of references to add.
+ */
+void dataset_storage_retain(struct dataset_storage *storage, size_t references);
+
+/**
+ * Releases a reference to a storage, freeing it when no reference is left.
+ *
+ * @param struct dataset_storage *storage
+ *   A pointer to the storage.
+ */
+void dataset_storage_release(struct dataset_storage *storage);
+
+/**
+ * Frees a storage regardless of its references.
+ *
+ * This is meant for storages that were never handed out to rows.
+ *
+ * @param struct dataset_storage *storage
+ *   A pointer to the storage.
+ */
+void dataset_storage_destroy(struct dataset_storage *storage);
+
+#endif // DATASET_STORAGE_H
+
+#ifndef DATASET_GENERATE_H
+#define DATASET_GENERATE_H
+
+#include <stdint.h>
+
+/**
+ * Identifies the arithmetic operation computed by the generated rows.
+ */
+enum dataset_generate_task {
+  /**
+   * The output is the sum of the operands.
+   */
+  DATASET_GENERATE_ADDITION,
+
+  /**
+   * The output is the first operand minus the others.
+   */
+  DATASET_GENERATE_SUBTRACTION,
+
+  /**
+   * The output is the product of the operands.
+   */
+  DATASET_GENERATE_MULTIPLICATION,
+
+  /**
+   * The output is the first operand divided by the others, truncated toward zero.
+   */
+  DATASET_GENERATE_DIVISION,
+
+  /**
+   * The output is the remainder of the first operand divided by the others in turn.
+   */
+  DATASET_GENERATE_MODULO,
+};
+
+/**
+ * Identifies how the result is stored in the outputs of the generated rows.
+ */
+enum dataset_generate_shape {
+  /**
+   * A single integer entry holding the result.
+   */
+  DATASET_GENERATE_SCALAR,
+
+  /**
+   * An entry holding 1 if the result is negative and 0 otherwise, followed by the
+   * decimal digits of its absolute value, most significant first, padded with
+   * zeros to the number of digits of the largest possible result.
+   */
+  DATASET_GENERATE_DIGITS,
+};
+
+/**
+ * Describes the rows produced by `dataset_generate`.
+ */
+struct dataset_generate_options {
+  /**
+   * The arithmetic operation.
+   *
+   * @var enum dataset_generate_task
+   */
+  enum dataset_generate_task task;
+
+  /**
+   * How the result is stored in the outputs.
+   *
+   * @var enum dataset_generate_shape
+   */
+  enum dataset_generate_shape shape;
+
+  /**
+   * The number of operands, stored as the integer inputs of each row, at least 2.
+   *
+   * @var int
+   */
+  int operands;
+
+  /**
+   * The minimum value of the operands, greater than INT_MIN.
+   *
+   * @var int
+   */
+  int min;
+
+  /**
+   * The maximum value of the operands.
+   *
+   * @var int
+   */
+  int max;
+};
+
+/**
+ * Generates a dataset of random arithmetic operations.
+ *
+ * Operand j of row i is drawn from `dataset_random_at(seed, i * operands + j)`, so
+ * the rows only depend on the seed and the options, never on the number of threads.
+ * Divisors are never 0. The rows, their entries and values are held by a single
+ * `dataset_storage` and filled in parallel.
+ *
+ * @param const struct dataset_generate_options *options
+ *   The operation and the shape of the rows.
+ * @param int count
+ *   The number of rows to generate.
+ * @param uint64_t seed
+ *   The seed of the random values.
+ * @param int threads
+ *   The number of threads filling the rows, 1 or less to fill them on the calling thread.
+ *
+ * @return struct dataset*
+ *   A pointer to the generated dataset, or NULL if the options are invalid, a
+ *   result could overflow an int, or memory allocation fails.
+ */
+struct dataset *dataset_generate(const struct dataset_generate_options *options, int count, uint64_t seed, int threads);
+
+#endif // DATASET_GENERATE_H
+
+#ifndef DATASET_PROJECT_H
+#define DATASET_PROJECT_H
+
+/**
+ * Selects and reorders the columns of a view without copying any entry.
+ *
+ * Column i of the projected view reads column `input_columns[i]` of the view before
+ * the projection, so successive projections compose. Columns may be repeated.
+ *
+ * @param struct dataset_view *view
+ *   A pointer to the view to project.
+ * @param const int *input_columns
+ *   The input columns to keep, or NULL to keep the input columns unchanged.
+ * @param int input_columns_size
+ *   The number of input columns to keep.
+ * @param const int *output_columns
+ *   The output columns to keep, or NULL to keep the output columns unchanged.
+ * @param int output_columns_size
+ *   The number of output columns to keep.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if a column is negative, out of range of a previous
+ *   projection, or memory allocation fails, in which case the view is not modified.
+ */
+int dataset_view_project(struct dataset_view *view, const int *input_columns, int input_columns_size, const int *output_columns, int output_columns_size);
+
+/**
+ * Creates a view of every row of a dataset restricted to some of its columns.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param const int *input_columns
+ *   The input columns to keep, or NULL to keep every input column.
+ * @param int input_columns_size
+ *   The number of input columns to keep.
+ * @param const int *output_columns
+ *   The output columns to keep, or NULL to keep every output column.
+ * @param int output_columns_size
+ *   The number of output columns to keep.
+ *
+ * @return struct dataset_view*
+ *   A pointer to the newly created view, or NULL on failure.
+ */
+struct dataset_view *dataset_project(struct dataset *data, const int *input_columns, int input_columns_size, const int *output_columns, int output_columns_size);
+
+/**
+ * Gets the number of columns of a row of a view.
+ *
+ * @param const struct dataset_view *view
+ *   A pointer to the view.
+ * @param int index
+ *   The index of the row in the view.
+ * @param enum data_row_side side
+ *   Whether to count the inputs or the outputs.
+ *
+ * @return int
+ *   The number of columns, or -1 if the index is out of range.
+ */
+int dataset_view_get_width(const struct dataset_view *view, int index, enum data_row_side side);
+
+/**
+ * Gets an entry of a row of a view, through the projection of the view.
+ *
+ * @param const struct dataset_view *view
+ *   A pointer to the view.
+ * @param int index
+ *   The index of the row in the view.
+ * @param enum data_row_side side
+ *   Whether the column belongs to the inputs or to the outputs.
+ * @param int column
+ *   The index of the column in the view.
+ *
+ * @return struct data_entry*
+ *   The entry, or NULL if the row has no such column.
+ */
+struct data_entry *dataset_view_get_entry(const struct dataset_view *view, int index, enum data_row_side side, int column);
+
+/**
+ * Encodes the rows of a view like `dataset_encode_cached`, reading the columns through its projection.
+ *
+ * @param const struct dataset_view *view
+ *   A pointer to the view to be encoded.
+ * @param char *tokens
+ *   A pointer to the array of tokens used for encoding.
+ * @param int tokens_size
+ *   The size of the tokens array.
+ * @param struct data_entries *(*encode_entry)(struct data_entry *, char *, int)
+ *   A function pointer to the encoding function that transforms individual data entries.
+ * @param struct dataset_encode_cache *cache
+ *   A pointer to the cache, or NULL to encode every entry.
+ *
+ * @return struct dataset*
+ *   A pointer to the newly created dataset containing the encoded data, or NULL on failure.
+ */
+struct dataset *dataset_encode_view(const struct dataset_view *view, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int), struct dataset_encode_cache *cache);
+
+/**
+ * Encodes the strings of a view like `dataset_int_encode`.
+ *
+ * @param const struct dataset_view *view
+ *   A pointer to the view of string values.
+ * @param char *tokens
+ *   A string containing the supported tokens for encoding.
+ * @param int tokens_size
+ *   The size of the tokens string.
+ *
+ * @return struct dataset*
+ *   A new dataset containing integer representations of the strings, or NULL if encoding fails.
+ */
+struct dataset *dataset_int_encode_view(const struct dataset_view *view, char *tokens, int tokens_size);
+
+/**
+ * Converts the integers of a view like `dataset_string_encode`.
+ *
+ * @param const struct dataset_view *view
+ *   A pointer to the view of integer values.
+ *
+ * @return struct dataset*
+ *   A new dataset containing string representations of the integer values, or NULL on failure.
+ */
+struct dataset *dataset_string_encode_view(const struct dataset_view *view);
+
+/**
+ * One-hot encodes the integers of a view like `dataset_one_hot_encode`.
+ *
+ * @param const struct dataset_view *view
+ *   A pointer to the view of integer encoded values.
+ * @param int tokens_size
+ *   The size of the tokens string.
+ *
+ * @return struct dataset*
+ *   A new dataset containing one-hot encoded representations of the integers, or NULL if encoding fails.
+ */
+struct dataset *dataset_one_hot_encode_view(const struct dataset_view *view, int tokens_size);
+
+/**
+ * Gathers and encodes a range of rows of a view into a batch, through its projection.
+ *
+ * @param struct dataset_batch *batch
+ *   A pointer to the batch to fill. Its widths must match the given layouts.
+ * @param const struct dataset_view *view
+ *   A pointer to the view.
+ * @param int first
+ *   The index of the first row to gather.
+ * @param int count
+ *   The number of rows to gather, no greater than the capacity of the batch.
+ * @param const struct dataset_batch_layout *input_layout
+ *   The layout used to encode the inputs of the rows.
+ * @param const struct dataset_batch_layout *output_layout
+ *   The layout used to encode the outputs of the rows.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the parameters are invalid.
+ */
+int dataset_batch_gather_view(struct dataset_batch *batch, const struct dataset_view *view, int first, int count, const struct dataset_batch_layout *input_layout, const struct dataset_batch_layout *output_layout);
+
+/**
+ * Creates a loader like `dataset_loader_create` that reads the rows of a view, through its projection.
+ *
+ * The view must not be modified or destroyed while the loader exists.
+ *
+ * @param const struct dataset_view *view
+ *   A pointer to the view to load.
+ * @param int batch_size
+ *   The number of rows per batch. The last batch may be smaller.
+ * @param int buffers
+ *   The number of preallocated batches, at least 2 for double buffering.
+ * @param int threads
+ *   The number of worker threads, at least 1.
+ * @param const struct dataset_batch_layout *input_layout
+ *   The layout used to encode the inputs of the rows.
+ * @param const struct dataset_batch_layout *output_layout
+ *   The layout used to encode the outputs of the rows.
+ *
+ * @return struct dataset_loader*
+ *   A pointer to the newly created loader, or NULL on failure.
+ */
+struct dataset_loader *dataset_loader_create_view(const struct dataset_view *view, int batch_size, int buffers, int threads, const struct dataset_batch_layout *input_layout, const struct dataset_batch_layout *output_layout);
+
+#endif // DATASET_PROJECT_H
+
+#ifndef DATASET_TRANSFORM_H
+#define DATASET_TRANSFORM_H
+
+/**
+ * Splits a range of indices into contiguous ranges processed on several threads.
+ *
+ * The calling thread processes the first range, and any range whose thread fails
+ * to start. The function returns once every range is processed.
+ *
+ * @param int count
+ *   The number of indices.
+ * @param int threads
+ *   The number of threads, 1 or less to run on the calling thread.
+ * @param void (*worker)(void *, int, int)
+ *   The function processing the indices from its second argument to its third,
+ *   excluded. It must be thread-safe.
+ * @param void *context
+ *   The context passed to the worker.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure, in which case the worker is not called.
+ */
+int dataset_parallel_for(int count, int threads, void (*worker)(void *, int, int), void *context);
+
+/**
+ * Selects the rows of a dataset that match a predicate.
+ *
+ * The predicate is evaluated in parallel over ranges of rows, so it must be safe
+ * to call from several threads at once. The rows are borrowed, as for any view.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param int (*predicate)(struct data_row *, void *)
+ *   The predicate, returning non-zero to keep the row.
+ * @param void *context
+ *   The context passed to the predicate.
+ * @param int threads
+ *   The number of threads, 1 or less to run on the calling thread.
+ *
+ * @return struct dataset_view*
+ *   A view of the matching rows in dataset order, or NULL on failure.
+ */
+struct dataset_view *dataset_filter(struct dataset *data, int (*predicate)(struct data_row *, void *), void *context, int threads);
+
+/**
+ * Removes the rows of a dataset that do not match a predicate.
+ *
+ * The rejected rows are unlinked and destroyed, the kept rows stay in order.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param int (*predicate)(struct data_row *, void *)
+ *   The predicate, returning non-zero to keep the row. It must be thread-safe.
+ * @param void *context
+ *   The context passed to the predicate.
+ * @param int threads
+ *   The number of threads, 1 or less to run on the calling thread.
+ *
+ * @return int
+ *   The number of rows removed, or -1 on failure, in which case the dataset is not modified.
+ */
+int dataset_filter_in_place(struct dataset *data, int (*predicate)(struct data_row *, void *), void *context, int threads);
+
+/**
+ * Builds a new dataset from the result of a function applied to every row.
+ *
+ * The function is applied in parallel over ranges of rows, and the new rows are
+ * appended in the order of the rows they were built from.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param struct data_row *(*function)(struct data_row *, void *)
+ *   The function, returning a new row, or NULL on failure. It must be thread-safe.
+ *   Returning the row it was given is a failure, as that row stays in the dataset.
+ * @param void *context
+ *   The context passed to the function.
+ * @param int threads
+ *   The number of threads, 1 or less to run on the calling thread.
+ *
+ * @return struct dataset*
+ *   A pointer to the new dataset, or NULL if the function failed for any row.
+ */
+struct dataset *dataset_map(struct dataset *data, struct data_row *(*function)(struct data_row *, void *), void *context, int threads);
+
+/**
+ * Applies a function that modifies the rows of a dataset in place.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param int (*function)(struct data_row *, void *)
+ *   The function, returning 0 on success or -1 on failure. It must be thread-safe
+ *   and must not link or unlink rows.
+ * @param void *context
+ *   The context passed to the function.
+ * @param int threads
+ *   The number of threads, 1 or less to run on the calling thread.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the function failed for any row. The other
+ *   rows are modified regardless.
+ */
+int dataset_map_in_place(struct dataset *data, int (*function)(struct data_row *, void *), void *context, int threads);
+
+#endif // DATASET_TRANSFORM_H
+
+#ifndef DATASET_NPY_H
+#define DATASET_NPY_H
+
+/**
+ * Writes the inputs or the outputs of a dataset as a 2-D NumPy `.npy` array.
+ *
+ * Row i of the array holds the entries of row i of the dataset, with vector
+ * entries expanded into their elements. Integer entries are stored as 32-bit
+ * integers, double and vector entries as 64-bit floats, in the byte order of the
+ * host. Every row must have the same width. The rows are streamed to the file
+ * through a large aligned buffer, and long vectors are written straight from their
+ * elements with `writev`, so no copy of the whole array is built.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param const char *path
+ *   The path of the file.
+ * @param enum data_row_side side
+ *   Whether to write the inputs or the outputs of the rows.
+ * @param enum data_entry_type type
+ *   The type of the entries: DATA_ENTRY_TYPE_INT, DATA_ENTRY_TYPE_DOUBLE or DATA_ENTRY_TYPE_VECTOR.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure, in which case the file is removed.
+ */
+int dataset_export_npy(struct dataset *data, const char *path, enum data_row_side side, enum data_entry_type type);
+
+#endif // DATASET_NPY_H
+
+#ifndef DATASET_PACK_H
+#define DATASET_PACK_H
+
+/**
+ * Copies a dataset of vector entries into a dataset whose vector payloads are packed into slabs.
+ *
+ * The elements of every vector are 64-byte aligned, and the vectors of the same
+ * column are laid out one after the other in a slab, with each vector padded with
+ * zeros to a multiple of 64 bytes. The rows, entries and vectors of the copy live in
+ * a single storage, optionally backed by huge pages, which is freed with the last
+ * row. The vectors must therefore not be destroyed individually.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset, whose entries are all vectors.
+ * @param int huge_pages
+ *   Whether to back the storage with transparent huge pages when possible.
+ *
+ * @return struct dataset*
+ *   A pointer to the packed dataset, or NULL on failure.
+ */
+struct dataset *dataset_pack_vectors(struct dataset *data, int huge_pages);
+
+/**
+ * One-hot encodes a dataset of integer entries directly into packed vector slabs.
+ *
+ * The result is the same as `dataset_one_hot_encode`, with the layout of
+ * `dataset_pack_vectors`, and without allocating the vectors one by one.
+ *
+ * @param struct dataset *int_encoded_dataset
+ *   A pointer to the dataset of integer entries, each in the range [0, tokens_size).
+ * @param int tokens_size
+ *   The length of the one-hot vectors.
+ * @param int huge_pages
+ *   Whether to back the storage with transparent huge pages when possible.
+ *
+ * @return struct dataset*
+ *   A pointer to the encoded dataset, or NULL on failure.
+ */
+struct dataset *dataset_one_hot_encode_packed(struct dataset *int_encoded_dataset, int tokens_size, int huge_pages);
+
+#endif // DATASET_PACK_H
+
+#ifndef DATASET_TEXT_H
+#define DATASET_TEXT_H
+
+#include <stdio.h>
+
+/**
+ * Identifies the text format of a dataset.
+ */
+enum dataset_text_format {
+  /**
+   * The human readable format of `dataset_print`.
+   */
+  DATASET_TEXT_PLAIN,
+
+  /**
+   * One line per row with the inputs followed by the outputs, separated by commas.
+   *
+   * Vectors and sparse vectors are expanded into one field per element.
+   */
+  DATASET_TEXT_CSV,
+
+  /**
+   * One JSON object per row, `{"inputs":[...],"outputs":[...]}`.
+   */
+  DATASET_TEXT_JSON_LINES,
+};
+
+/**
+ * Writes a data entry as text to a stream.
+ *
+ * @param struct data_entry *entry
+ *   A pointer to the data entry.
+ * @param FILE *stream
+ *   The stream to write to.
+ * @param enum data_entry_type type
+ *   The type of the entry.
+ * @param enum dataset_text_format format
+ *   The text format.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+int data_entry_write_text(struct data_entry *entry, FILE *stream, enum data_entry_type type, enum dataset_text_format format);
+
+/**
+ * Writes a dataset as text to a stream.
+ *
+ * The text is assembled in a large buffer with dedicated integer formatting and
+ * handed to the stream in large blocks, instead of one `printf` call per value.
+ * Doubles are written with 6 significant digits in the plain format, like `%g`,
+ * and with 17 significant digits in the other formats so they read back exactly.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param FILE *stream
+ *   The stream to write to.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ * @param enum dataset_text_format format
+ *   The text format.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+int dataset_write_text(struct dataset *data, FILE *stream, enum data_entry_type type, enum dataset_text_format format);
+
+/**
+ * Writes a dataset as text to a file descriptor.
+ *
+ * This is `dataset_write_text` without the stdio layer, the buffer is written
+ * with `write`.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ * @param int fd
+ *   The file descriptor to write to.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ * @param enum dataset_text_format format
+ *   The text format.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+int dataset_write_text_fd(struct dataset *data, int fd, enum data_entry_type type, enum dataset_text_format format);
+
+#endif // DATASET_TEXT_H
+
+#ifndef DATASET_JOURNAL_H
+#define DATASET_JOURNAL_H
+
+/**
+ * Attaches an append-only journal to a dataset.
+ *
+ * Every row appended to the dataset afterwards is serialized to the journal as a
+ * length-prefixed record with a CRC-32C checksum. Records are buffered and the
+ * file is synced to disk once every `group_rows` rows, so a crash loses at most
+ * the rows of the last uncommitted group. An existing journal is kept up to its
+ * last valid record and extended, so a dataset returned by `dataset_recover` can
+ * be attached back to the file it was recovered from. The rows already in the
+ * dataset are not written.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset, without a journal.
+ * @param const char *path
+ *   The path of the journal file.
+ * @param enum data_entry_type type
+ *   The type of the entries of the rows: DATA_ENTRY_TYPE_INT, DATA_ENTRY_TYPE_DOUBLE
+ *   or DATA_ENTRY_TYPE_STRING, the types the records can serialize.
+ * @param int group_rows
+ *   The number of rows committed by each sync, 1 to sync every row.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+int dataset_journal_open(struct dataset *data, const char *path, enum data_entry_type type, int group_rows);
+
+/**
+ * Logs a row to a journal, syncing the file when a group of rows is complete.
+ *
+ * This is called by `dataset_append_row`, `dataset_concat` and the concurrent
+ * append paths, and is safe to call from several threads.
+ *
+ * @param struct dataset_journal *journal
+ *   A pointer to the journal.
+ * @param struct data_row *row
+ *   A pointer to the row.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the row could not be serialized or written.
+ */
+int dataset_journal_write_row(struct dataset_journal *journal, struct data_row *row);
+
+/**
+ * Logs a chain of rows to a journal, following the next links of the rows.
+ *
+ * Every row is checked before the first record is written, so a row that can
+ * not be serialized leaves the journal untouched. A write failure past that
+ * point may leave part of the chain in the file, where a recovery would find
+ * it; the journal then rejects every further row.
+ *
+ * @param struct dataset_journal *journal
+ *   A pointer to the journal.
+ * @param struct data_row *first
+ *   A pointer to the first row of the chain, NULL for an empty chain.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if a row could not be serialized or written.
+ */
+int dataset_journal_write_rows(struct dataset_journal *journal, struct data_row *first);
+
+/**
+ * Writes the buffered rows of the journal of a dataset and syncs the file.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the dataset has no journal or the rows could not be written.
+ */
+int dataset_journal_commit(struct dataset *data);
+
+/**
+ * Commits and detaches the journal of a dataset.
+ *
+ * This is called by `dataset_destroy`.
+ *
+ * @param struct dataset *data
+ *   A pointer to the dataset.
+ *
+ * @return int
+ *   Returns 0 on success or if the dataset has no journal, or -1 if the last rows could not be written.
+ */
+int dataset_journal_close(struct dataset *data);
+
+/**
+ * Rebuilds a dataset from a journal.
+ *
+ * The records are read sequentially through a large buffer, up to the first
+ * truncated or corrupted record, which marks the point where the writer stopped.
+ *
+ * @param const char *path
+ *   The path of the journal file.
+ *
+ * @return struct dataset*
+ *   A pointer to the dataset of the valid records, or NULL if the file is not a journal.
+ */
+struct dataset *dataset_recover(const char *path);
+
+#endif // DATASET_JOURNAL_H
+
+#ifndef DATASET_LABEL_H
+#define DATASET_LABEL_H
+
+/**
+ * Opaque handle of a mapping of whole strings to integer ids.
+ */
+struct dataset_label_encoder;
+
+/**
+ * Creates an empty label encoder.
+ *
+ * The encoder assigns consecutive ids, starting at 0, to the distinct strings in
+ * the order they are first seen. The strings are kept in an open addressing hash
+ * table storing the hash of each string, so growing the table never hashes a
+ * string again.
+ *
+ * @return struct dataset_label_encoder*
+ *   A pointer to the newly created encoder, or NULL on failure.
+ */
+struct dataset_label_encoder *dataset_label_encoder_create();
+
+/**
+ * Destroys a label encoder, freeing all its strings.
+ *
+ * @param struct dataset_label_encoder *encoder
+ *   A pointer to the encoder to be destroyed.
+ */
+void dataset_label_encoder_destroy(struct dataset_label_encoder *encoder);
+
+/**
+ * Freezes a label encoder, so the strings it has not seen are no longer added.
+ *
+ * A frozen encoder applies the mapping learned on a training set to validation
+ * and test sets unchanged.
+ *
+ * @param struct dataset_label_encoder *encoder
+ *   A pointer to the encoder.
+ * @param int unknown
+ *   Whether the unseen strings are encoded as an extra id equal to the number of
+ *   known strings. Otherwise, encoding an unseen string fails.
+ */
+void dataset_label_encoder_freeze(struct dataset_label_encoder *encoder, int unknown);
+
+/**
+ * Gets the number of ids of a label encoder.
+ *
+ * This is the `tokens_size` to one-hot encode the ids with, including the id of
+ * the unseen strings of a frozen encoder.
+ *
+ * @param struct dataset_label_encoder *encoder
+ *   A pointer to the encoder.
+ *
+ * @return int
+ *   The number of ids, or 0 if the encoder is NULL.
+ */
+int dataset_label_encoder_get_size(struct dataset_label_encoder *encoder);
+
+/**
+ * Gets the id of a string, adding the string unless the encoder is frozen.
+ *
+ * @param struct dataset_label_encoder *encoder
+ *   A pointer to the encoder.
+ * @param const char *label
+ *   The null-terminated string.
+ *
+ * @return int
+ *   The id of the string, or -1 if the string is unseen and can not be encoded.
+ */
+int dataset_label_encoder_get_id(struct dataset_label_encoder *encoder, const char *label);
+
+/**
+ * Gets the string of an id.
+ *
+ * @param struct dataset_label_encoder *encoder
+ *   A pointer to the encoder.
+ * @param int id
+ *   The id.
+ *
+ * @return const char*
+ *   The string, owned by the encoder and valid until it is destroyed or a string is
+ *   added, or NULL if the id is not the id of a known string.
+ */
+const char *dataset_label_encoder_get_label(struct dataset_label_encoder *encoder, int id);
+
+/**
+ * Encodes every string entry of a dataset as the integer id of the whole string.
+ *
+ * The rows keep their shape, and the integer entries can be one-hot encoded with
+ * `dataset_one_hot_encode` and `dataset_label_encoder_get_size`. A single encoder
+ * is used for every column; project the dataset to encode columns separately.
+ *
+ * @param struct dataset *string_dataset
+ *   A pointer to the dataset of string entries.
+ * @param struct dataset_label_encoder *encoder
+ *   A pointer to the encoder, which learns the unseen strings unless it is frozen.
+ *
+ * @return struct dataset*
+ *   A new dataset of integer entries, or NULL if an entry is empty or can not be encoded.
+ */
+struct dataset *dataset_label_encode(struct dataset *string_dataset, struct dataset_label_encoder *encoder);
+
+#endif // DATASET_LABEL_H
+
+#ifndef DATASET_WINDOW_H
+#define DATASET_WINDOW_H
+
+/**
+ * Creates a dataset of sliding windows over a sequence of doubles.
+ *
+ * Row i takes the `window` values starting at `i * stride` as inputs and the
+ * `horizon` values that follow as outputs. The values are copied once into a
+ * shared storage, and the entries of all the rows are slices of a single array of
+ * entries over it, so the memory grows with the length of the sequence instead of
+ * the number of rows times the window. The rows are ordinary rows, the batch,
+ * export and encoding functions read the shared values directly. Since windows
+ * overlap, the values must not be modified in place, for example by
+ * `dataset_normalize` or `dataset_standardize`; compute the statistics with
+ * `dataset_column_stats` and scale the sequence before building the windows.
+ *
+ * @param const double *values
+ *   The sequence.
+ * @param int n
+ *   The length of the sequence.
+ * @param int window
+ *   The number of inputs of each row, greater than 0.
+ * @param int horizon
+ *   The number of outputs of each row, 0 or more.
+ * @param int stride
+ *   The distance between the first values of two consecutive rows, greater than 0.
+ *
+ * @return struct dataset*
+ *   A pointer to the dataset of DATA_ENTRY_TYPE_DOUBLE entries, empty if the sequence is
+ *   shorter than a window and its horizon, or NULL on failure.
+ */
+struct dataset *dataset_from_windows(const double *values, int n, int window, int horizon, int stride);
+
+/**
+ * Creates a dataset of sliding windows over a sequence of integers, such as token ids.
+ *
+ * This is `dataset_from_windows` for DATA_ENTRY_TYPE_INT entries, which can be one-hot
+ * encoded for next-token tasks.
+ *
+ * @param const int *values
+ *   The sequence.
+ * @param int n
+ *   The length of the sequence.
+ * @param int window
+ *   The number of inputs of each row, greater than 0.
+ * @param int horizon
+ *   The number of outputs of each row, 0 or more.
+ * @param int stride
+ *   The distance between the first values of two consecutive rows, greater than 0.
+ *
+ * @return struct dataset*
+ *   A pointer to the dataset, or NULL on failure.
+ */
+struct dataset *dataset_from_windows_int(const int *values, int n, int window, int horizon, int stride);
+
+#endif // DATASET_WINDOW_H
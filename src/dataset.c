@@ -1,3 +1,4 @@
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -48,6 +49,31 @@ struct data_entry *data_entry_create_int(int value) {
   return entry;
 }
 
+/**
+ * {@inheritdoc}
+ */
+struct data_entry *data_entry_create_double(double value) {
+  // Allocate memory to store the double value.
+  size_t data_size = sizeof(double);
+  // Allocate memory for the double value.
+  double *data = malloc(data_size);
+  if (data == NULL) {
+    // Memory allocation failed.
+    return NULL;
+  }
+  // Set the double value.
+  *data = value;
+  // Create a new data entry with the double value.
+  struct data_entry *entry = data_entry_create(data);
+  if (entry == NULL) {
+    // Data entry creation failed; free the allocated memory.
+    free(data);
+    return NULL;
+  }
+  // Return the newly created data entry.
+  return entry;
+}
+
 /**
  * {@inheritdoc}
  */
@@ -68,50 +94,74 @@ void data_entry_destroy(struct data_entry *entry) {
  * {@inheritdoc}
  */
 void data_entry_print_int(struct data_entry *entry) {
-  if (entry == NULL || entry->data == NULL) {
-    // Handle cases where the entry or its value is NULL.
-    printf("Invalid data entry.\n");
-    return;
-  }
-  // Dereference the value to print it as an integer.
-  int value = *(int *)entry->data;
-  // Print the integer value stored in the data_entry.
-  printf("%d", value);
+  data_entry_write_text(entry, stdout, DATA_ENTRY_TYPE_INT, DATASET_TEXT_PLAIN);
 }
 
 /**
  * {@inheritdoc}
  */
 void data_entry_print_string(struct data_entry *entry) {
-  if (entry == NULL || entry->data == NULL) {
-    // Handle cases where the entry or its value is NULL.
-    printf("Invalid data entry.\n");
-    return;
-  }
-  // Retrieve the value from the entry, assuming it's a string
-  char *value = (char *)entry->data;
-  // Print the string value stored in the data_entry.
-  printf("'%s'", value);
+  data_entry_write_text(entry, stdout, DATA_ENTRY_TYPE_STRING, DATASET_TEXT_PLAIN);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void data_entry_print_double(struct data_entry *entry) {
+  data_entry_write_text(entry, stdout, DATA_ENTRY_TYPE_DOUBLE, DATASET_TEXT_PLAIN);
 }
 
 /**
  * {@inheritdoc}
  */
 void data_entry_print_vector(struct data_entry *entry) {
-  if (entry == NULL || entry->data == NULL) {
-    printf("Invalid data entry.\n");
-    return;
+  data_entry_write_text(entry, stdout, DATA_ENTRY_TYPE_VECTOR, DATASET_TEXT_PLAIN);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void data_entry_print_sparse(struct data_entry *entry) {
+  data_entry_write_text(entry, stdout, DATA_ENTRY_TYPE_SPARSE, DATASET_TEXT_PLAIN);
+}
+
+/**
+ * Finds the entry type printed by one of the print functions of the library.
+ *
+ * @param void (*print_entry)(struct data_entry *)
+ *   The print function.
+ * @param enum data_entry_type *type
+ *   Receives the type of the entries printed by the function.
+ *
+ * @return int
+ *   Returns 1 if the function is one of the library, or 0 otherwise.
+ */
+static int data_entry_print_type(void (*print_entry)(struct data_entry *), enum data_entry_type *type) {
+  if (print_entry == data_entry_print_int) {
+    *type = DATA_ENTRY_TYPE_INT;
+  } else if (print_entry == data_entry_print_string) {
+    *type = DATA_ENTRY_TYPE_STRING;
+  } else if (print_entry == data_entry_print_double) {
+    *type = DATA_ENTRY_TYPE_DOUBLE;
+  } else if (print_entry == data_entry_print_vector) {
+    *type = DATA_ENTRY_TYPE_VECTOR;
+  } else if (print_entry == data_entry_print_sparse) {
+    *type = DATA_ENTRY_TYPE_SPARSE;
+  } else {
+    return 0;
   }
-  // Cast the data to a vector
-  struct vector *vector_object = (struct vector *)entry->data;
-  // Print the vector.
-  vector_print(vector_object);
+  return 1;
 }
 
 /**
  * {@inheritdoc}
  */
-struct data_entries *data_entries_create(int size) {
+struct data_entries *data_entries_create(int64_t size) {
+  // Check that the array of pointers fits in memory, its size cannot overflow.
+  size_t entry_size = sizeof(struct data_entry *);
+  if (size < 0 || (uint64_t)size > SIZE_MAX / entry_size) {
+    return NULL;
+  }
   // Calculate the size of the data_entries structure.
   size_t entries_size = sizeof(struct data_entries);
   // Allocate memory for the data_entries structure.
@@ -122,16 +172,15 @@ struct data_entries *data_entries_create(int size) {
   }
   // Set the size of the collection.
   new_entries->size = size;
-  // Allocate memory for the array of pointers to data_entry structures.
-  size_t entry_size = sizeof(struct data_entry *);
-  new_entries->entries = malloc(size * entry_size);
+  // Allocate memory for the array of pointers to data_entry structures, an empty array still gets a valid pointer.
+  new_entries->entries = malloc(size > 0 ? (size_t)size * entry_size : entry_size);
   if (new_entries->entries == NULL) {
     // Free previously allocated memory if allocation for entries fails.
     free(new_entries);
     return NULL;
   }
   // Initialize all data_entry pointers to NULL.
-  for (int i = 0; i < size; i++) {
+  for (int64_t i = 0; i < size; i++) {
     new_entries->entries[i] = NULL;
   }
   // Return the newly created data_entries structure.
@@ -147,7 +196,7 @@ void data_entries_destroy(struct data_entries *entries) {
     return;
   }
   // Destroy each data_entry in the array.
-  for (int i = 0; i < entries->size; i++) {
+  for (int64_t i = 0; i < entries->size; i++) {
     if (entries->entries[i] != NULL) {
       data_entry_destroy(entries->entries[i]);
     }
@@ -167,7 +216,7 @@ void data_entries_print(struct data_entries *entries, void (*print_entry)(struct
     return;
   }
   // Iterate over each data_entry and print it using the provided print function.
-  for (int i = 0; i < entries->size; i++) {
+  for (int64_t i = 0; i < entries->size; i++) {
     if (entries->entries[i] != NULL) {
       // Print a comma and space to separate input values after the first one.
       if (i != 0) {
@@ -197,6 +246,8 @@ struct data_row *data_row_create() {
   // Initialize the previous and next pointers to NULL.
   row->previous = NULL;
   row->next = NULL;
+  // The row and its entries are allocated one by one.
+  row->storage = NULL;
   // Return the newly created data_row structure.
   return row;
 }
@@ -209,6 +260,11 @@ void data_row_destroy(struct data_row *row) {
     // No action needed if row is NULL.
     return;
   }
+  if (row->storage != NULL) {
+    // The row lives in a bulk storage, which is freed with its last row.
+    dataset_storage_release(row->storage);
+    return;
+  }
   // Destroy the input data entries.
   if (row->inputs != NULL) {
     data_entries_destroy(row->inputs);
@@ -223,6 +279,18 @@ void data_row_destroy(struct data_row *row) {
   free(row);
 }
 
+/**
+ * {@inheritdoc}
+ */
+struct data_entries *data_row_get_entries(struct data_row *row, enum data_row_side side) {
+  if (row == NULL) {
+    // No entries to return if row is NULL.
+    return NULL;
+  }
+  // Return the requested collection of data entries.
+  return side == DATA_ROW_OUTPUTS ? row->outputs : row->inputs;
+}
+
 /**
  * {@inheritdoc}
  */
@@ -237,8 +305,10 @@ struct dataset *dataset_create() {
   }
   // Initialize the dataset size to 0.
   object->size = 0;
-  // Initialize the iterator to NULL.
+  // Initialize the iterator and the last row to NULL.
   object->iterator = NULL;
+  object->last = NULL;
+  object->journal = NULL;
   // Return the newly created dataset structure.
   return object;
 }
@@ -252,12 +322,16 @@ void dataset_destroy(struct dataset *data) {
     return;
   }
   // Iterate through each data_row in the dataset and destroy it.
-  struct data_row *current = data->iterator;
+  struct dataset_cursor cursor;
+  struct data_row *current = dataset_cursor_begin(&cursor, data);
   while (current != NULL) {
-    struct data_row *next = current->next;
+    // Move the cursor away before the row it points to is destroyed.
+    struct data_row *next = dataset_cursor_next(&cursor);
     data_row_destroy(current);
     current = next;
   }
+  // Commit and close the journal, if any.
+  dataset_journal_close(data);
   // Free the memory allocated for the dataset structure itself.
   free(data);
 }
@@ -271,18 +345,25 @@ void dataset_print(struct dataset *data, void (*print_entry)(struct data_entry *
     printf("Dataset is NULL.\n");
     return;
   }
+  // The print functions of the library go through the buffered text writer.
+  enum data_entry_type type;
+  if (data_entry_print_type(print_entry, &type)) {
+    dataset_write_text(data, stdout, type, DATASET_TEXT_PLAIN);
+    return;
+  }
   // Print a header for the dataset.
   printf("-----------------------------------------------\n");
   // Print the number of rows in the dataset.
-  printf("Dataset: # rows %d.\n", data->size);
-  // Initialize a pointer to iterate over the rows.
-  struct data_row *current = data->iterator;
+  printf("Dataset: # rows %lld.\n", (long long)data->size);
+  // Initialize a cursor to iterate over the rows.
+  struct dataset_cursor cursor;
+  struct data_row *current = dataset_cursor_begin(&cursor, data);
   // Initialize a counter for row numbers.
-  int row_number = 1;
+  int64_t row_number = 1;
   // Iterate over each row in the dataset.
   while (current != NULL) {
     // Print the current row number.
-    printf("Row #%d: ", row_number);
+    printf("Row #%lld: ", (long long)row_number);
     // Print the input values for the current row.
     printf("Input [");
     data_entries_print(current->inputs, print_entry);
@@ -292,7 +373,7 @@ void dataset_print(struct dataset *data, void (*print_entry)(struct data_entry *
     data_entries_print(current->outputs, print_entry);
     printf("]\n");
     // Move to the next row.
-    current = current->next;
+    current = dataset_cursor_next(&cursor);
     // Increment the row number counter.
     row_number++;
   }
@@ -308,14 +389,20 @@ int dataset_append_row(struct dataset *data, struct data_row *row) {
   if (data == NULL || row == NULL) {
     return -1;
   }
+  // Log the row first, so a row is only kept when it can be recovered.
+  if (data->journal != NULL && dataset_journal_write_row(data->journal, row) != 0) {
+    return -1;
+  }
   if (data->last == NULL) {
     // If the dataset is empty, set the new row as the first row.
     data->iterator = row;
   } else {
     // Link the new row to the current last row.
     data->last->next = row;
-    row->previous = data->last;
   }
+  // Replace the links the row may have kept from another dataset.
+  row->previous = data->last;
+  row->next = NULL;
   // Update the last_row to the new row.
   data->last = row;
   // Increment the dataset size.
@@ -324,6 +411,133 @@ int dataset_append_row(struct dataset *data, struct data_row *row) {
   return 0;
 }
 
+/**
+ * {@inheritdoc}
+ */
+int dataset_concat(struct dataset *destination, struct dataset *source) {
+  // Check if the input params are valid.
+  if (destination == NULL || source == NULL || destination == source) {
+    return -1;
+  }
+  if (source->iterator == NULL) {
+    // Nothing to move.
+    return 0;
+  }
+  // Log the moved rows, the datasets are left untouched if this fails.
+  if (destination->journal != NULL && dataset_journal_write_rows(destination->journal, source->iterator) != 0) {
+    return -1;
+  }
+  // Splice the chain of the source after the last row of the destination.
+  if (destination->last == NULL) {
+    destination->iterator = source->iterator;
+  } else {
+    destination->last->next = source->iterator;
+  }
+  source->iterator->previous = destination->last;
+  destination->last = source->last;
+  destination->size += source->size;
+  // Leave the source empty, it no longer owns the rows.
+  source->iterator = NULL;
+  source->last = NULL;
+  source->size = 0;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct data_row *dataset_cursor_begin(struct dataset_cursor *cursor, const struct dataset *data) {
+  if (cursor == NULL) {
+    return NULL;
+  }
+  // Place the cursor on the first row of the dataset.
+  cursor->data = data;
+  cursor->row = data != NULL ? data->iterator : NULL;
+  cursor->position = 0;
+  return cursor->row;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct data_row *dataset_cursor_next(struct dataset_cursor *cursor) {
+  if (cursor == NULL || cursor->data == NULL) {
+    return NULL;
+  }
+  if (cursor->row == NULL) {
+    // Moving forward from before the first row lands on the first row.
+    if (cursor->position >= 0) {
+      return NULL;
+    }
+    return dataset_cursor_begin(cursor, cursor->data);
+  }
+  cursor->row = cursor->row->next;
+  cursor->position++;
+  return cursor->row;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct data_row *dataset_cursor_prev(struct dataset_cursor *cursor) {
+  if (cursor == NULL || cursor->data == NULL) {
+    return NULL;
+  }
+  if (cursor->row == NULL) {
+    // Moving back from past the end lands on the last row.
+    if (cursor->position <= 0) {
+      return NULL;
+    }
+    cursor->row = cursor->data->last;
+    cursor->position = cursor->data->size - 1;
+    return cursor->row;
+  }
+  cursor->row = cursor->row->previous;
+  cursor->position--;
+  return cursor->row;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct data_row *dataset_cursor_seek(struct dataset_cursor *cursor, int64_t position) {
+  if (cursor == NULL || cursor->data == NULL || position < 0 || position > cursor->data->size) {
+    return NULL;
+  }
+  int64_t size = cursor->data->size;
+  if (position == size) {
+    // Past the last row.
+    cursor->row = NULL;
+    cursor->position = size;
+    return NULL;
+  }
+  // Start from the closest known row.
+  int64_t from_current = cursor->row != NULL ? llabs(position - cursor->position) : size;
+  if (position <= from_current && position <= size - 1 - position) {
+    cursor->row = cursor->data->iterator;
+    cursor->position = 0;
+  } else if (size - 1 - position < from_current) {
+    cursor->row = cursor->data->last;
+    cursor->position = size - 1;
+  }
+  while (cursor->row != NULL && cursor->position < position) {
+    cursor->row = cursor->row->next;
+    cursor->position++;
+  }
+  while (cursor->row != NULL && cursor->position > position) {
+    cursor->row = cursor->row->previous;
+    cursor->position--;
+  }
+  return cursor->row;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_cursor_at_end(const struct dataset_cursor *cursor) {
+  return cursor == NULL || cursor->row == NULL;
+}
+
 /**
  * Finds the index of a token in the tokens array.
  *
@@ -499,24 +713,93 @@ static struct data_entries *data_entry_one_hot_encode(struct data_entry *entry,
 }
 
 /**
- * Allocates memory for an array of data_entries pointers and initializes it.
+ * Finds the index of the largest value of a contiguous array.
  *
+ * The maximum is reduced with four independent lanes so the loop can be
+ * vectorized, and the first position holding it is then located.
+ *
+ * @param const double *values
+ *   The array of values.
  * @param int size
+ *   The number of values, greater than 0.
+ *
+ * @return int
+ *   The lowest index of the largest value.
+ */
+static int argmax(const double *restrict values, int size) {
+  double lanes[4] = {values[0], values[0], values[0], values[0]};
+  int i = 0;
+  for (; i + 4 <= size; i += 4) {
+    for (int lane = 0; lane < 4; lane++) {
+      lanes[lane] = values[i + lane] > lanes[lane] ? values[i + lane] : lanes[lane];
+    }
+  }
+  for (; i < size; i++) {
+    lanes[0] = values[i] > lanes[0] ? values[i] : lanes[0];
+  }
+  double maximum = lanes[0];
+  for (int lane = 1; lane < 4; lane++) {
+    maximum = lanes[lane] > maximum ? lanes[lane] : maximum;
+  }
+  // Locate the first occurrence of the maximum.
+  for (i = 0; i < size; i++) {
+    if (values[i] == maximum) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Decodes a one-hot encoded vector data entry into an integer data entry.
+ *
+ * @param struct data_entry *entry
+ *   The data entry containing the vector to be decoded.
+ * @param char *tokens
+ *   The array of tokens (not used in one-hot decoding).
+ * @param int tokens_size
+ *   The number of tokens (not used in one-hot decoding).
+ *
+ * @return struct data_entries*
+ *   A pointer to the newly created `data_entries` structure containing the decoded
+ *   integer value, or NULL if decoding fails.
+ */
+static struct data_entries *data_entry_one_hot_decode(struct data_entry *entry, char *tokens, int tokens_size) {
+  // Validate input parameters.
+  if (entry == NULL || entry->data == NULL) {
+    return NULL;
+  }
+  // Cast the data entry value to a vector.
+  struct vector *one_hot_vector = (struct vector *)entry->data;
+  if (one_hot_vector->length <= 0 || one_hot_vector->elements == NULL) {
+    return NULL;
+  }
+  // Decode the vector into the integer entry of its largest value.
+  return data_entries_one_hot_decode(one_hot_vector->elements, 1, one_hot_vector->length);
+}
+
+/**
+ * Allocates memory for an array of data_entries pointers and initializes it.
+ *
+ * @param int64_t size
  *   The number of entries in the collection.
  *
  * @return struct data_entries**
  *   A pointer to the allocated and initialized entries_collection array, or NULL if allocation fails.
  */
-static struct data_entries **data_entries_collection_create(int size) {
-  // Calculate the total size of the array.
-  size_t collection_size = size * sizeof(struct data_entries);
+static struct data_entries **data_entries_collection_create(int64_t size) {
+  // Calculate the total size of the array of pointers, refusing sizes that overflow.
+  if (size < 0 || (uint64_t)size > SIZE_MAX / sizeof(struct data_entries *)) {
+    return NULL;
+  }
+  size_t collection_size = size > 0 ? (size_t)size * sizeof(struct data_entries *) : sizeof(struct data_entries *);
   struct data_entries **entries_collection = malloc(collection_size);
   if (entries_collection == NULL) {
     // Memory allocation failed.
     return NULL;
   }
   // Initialize all pointers in the array to NULL.
-  for (int i = 0; i < size; i++) {
+  for (int64_t i = 0; i < size; i++) {
     entries_collection[i] = NULL;
   }
   return entries_collection;
@@ -527,16 +810,16 @@ static struct data_entries **data_entries_collection_create(int size) {
  *
  * @param struct data_entries **entries_collection
  *   The array of data_entries to be destroyed.
- * @param int size
+ * @param int64_t size
  *   The number of entries in the collection.
  */
-static void data_entries_collection_destroy(struct data_entries **entries_collection, int size) {
+static void data_entries_collection_destroy(struct data_entries **entries_collection, int64_t size) {
   if (entries_collection == NULL) {
     // No action needed if the collection is NULL.
     return;
   }
   // Free each data_entries in the array.
-  for (int i = 0; i < size; i++) {
+  for (int64_t i = 0; i < size; i++) {
     if (entries_collection[i] != NULL) {
       data_entries_destroy(entries_collection[i]);
     }
@@ -545,11 +828,499 @@ static void data_entries_collection_destroy(struct data_entries **entries_collec
   free(entries_collection);
 }
 
+/**
+ * Represents a compiled encoding loop of one of the built-in encoders.
+ *
+ * The kernels encode a whole collection of entries with the encoding inlined in
+ * the loop, instead of calling the encoding function through a pointer and
+ * gathering a temporary collection for every entry.
+ */
+struct encode_kernel {
+  /**
+   * The loop encoding a collection of entries.
+   */
+  struct data_entries *(*encode_entries)(struct data_entries *raw_entries, const int *columns, int columns_size, const struct encode_kernel *kernel);
+
+  /**
+   * The size of the tokens, the length of the one-hot vectors.
+   *
+   * @var int
+   */
+  int tokens_size;
+
+  /**
+   * The index of the first token equal to each byte, -1 if there is none.
+   *
+   * @var int[256]
+   */
+  int token_index[256];
+};
+
+/**
+ * Gets the value of a selected raw entry.
+ *
+ * @param struct data_entries *raw_entries
+ *   The raw entries.
+ * @param const int *columns
+ *   The columns to encode, or NULL to encode every entry.
+ * @param int64_t i
+ *   The index of the selected entry.
+ *
+ * @return void*
+ *   The value of the entry, or NULL if the entry is missing or empty.
+ */
+static inline void *encode_kernel_value(struct data_entries *raw_entries, const int *columns, int64_t i) {
+  int64_t column = columns != NULL ? columns[i] : i;
+  struct data_entry *entry = column < raw_entries->size ? raw_entries->entries[column] : NULL;
+  return entry != NULL ? entry->data : NULL;
+}
+
+/**
+ * Defines an encoding loop specialized for one encoder.
+ *
+ * The first pass validates the raw values and counts the encoded entries with
+ * `measure(value, kernel)`, which returns -1 for a value that cannot be encoded.
+ * The second pass writes the encoded entries of each value with
+ * `emit(value, kernel, destination)`, which returns the number of entries written
+ * or -1 on failure. Both are called directly, so they are inlined in the loops.
+ */
+#define ENCODE_KERNEL(name, measure, emit)                                                                                              \
+  static struct data_entries *name(struct data_entries *raw_entries, const int *columns, int columns_size, const struct encode_kernel *kernel) { \
+    if (raw_entries == NULL) {                                                                                                          \
+      return NULL;                                                                                                                      \
+    }                                                                                                                                   \
+    int64_t size = columns != NULL ? columns_size : raw_entries->size;                                                                  \
+    int64_t encoded_size = 0;                                                                                                           \
+    for (int64_t i = 0; i < size; i++) {                                                                                                \
+      void *value = encode_kernel_value(raw_entries, columns, i);                                                                       \
+      int count = value != NULL ? measure(value, kernel) : -1;                                                                          \
+      if (count < 0 || count > INT64_MAX - encoded_size) {                                                                              \
+        return NULL;                                                                                                                    \
+      }                                                                                                                                 \
+      encoded_size += count;                                                                                                            \
+    }                                                                                                                                   \
+    struct data_entries *encoded_entries = data_entries_create(encoded_size);                                                           \
+    if (encoded_entries == NULL) {                                                                                                      \
+      return NULL;                                                                                                                      \
+    }                                                                                                                                   \
+    struct data_entry **destination = encoded_entries->entries;                                                                        \
+    for (int64_t i = 0; i < size; i++) {                                                                                                \
+      int count = emit(encode_kernel_value(raw_entries, columns, i), kernel, destination);                                              \
+      if (count < 0) {                                                                                                                  \
+        data_entries_destroy(encoded_entries);                                                                                          \
+        return NULL;                                                                                                                    \
+      }                                                                                                                                 \
+      destination += count;                                                                                                             \
+    }                                                                                                                                   \
+    return encoded_entries;                                                                                                             \
+  }
+
+/**
+ * Counts the integer entries of a string, one per character.
+ */
+static inline int int_encode_measure(void *value, const struct encode_kernel *kernel) {
+  size_t length = strlen((const char *)value);
+  return length > INT_MAX ? -1 : (int)length;
+}
+
+/**
+ * Encodes each character of a string as the index of its token, looked up in the byte table.
+ */
+static inline int int_encode_emit(void *value, const struct encode_kernel *kernel, struct data_entry **destination) {
+  const unsigned char *string_value = value;
+  int count = 0;
+  for (; string_value[count] != '\0'; count++) {
+    destination[count] = data_entry_create_int(kernel->token_index[string_value[count]]);
+    if (destination[count] == NULL) {
+      return -1;
+    }
+  }
+  return count;
+}
+
+/**
+ * Counts the string entries of an integer, always one.
+ */
+static inline int string_encode_measure(void *value, const struct encode_kernel *kernel) {
+  return 1;
+}
+
+/**
+ * Converts an integer to its string representation.
+ */
+static inline int string_encode_emit(void *value, const struct encode_kernel *kernel, struct data_entry **destination) {
+  char *string_value = itos(*(int *)value);
+  if (string_value == NULL) {
+    return -1;
+  }
+  destination[0] = data_entry_create(string_value);
+  if (destination[0] == NULL) {
+    free(string_value);
+    return -1;
+  }
+  return 1;
+}
+
+/**
+ * Validates an integer against the length of the one-hot vectors, encoded as one vector.
+ */
+static inline int one_hot_encode_measure(void *value, const struct encode_kernel *kernel) {
+  int index = *(int *)value;
+  return index >= 0 && index < kernel->tokens_size ? 1 : -1;
+}
+
+/**
+ * Encodes an integer as a one-hot vector, written directly into the elements of the vector.
+ */
+static inline int one_hot_encode_emit(void *value, const struct encode_kernel *kernel, struct data_entry **destination) {
+  struct vector *one_hot_vector = vector_create(kernel->tokens_size);
+  if (one_hot_vector == NULL) {
+    return -1;
+  }
+  double *restrict elements = one_hot_vector->elements;
+  for (int i = 0; i < kernel->tokens_size; i++) {
+    elements[i] = 0;
+  }
+  elements[*(int *)value] = 1;
+  destination[0] = data_entry_create(one_hot_vector);
+  if (destination[0] == NULL) {
+    vector_destroy(one_hot_vector);
+    return -1;
+  }
+  return 1;
+}
+
+ENCODE_KERNEL(int_encode_entries, int_encode_measure, int_encode_emit)
+ENCODE_KERNEL(string_encode_entries, string_encode_measure, string_encode_emit)
+ENCODE_KERNEL(one_hot_encode_entries, one_hot_encode_measure, one_hot_encode_emit)
+
+/**
+ * Selects the compiled kernel of a built-in encoding function.
+ *
+ * @param struct encode_kernel *kernel
+ *   The kernel to initialize.
+ * @param struct data_entries *(*encode_entry)(struct data_entry *, char *, int)
+ *   The encoding function.
+ * @param char *tokens
+ *   The array of tokens used for encoding.
+ * @param int tokens_size
+ *   The size of the tokens array.
+ *
+ * @return const struct encode_kernel*
+ *   The kernel, or NULL if the function is not a built-in one, in which case the
+ *   entries go through the function.
+ */
+static const struct encode_kernel *encode_kernel_select(struct encode_kernel *kernel, struct data_entries *(*encode_entry)(struct data_entry *, char *, int), char *tokens, int tokens_size) {
+  kernel->tokens_size = tokens_size;
+  if (encode_entry == data_entry_int_encode) {
+    // Build the byte table once, the first of duplicated tokens wins as in find_token_index.
+    // Without tokens every byte stays unknown, as find_token_index reports.
+    for (int i = 0; i < 256; i++) {
+      kernel->token_index[i] = -1;
+    }
+    for (int i = tokens != NULL ? tokens_size - 1 : -1; i >= 0; i--) {
+      kernel->token_index[(unsigned char)tokens[i]] = i;
+    }
+    kernel->encode_entries = int_encode_entries;
+  } else if (encode_entry == data_entry_string_encode) {
+    kernel->encode_entries = string_encode_entries;
+  } else if (encode_entry == data_entry_one_hot_encode && tokens_size > 0) {
+    kernel->encode_entries = one_hot_encode_entries;
+  } else {
+    return NULL;
+  }
+  return kernel;
+}
+
+/**
+ * Represents the encoded result of a raw entry while a row is encoded through a cache.
+ */
+struct cached_result {
+  /**
+   * The raw entry.
+   *
+   * @var struct data_entry *
+   */
+  struct data_entry *raw_entry;
+
+  /**
+   * The result, lent by the cache on a hit or equal to `owned` on a miss.
+   *
+   * @var const struct data_entries *
+   */
+  const struct data_entries *entries;
+
+  /**
+   * The result encoded on a miss, put in the cache once the row is built, or NULL.
+   *
+   * @var struct data_entries *
+   */
+  struct data_entries *owned;
+};
+
+/**
+ * Encodes a single data entry on a cache miss, through the compiled kernel when there is one.
+ *
+ * @param struct data_entry *raw_entry
+ *   The raw data entry to be encoded.
+ * @param char *tokens
+ *   The array of tokens used for encoding.
+ * @param int tokens_size
+ *   The size of the tokens array.
+ * @param encode_entry
+ *   The function used to encode individual data entries.
+ * @param const struct encode_kernel *kernel
+ *   The compiled kernel of the encoding function, or NULL to call the function.
+ *
+ * @return struct data_entries*
+ *   A new data entries containing the encoded values, or NULL on failure.
+ */
+static struct data_entries *data_entry_encode_miss(struct data_entry *raw_entry, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int), const struct encode_kernel *kernel) {
+  if (kernel == NULL) {
+    return encode_entry(raw_entry, tokens, tokens_size);
+  }
+  struct data_entry *entries[1] = {raw_entry};
+  struct data_entries single = {.size = 1, .entries = entries};
+  return kernel->encode_entries(&single, NULL, 0, kernel);
+}
+
+/**
+ * Frees the result of a cache miss, with the elements of its vectors.
+ *
+ * @param struct data_entries *entries
+ *   The entries to free.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ */
+static void data_entries_encoded_destroy(struct data_entries *entries, enum data_entry_type type) {
+  if (entries == NULL) {
+    return;
+  }
+  for (int64_t i = 0; type == DATA_ENTRY_TYPE_VECTOR && i < entries->size; i++) {
+    if (entries->entries[i] != NULL) {
+      vector_destroy(entries->entries[i]->data);
+      entries->entries[i]->data = NULL;
+    }
+  }
+  data_entries_destroy(entries);
+}
+
+/**
+ * Adds the entries and payload bytes of an encoded result to the size of a row.
+ *
+ * Integers and doubles take 8 bytes, so integers can be converted in place, vectors
+ * take their structure and elements, and strings their bytes, stored after the rest.
+ *
+ * @param const struct data_entries *encoded
+ *   The encoded result.
+ * @param enum data_entry_type type
+ *   The type of the encoded entries.
+ * @param size_t *entries_size
+ *   The number of entries, incremented.
+ * @param size_t *payloads_size
+ *   The number of bytes of the aligned payloads, incremented.
+ * @param size_t *strings_size
+ *   The number of bytes of the strings, incremented.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the result is invalid or too large.
+ */
+static int cached_result_measure(const struct data_entries *encoded, enum data_entry_type type, size_t *entries_size, size_t *payloads_size, size_t *strings_size) {
+  for (int64_t i = 0; i < encoded->size; i++) {
+    struct data_entry *entry = encoded->entries[i];
+    (*entries_size)++;
+    if (entry == NULL || entry->data == NULL) {
+      continue;
+    }
+    if (type == DATA_ENTRY_TYPE_VECTOR) {
+      struct vector *vector = entry->data;
+      if (vector->length < 0) {
+        return -1;
+      }
+      *payloads_size += sizeof(struct vector) + (size_t)vector->length * sizeof(double);
+    } else if (type == DATA_ENTRY_TYPE_STRING) {
+      *strings_size += strlen((const char *)entry->data) + 1;
+    } else {
+      *payloads_size += sizeof(double);
+    }
+    // Keep every size far from overflowing the size of the storage.
+    if (*entries_size > SIZE_MAX / 64 || *payloads_size > SIZE_MAX / 4 || *strings_size > SIZE_MAX / 4) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Copies the payload of an encoded entry into the storage of a row.
+ *
+ * @param void *data
+ *   The payload to copy.
+ * @param enum data_entry_type type
+ *   The type of the payload.
+ * @param unsigned char **payloads
+ *   The next free byte of the aligned payloads, advanced.
+ * @param char **strings
+ *   The next free byte of the strings, advanced.
+ *
+ * @return void*
+ *   The copy of the payload.
+ */
+static void *cached_result_copy_payload(void *data, enum data_entry_type type, unsigned char **payloads, char **strings) {
+  if (type == DATA_ENTRY_TYPE_STRING) {
+    char *copy = *strings;
+    size_t size = strlen((const char *)data) + 1;
+    memcpy(copy, data, size);
+    *strings += size;
+    return copy;
+  }
+  void *copy = *payloads;
+  if (type == DATA_ENTRY_TYPE_VECTOR) {
+    struct vector *source = data;
+    struct vector *vector = copy;
+    memset(vector, 0, sizeof(struct vector));
+    vector->length = source->length;
+    vector->elements = (double *)(vector + 1);
+    if (source->length > 0) {
+      memcpy(vector->elements, source->elements, (size_t)source->length * sizeof(double));
+    }
+    *payloads += sizeof(struct vector) + (size_t)source->length * sizeof(double);
+  } else {
+    memcpy(copy, data, type == DATA_ENTRY_TYPE_DOUBLE ? sizeof(double) : sizeof(int));
+    *payloads += sizeof(double);
+  }
+  return copy;
+}
+
+/**
+ * Encodes a data row through an encode cache.
+ *
+ * Every selected entry is looked up first and encoded on a miss, then the results
+ * are copied into a single storage holding the row, and only then are the misses
+ * put in the cache, so no eviction can free a result lent for the row.
+ *
+ * @param struct data_row *raw_row
+ *   The raw data row to be encoded.
+ * @param const struct dataset_view *view
+ *   The view selecting the columns to encode, or NULL to encode every entry.
+ * @param char *tokens
+ *   The array of tokens used for encoding.
+ * @param int tokens_size
+ *   The size of the tokens array.
+ * @param encode_entry
+ *   The function used to encode individual data entries.
+ * @param struct dataset_encode_cache *cache
+ *   The cache of encoded results, bound to the encoding configuration.
+ * @param const struct encode_kernel *kernel
+ *   The compiled kernel of the encoding function, or NULL to call the function.
+ *
+ * @return struct data_row*
+ *   A new data row backed by its own storage, or NULL on failure.
+ */
+static struct data_row *data_row_encode_cached(struct data_row *raw_row, const struct dataset_view *view, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int), struct dataset_encode_cache *cache, const struct encode_kernel *kernel) {
+  enum data_entry_type type = dataset_encode_cache_get_value_type(cache);
+  struct data_entries *raw_entries[2] = {raw_row->inputs, raw_row->outputs};
+  const int *columns[2] = {view != NULL ? view->input_columns : NULL, view != NULL ? view->output_columns : NULL};
+  int64_t sizes[2];
+  for (int side = 0; side < 2; side++) {
+    sizes[side] = columns[side] != NULL ? (side == 0 ? view->input_columns_size : view->output_columns_size) : (raw_entries[side] != NULL ? raw_entries[side]->size : 0);
+  }
+  if (sizes[0] + sizes[1] > (int64_t)(SIZE_MAX / sizeof(struct cached_result))) {
+    return NULL;
+  }
+  // Most rows fit the results on the stack.
+  size_t count = (size_t)(sizes[0] + sizes[1]);
+  struct cached_result local_results[32];
+  struct cached_result *results = count <= 32 ? local_results : malloc(count * sizeof(struct cached_result));
+  if (results == NULL) {
+    return NULL;
+  }
+  // Look up or encode every selected entry, nothing is put in the cache yet.
+  size_t side_entries_size[2] = {0, 0};
+  size_t entries_size = 0;
+  size_t payloads_size = 0;
+  size_t strings_size = 0;
+  int failed = 0;
+  size_t index = 0;
+  for (int side = 0; side < 2; side++) {
+    for (int64_t i = 0; i < sizes[side]; i++, index++) {
+      int64_t column = columns[side] != NULL ? columns[side][i] : i;
+      struct cached_result *result = &results[index];
+      result->raw_entry = raw_entries[side] != NULL && column < raw_entries[side]->size ? raw_entries[side]->entries[column] : NULL;
+      result->owned = NULL;
+      result->entries = NULL;
+      if (failed || result->raw_entry == NULL) {
+        failed = 1;
+        continue;
+      }
+      result->entries = dataset_encode_cache_get(cache, result->raw_entry);
+      if (result->entries == NULL) {
+        result->owned = data_entry_encode_miss(result->raw_entry, tokens, tokens_size, encode_entry, kernel);
+        result->entries = result->owned;
+      }
+      if (result->entries == NULL || cached_result_measure(result->entries, type, &entries_size, &payloads_size, &strings_size) != 0) {
+        failed = 1;
+      }
+    }
+    side_entries_size[side] = entries_size - (side == 1 ? side_entries_size[0] : 0);
+  }
+  // Copy the results into the storage of the row: the row, its collections, the entries and the payloads.
+  struct data_row *encoded_row = NULL;
+  size_t size = sizeof(struct data_row) + 2 * sizeof(struct data_entries) + entries_size * (sizeof(struct data_entry *) + sizeof(struct data_entry)) + payloads_size + strings_size;
+  struct dataset_storage *storage = failed ? NULL : dataset_storage_create(size);
+  if (storage != NULL) {
+    encoded_row = (struct data_row *)storage->memory;
+    struct data_entries *collections = (struct data_entries *)(encoded_row + 1);
+    struct data_entry **pointers = (struct data_entry **)(collections + 2);
+    struct data_entry *entries = (struct data_entry *)(pointers + entries_size);
+    unsigned char *payloads = (unsigned char *)(entries + entries_size);
+    char *strings = (char *)(payloads + payloads_size);
+    size_t entry_index = 0;
+    index = 0;
+    for (int side = 0; side < 2; side++) {
+      collections[side].size = (int64_t)side_entries_size[side];
+      collections[side].entries = &pointers[entry_index];
+      for (int64_t i = 0; i < sizes[side]; i++, index++) {
+        const struct data_entries *encoded = results[index].entries;
+        for (int64_t k = 0; k < encoded->size; k++, entry_index++) {
+          struct data_entry *source = encoded->entries[k];
+          pointers[entry_index] = NULL;
+          if (source != NULL && source->data != NULL) {
+            entries[entry_index].data = cached_result_copy_payload(source->data, type, &payloads, &strings);
+            pointers[entry_index] = &entries[entry_index];
+          }
+        }
+      }
+    }
+    memset(encoded_row, 0, sizeof(struct data_row));
+    encoded_row->inputs = &collections[0];
+    encoded_row->outputs = &collections[1];
+    encoded_row->storage = storage;
+    dataset_storage_retain(storage, 1);
+  }
+  // Cache the misses now that the lent results are no longer needed.
+  for (size_t i = 0; i < index; i++) {
+    if (results[i].owned != NULL) {
+      // A result that cannot be cached is still a valid result.
+      dataset_encode_cache_put(cache, results[i].raw_entry, results[i].owned);
+      data_entries_encoded_destroy(results[i].owned, type);
+    }
+  }
+  if (results != local_results) {
+    free(results);
+  }
+  return encoded_row;
+}
+
 /**
  * Encodes a data entries by transforming its entries using a provided encoding function.
  *
  * @param struct data_entries *raw_entries
  *   The raw data entries to be encoded.
+ * @param const int *columns
+ *   The columns to encode, in order, or NULL to encode every entry.
+ * @param int columns_size
+ *   The number of columns to encode.
  * @param char *tokens
  *   The array of tokens used for encoding.
  * @param int tokens_size
@@ -560,20 +1331,23 @@ static void data_entries_collection_destroy(struct data_entries **entries_collec
  * @return struct data_entries*
  *   A new data entries containing the encoded values, or NULL on failure.
  */
-static struct data_entries *data_entries_encode(struct data_entries *raw_entries, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int)) {
+static struct data_entries *data_entries_encode(struct data_entries *raw_entries, const int *columns, int columns_size, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int)) {
+  int64_t size = columns != NULL ? columns_size : raw_entries->size;
   // Allocate memory for an array of encoded entries.
-  struct data_entries **entries_collection = data_entries_collection_create(raw_entries->size);
+  struct data_entries **entries_collection = data_entries_collection_create(size);
   if (entries_collection == NULL) {
     // Memory allocation failed.
     return NULL;
   }
   // Track the size of encoded entries and encoding success.
-  int encoded_entries_size = 0;
+  int64_t encoded_entries_size = 0;
   int failed = 0;
-  // Encode each entry in the raw_entries.
-  for (int i = 0; i < raw_entries->size; i++) {
-    entries_collection[i] = encode_entry(raw_entries->entries[i], tokens, tokens_size);
-    if (entries_collection[i] == NULL) {
+  // Encode each selected entry in the raw_entries.
+  for (int64_t i = 0; i < size; i++) {
+    int64_t column = columns != NULL ? columns[i] : i;
+    struct data_entry *raw_entry = raw_entries != NULL && column < raw_entries->size ? raw_entries->entries[column] : NULL;
+    entries_collection[i] = raw_entry != NULL ? encode_entry(raw_entry, tokens, tokens_size) : NULL;
+    if (entries_collection[i] == NULL || entries_collection[i]->size > INT64_MAX - encoded_entries_size) {
       failed = 1;
     } else {
       encoded_entries_size += entries_collection[i]->size;
@@ -581,25 +1355,26 @@ static struct data_entries *data_entries_encode(struct data_entries *raw_entries
   }
   // Clean up if encoding failed.
   if (failed == 1) {
-    data_entries_collection_destroy(entries_collection, raw_entries->size);
+    data_entries_collection_destroy(entries_collection, size);
     return NULL;
   }
   // Create a new data_entries structure for the encoded values.
   struct data_entries *encoded_entries = data_entries_create(encoded_entries_size);
   if (encoded_entries == NULL) {
-    data_entries_collection_destroy(entries_collection, raw_entries->size);
+    data_entries_collection_destroy(entries_collection, size);
     return NULL;
   }
   // Populate the encoded_entries structure with encoded values.
-  int index = 0;
-  for (int j = 0; j < raw_entries->size; j++) {
-    for (int k = 0; k < entries_collection[j]->size; k++) {
+  int64_t index = 0;
+  for (int64_t j = 0; j < size; j++) {
+    for (int64_t k = 0; k < entries_collection[j]->size; k++) {
       encoded_entries->entries[index] = entries_collection[j]->entries[k];
       index++;
     }
   }
-  // Free the temporary collection of entries.
-  for (int j = 0; j < raw_entries->size; j++) {
+  // Free the temporary collection of entries, the entries themselves moved to encoded_entries.
+  for (int64_t j = 0; j < size; j++) {
+    free(entries_collection[j]->entries);
     free(entries_collection[j]);
   }
   free(entries_collection);
@@ -612,30 +1387,51 @@ static struct data_entries *data_entries_encode(struct data_entries *raw_entries
  *
  * @param struct data_row *raw_row
  *   The raw data row to be encoded.
+ * @param const struct dataset_view *view
+ *   The view selecting the columns to encode, or NULL to encode every entry.
  * @param char *tokens
  *   The array of tokens used for encoding.
  * @param int tokens_size
  *   The size of the tokens array.
  * @param encode_entry
  *   The function used to encode individual data entries.
+ * @param struct dataset_encode_cache *cache
+ *   The cache of encoded results, or NULL.
+ * @param const struct encode_kernel *kernel
+ *   The compiled kernel of the encoding function, or NULL to call the function.
  *
  * @return struct data_row*
  *   A new data row containing the encoded values, or NULL on failure.
  */
-static struct data_row *data_row_encode(struct data_row *raw_row, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int)) {
+static struct data_row *data_row_encode(struct data_row *raw_row, const struct dataset_view *view, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int), struct dataset_encode_cache *cache, const struct encode_kernel *kernel) {
+  if (cache != NULL) {
+    return data_row_encode_cached(raw_row, view, tokens, tokens_size, encode_entry, cache, kernel);
+  }
   // Create a new data_row for the encoded entries.
   struct data_row *encoded_row = data_row_create();
   if (encoded_row == NULL) {
     return NULL;
   }
+  const int *input_columns = view != NULL ? view->input_columns : NULL;
+  int input_columns_size = view != NULL ? view->input_columns_size : 0;
+  const int *output_columns = view != NULL ? view->output_columns : NULL;
+  int output_columns_size = view != NULL ? view->output_columns_size : 0;
   // Encode the input data entries.
-  encoded_row->inputs = data_entries_encode(raw_row->inputs, tokens, tokens_size, encode_entry);
+  if (kernel != NULL) {
+    encoded_row->inputs = kernel->encode_entries(raw_row->inputs, input_columns, input_columns_size, kernel);
+  } else {
+    encoded_row->inputs = data_entries_encode(raw_row->inputs, input_columns, input_columns_size, tokens, tokens_size, encode_entry);
+  }
   if (encoded_row->inputs == NULL) {
     data_row_destroy(encoded_row);
     return NULL;
   }
   // Encode the output data entries.
-  encoded_row->outputs = data_entries_encode(raw_row->outputs, tokens, tokens_size, encode_entry);
+  if (kernel != NULL) {
+    encoded_row->outputs = kernel->encode_entries(raw_row->outputs, output_columns, output_columns_size, kernel);
+  } else {
+    encoded_row->outputs = data_entries_encode(raw_row->outputs, output_columns, output_columns_size, tokens, tokens_size, encode_entry);
+  }
   if (encoded_row->outputs == NULL) {
     data_row_destroy(encoded_row);
     return NULL;
@@ -648,6 +1444,14 @@ static struct data_row *data_row_encode(struct data_row *raw_row, char *tokens,
  * {@inheritdoc}
  */
 struct dataset *dataset_encode(struct dataset *raw_dataset, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int)) {
+  // Encode the dataset without memoization.
+  return dataset_encode_cached(raw_dataset, tokens, tokens_size, encode_entry, NULL);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_encode_cached(struct dataset *raw_dataset, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int), struct dataset_encode_cache *cache) {
   // Check if the input parameters are NULL or invalid.
   if (raw_dataset == NULL) {
     return NULL;
@@ -657,18 +1461,62 @@ struct dataset *dataset_encode(struct dataset *raw_dataset, char *tokens, int to
   if (encoded_dataset == NULL) {
     return NULL;
   }
-  // Pointers for traversing the raw and encoded rows.
-  struct data_row *current = raw_dataset->iterator;
+  // Drop the cached results of another configuration.
+  if (cache != NULL && dataset_encode_cache_bind(cache, tokens, tokens_size, encode_entry) != 0) {
+    dataset_destroy(encoded_dataset);
+    return NULL;
+  }
+  // Use the compiled loop of the built-in encoders.
+  struct encode_kernel kernel;
+  const struct encode_kernel *selected = encode_kernel_select(&kernel, encode_entry, tokens, tokens_size);
+  // Cursor for traversing the raw rows.
+  struct dataset_cursor cursor;
+  struct data_row *current = dataset_cursor_begin(&cursor, raw_dataset);
   // Process each row in the raw dataset.
   while (current != NULL) {
     // Encode the current row and append the row to the encoded dataset.
-    struct data_row *encoded_row = data_row_encode(current, tokens, tokens_size, encode_entry);
+    struct data_row *encoded_row = data_row_encode(current, NULL, tokens, tokens_size, encode_entry, cache, selected);
     if (encoded_row == NULL || dataset_append_row(encoded_dataset, encoded_row) != 0) {
+      data_row_destroy(encoded_row);
       dataset_destroy(encoded_dataset);
       return NULL;
     }
     // Move cursor to the next row in the dataset.
-    current = current->next;
+    current = dataset_cursor_next(&cursor);
+  }
+  // Return the new dataset containing the encoded rows.
+  return encoded_dataset;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_encode_view(const struct dataset_view *view, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int), struct dataset_encode_cache *cache) {
+  // Check if the input parameters are NULL or invalid.
+  if (view == NULL) {
+    return NULL;
+  }
+  // Create a new dataset to hold the encoded rows.
+  struct dataset *encoded_dataset = dataset_create();
+  if (encoded_dataset == NULL) {
+    return NULL;
+  }
+  // Drop the cached results of another configuration.
+  if (cache != NULL && dataset_encode_cache_bind(cache, tokens, tokens_size, encode_entry) != 0) {
+    dataset_destroy(encoded_dataset);
+    return NULL;
+  }
+  // Use the compiled loop of the built-in encoders.
+  struct encode_kernel kernel;
+  const struct encode_kernel *selected = encode_kernel_select(&kernel, encode_entry, tokens, tokens_size);
+  // Encode each row of the view through its projection.
+  for (int i = 0; i < view->size; i++) {
+    struct data_row *encoded_row = data_row_encode(view->rows[i], view, tokens, tokens_size, encode_entry, cache, selected);
+    if (encoded_row == NULL || dataset_append_row(encoded_dataset, encoded_row) != 0) {
+      data_row_destroy(encoded_row);
+      dataset_destroy(encoded_dataset);
+      return NULL;
+    }
   }
   // Return the new dataset containing the encoded rows.
   return encoded_dataset;
@@ -697,3 +1545,194 @@ struct dataset *dataset_one_hot_encode(struct dataset *int_encoded_dataset, int
   // Encode the dataset using the one-hot encoding function.
   return dataset_encode(int_encoded_dataset, NULL, tokens_size, data_entry_one_hot_encode);
 }
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_int_encode_cached(struct dataset *string_dataset, char *tokens, int tokens_size, struct dataset_encode_cache *cache) {
+  // Encode the dataset using the integer encoding function and the cache.
+  return dataset_encode_cached(string_dataset, tokens, tokens_size, data_entry_int_encode, cache);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_string_encode_cached(struct dataset *int_dataset, struct dataset_encode_cache *cache) {
+  // Encode the dataset using the string encoding function and the cache.
+  return dataset_encode_cached(int_dataset, NULL, 0, data_entry_string_encode, cache);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_one_hot_encode_cached(struct dataset *int_encoded_dataset, int tokens_size, struct dataset_encode_cache *cache) {
+  // Encode the dataset using the one-hot encoding function and the cache.
+  return dataset_encode_cached(int_encoded_dataset, NULL, tokens_size, data_entry_one_hot_encode, cache);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_int_encode_view(const struct dataset_view *view, char *tokens, int tokens_size) {
+  // Encode the view using the integer encoding function.
+  return dataset_encode_view(view, tokens, tokens_size, data_entry_int_encode, NULL);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_string_encode_view(const struct dataset_view *view) {
+  // Encode the view using the string encoding function.
+  return dataset_encode_view(view, NULL, 0, data_entry_string_encode, NULL);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_one_hot_encode_view(const struct dataset_view *view, int tokens_size) {
+  // Encode the view using the one-hot encoding function.
+  return dataset_encode_view(view, NULL, tokens_size, data_entry_one_hot_encode, NULL);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_encoder *dataset_encoder_create(struct dataset *source, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int)) {
+  // Check if the input parameters are NULL.
+  if (source == NULL || encode_entry == NULL) {
+    return NULL;
+  }
+  // Allocate memory for the encoder structure.
+  struct dataset_encoder *encoder = malloc(sizeof(struct dataset_encoder));
+  if (encoder == NULL) {
+    // Memory allocation failed.
+    return NULL;
+  }
+  // Create the dataset that receives the encoded rows.
+  encoder->output = dataset_create();
+  if (encoder->output == NULL) {
+    free(encoder);
+    return NULL;
+  }
+  encoder->source = source;
+  encoder->last = NULL;
+  encoder->tokens = tokens;
+  encoder->tokens_size = tokens_size;
+  encoder->encode_entry = encode_entry;
+  // Return the newly created encoder.
+  return encoder;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_encoder *dataset_encoder_create_int(struct dataset *string_dataset, char *tokens, int tokens_size) {
+  return dataset_encoder_create(string_dataset, tokens, tokens_size, data_entry_int_encode);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_encoder *dataset_encoder_create_string(struct dataset *int_dataset) {
+  return dataset_encoder_create(int_dataset, NULL, 0, data_entry_string_encode);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_encoder *dataset_encoder_create_one_hot(struct dataset *int_encoded_dataset, int tokens_size) {
+  return dataset_encoder_create(int_encoded_dataset, NULL, tokens_size, data_entry_one_hot_encode);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_encoder_sync(struct dataset_encoder *encoder) {
+  // Check if the input parameters are NULL.
+  if (encoder == NULL) {
+    return -1;
+  }
+  // Resume right after the last encoded row.
+  struct data_row *current = encoder->last != NULL ? encoder->last->next : encoder->source->iterator;
+  struct encode_kernel kernel;
+  const struct encode_kernel *selected = encode_kernel_select(&kernel, encoder->encode_entry, encoder->tokens, encoder->tokens_size);
+  int encoded = 0;
+  while (current != NULL) {
+    // Encode the current row and append the row to the output dataset.
+    struct data_row *encoded_row = data_row_encode(current, NULL, encoder->tokens, encoder->tokens_size, encoder->encode_entry, NULL, selected);
+    if (encoded_row == NULL) {
+      return -1;
+    }
+    if (dataset_append_row(encoder->output, encoded_row) != 0) {
+      data_row_destroy(encoded_row);
+      return -1;
+    }
+    // Remember the progress after each row so a failure can be resumed.
+    encoder->last = current;
+    encoded++;
+    current = current->next;
+  }
+  // Return the number of rows encoded by this call.
+  return encoded;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_encoder_destroy(struct dataset_encoder *encoder) {
+  if (encoder == NULL) {
+    // No action needed if encoder is NULL.
+    return;
+  }
+  // Destroy the output dataset and the encoder itself.
+  dataset_destroy(encoder->output);
+  free(encoder);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_one_hot_decode(struct dataset *one_hot_dataset) {
+  // Decode the dataset using the one-hot decoding function.
+  return dataset_encode(one_hot_dataset, NULL, 0, data_entry_one_hot_decode);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_argmax_rows(const double *matrix, int rows, int columns, int *indices) {
+  // Check if the input params are valid.
+  if (matrix == NULL || indices == NULL || rows < 0 || columns <= 0) {
+    return -1;
+  }
+  // Reduce each row independently.
+  for (int row = 0; row < rows; row++) {
+    indices[row] = argmax(matrix + (size_t)row * columns, columns);
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct data_entries *data_entries_one_hot_decode(const double *matrix, int rows, int columns) {
+  // Check if the input params are valid.
+  if (matrix == NULL || rows < 0 || columns <= 0) {
+    return NULL;
+  }
+  // Create a new data_entries structure to hold one integer per row.
+  struct data_entries *decoded_entries = data_entries_create(rows);
+  if (decoded_entries == NULL) {
+    return NULL;
+  }
+  for (int row = 0; row < rows; row++) {
+    int index = argmax(matrix + (size_t)row * columns, columns);
+    decoded_entries->entries[row] = data_entry_create_int(index);
+    if (decoded_entries->entries[row] == NULL) {
+      data_entries_destroy(decoded_entries);
+      return NULL;
+    }
+  }
+  // Return the populated data_entries structure.
+  return decoded_entries;
+}
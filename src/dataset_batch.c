@@ -0,0 +1,163 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/dataset.h"
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_batch_layout_width(const struct dataset_batch_layout *layout) {
+  // Check if the layout is valid.
+  if (layout == NULL || layout->entries < 0 || layout->entry_width < 1) {
+    return -1;
+  }
+  if (layout->type != DATA_ENTRY_TYPE_INT && layout->type != DATA_ENTRY_TYPE_DOUBLE) {
+    return -1;
+  }
+  if (layout->type == DATA_ENTRY_TYPE_DOUBLE && layout->entry_width != 1) {
+    // Only integer entries can be one-hot encoded.
+    return -1;
+  }
+  // Each entry expands to entry_width values.
+  return layout->entries * layout->entry_width;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_batch *dataset_batch_create(int capacity, int input_width, int output_width) {
+  // Check if the input params are valid.
+  if (capacity <= 0 || input_width < 0 || output_width < 0) {
+    return NULL;
+  }
+  // Allocate memory for the batch structure.
+  struct dataset_batch *batch = malloc(sizeof(struct dataset_batch));
+  if (batch == NULL) {
+    // Memory allocation failed.
+    return NULL;
+  }
+  batch->capacity = capacity;
+  batch->size = 0;
+  batch->index = -1;
+  batch->input_width = input_width;
+  batch->output_width = output_width;
+  // Allocate the matrices, at least one value each so a zero width is valid.
+  batch->inputs = malloc(((size_t)capacity * input_width + 1) * sizeof(double));
+  batch->outputs = malloc(((size_t)capacity * output_width + 1) * sizeof(double));
+  if (batch->inputs == NULL || batch->outputs == NULL) {
+    // Clean up if any of the matrices could not be allocated.
+    dataset_batch_destroy(batch);
+    return NULL;
+  }
+  // Return the newly created batch.
+  return batch;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_batch_destroy(struct dataset_batch *batch) {
+  if (batch == NULL) {
+    // No action needed if batch is NULL.
+    return;
+  }
+  // Free the matrices and the batch structure itself.
+  free(batch->inputs);
+  free(batch->outputs);
+  free(batch);
+}
+
+/**
+ * Encodes a collection of data entries into a single row of a batch matrix.
+ *
+ * @param struct data_entries *entries
+ *   The data entries to encode, may be NULL.
+ * @param const int *columns
+ *   The columns to encode, in order, or NULL to encode the entries in order.
+ * @param int columns_size
+ *   The number of columns to encode.
+ * @param const struct dataset_batch_layout *layout
+ *   The layout used to encode the entries.
+ * @param double *destination
+ *   The row of the batch matrix, with room for the full layout width.
+ * @param int width
+ *   The width of the layout.
+ */
+static void batch_encode_entries(struct data_entries *entries, const int *columns, int columns_size, const struct dataset_batch_layout *layout, double *restrict destination, int width) {
+  // Clear the row, this provides the padding and the zeros of the one-hot encoding.
+  memset(destination, 0, (size_t)width * sizeof(double));
+  if (entries == NULL) {
+    return;
+  }
+  int64_t size = columns != NULL ? columns_size : entries->size;
+  int count = size < layout->entries ? (int)size : layout->entries;
+  for (int i = 0; i < count; i++) {
+    int column = columns != NULL ? columns[i] : i;
+    struct data_entry *entry = column < entries->size ? entries->entries[column] : NULL;
+    if (entry == NULL || entry->data == NULL) {
+      // Missing entries are encoded as zeros.
+      continue;
+    }
+    if (layout->type == DATA_ENTRY_TYPE_DOUBLE) {
+      destination[i] = *(double *)entry->data;
+      continue;
+    }
+    int value = *(int *)entry->data;
+    if (layout->entry_width == 1) {
+      destination[i] = (double)value;
+    } else if (value >= 0 && value < layout->entry_width) {
+      // One-hot encode the value directly into the batch.
+      destination[i * layout->entry_width + value] = 1.0;
+    }
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_batch_gather(struct dataset_batch *batch, struct data_row **rows, int count, const struct dataset_batch_layout *input_layout, const struct dataset_batch_layout *output_layout) {
+  // Check if the input params are valid.
+  if (batch == NULL || (rows == NULL && count > 0) || count < 0 || count > batch->capacity) {
+    return -1;
+  }
+  int input_width = dataset_batch_layout_width(input_layout);
+  int output_width = dataset_batch_layout_width(output_layout);
+  if (input_width != batch->input_width || output_width != batch->output_width) {
+    return -1;
+  }
+  // Encode each row into its slot of the matrices.
+  for (int i = 0; i < count; i++) {
+    double *inputs = batch->inputs + (size_t)i * input_width;
+    double *outputs = batch->outputs + (size_t)i * output_width;
+    batch_encode_entries(rows[i] != NULL ? rows[i]->inputs : NULL, NULL, 0, input_layout, inputs, input_width);
+    batch_encode_entries(rows[i] != NULL ? rows[i]->outputs : NULL, NULL, 0, output_layout, outputs, output_width);
+  }
+  batch->size = count;
+  // Return a success response.
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_batch_gather_view(struct dataset_batch *batch, const struct dataset_view *view, int first, int count, const struct dataset_batch_layout *input_layout, const struct dataset_batch_layout *output_layout) {
+  // Check if the input params are valid.
+  if (batch == NULL || view == NULL || first < 0 || count < 0 || count > batch->capacity || count > view->size - first) {
+    return -1;
+  }
+  int input_width = dataset_batch_layout_width(input_layout);
+  int output_width = dataset_batch_layout_width(output_layout);
+  if (input_width != batch->input_width || output_width != batch->output_width) {
+    return -1;
+  }
+  // Encode each row into its slot of the matrices, reading the columns of the view.
+  for (int i = 0; i < count; i++) {
+    struct data_row *row = view->rows[first + i];
+    double *inputs = batch->inputs + (size_t)i * input_width;
+    double *outputs = batch->outputs + (size_t)i * output_width;
+    batch_encode_entries(row != NULL ? row->inputs : NULL, view->input_columns, view->input_columns_size, input_layout, inputs, input_width);
+    batch_encode_entries(row != NULL ? row->outputs : NULL, view->output_columns, view->output_columns_size, output_layout, outputs, output_width);
+  }
+  batch->size = count;
+  // Return a success response.
+  return 0;
+}
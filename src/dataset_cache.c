@@ -0,0 +1,499 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <matrixmath.h>
+#include "../include/dataset.h"
+#include "dataset_internal.h"
+
+/**
+ * Represents a cached encoded result.
+ */
+struct cache_slot {
+  /**
+   * The hash of the key.
+   *
+   * @var uint64_t
+   */
+  uint64_t hash;
+
+  /**
+   * A copy of the content of the raw entry.
+   *
+   * @var void *
+   */
+  void *key;
+
+  /**
+   * The number of bytes of the key.
+   *
+   * @var size_t
+   */
+  size_t key_size;
+
+  /**
+   * The cached encoded result, owned by the cache.
+   *
+   * @var struct data_entries *
+   */
+  struct data_entries *value;
+
+  /**
+   * The CLOCK reference bit, set on every hit.
+   *
+   * @var int
+   */
+  int referenced;
+};
+
+/**
+ * Represents a bounded cache of encoded data entries.
+ */
+struct dataset_encode_cache {
+  /**
+   * The types of the raw and of the encoded entries.
+   *
+   * @var enum data_entry_type
+   */
+  enum data_entry_type key_type;
+  enum data_entry_type value_type;
+
+  /**
+   * The slots of the cache, the first `size` are in use.
+   *
+   * @var struct cache_slot *
+   */
+  struct cache_slot *slots;
+
+  /**
+   * The maximum and current number of cached results.
+   *
+   * @var int
+   */
+  int capacity;
+  int size;
+
+  /**
+   * The position of the CLOCK hand in the slots.
+   *
+   * @var int
+   */
+  int hand;
+
+  /**
+   * Open addressing table of slot indices, -1 for an empty position.
+   *
+   * @var int *
+   */
+  int *index;
+
+  /**
+   * The number of positions of the index, a power of two.
+   *
+   * @var int
+   */
+  int index_capacity;
+
+  /**
+   * The usage statistics.
+   *
+   * @var size_t
+   */
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+
+  /**
+   * The encoding function the cached results were produced with, or NULL if unbound.
+   *
+   * @var struct data_entries *(*)(struct data_entry *, char *, int)
+   */
+  struct data_entries *(*encode_entry)(struct data_entry *, char *, int);
+
+  /**
+   * A copy of the tokens the cached results were produced with, or NULL.
+   *
+   * @var char *
+   */
+  char *tokens;
+
+  /**
+   * The size of the tokens array.
+   *
+   * @var int
+   */
+  int tokens_size;
+};
+
+/**
+ * Gets the bytes that identify the content of a raw entry.
+ *
+ * @param struct dataset_encode_cache *cache
+ *   The cache.
+ * @param struct data_entry *entry
+ *   The raw entry.
+ * @param size_t *size
+ *   Receives the number of bytes of the key.
+ *
+ * @return const void*
+ *   The key, or NULL if the entry is empty.
+ */
+static const void *cache_key(struct dataset_encode_cache *cache, struct data_entry *entry, size_t *size) {
+  if (entry == NULL || entry->data == NULL) {
+    return NULL;
+  }
+  if (cache->key_type == DATA_ENTRY_TYPE_STRING) {
+    *size = strlen((const char *)entry->data);
+  } else if (cache->key_type == DATA_ENTRY_TYPE_DOUBLE) {
+    *size = sizeof(double);
+  } else {
+    *size = sizeof(int);
+  }
+  return entry->data;
+}
+
+/**
+ * Copies the payload of an encoded entry.
+ *
+ * @param void *data
+ *   The payload to copy.
+ * @param enum data_entry_type type
+ *   The type of the payload.
+ *
+ * @return void*
+ *   The copy of the payload, or NULL on failure.
+ */
+static void *cache_copy_payload(void *data, enum data_entry_type type) {
+  if (type == DATA_ENTRY_TYPE_VECTOR) {
+    struct vector *source = data;
+    struct vector *copy = vector_create(source->length);
+    if (copy != NULL) {
+      memcpy(copy->elements, source->elements, (size_t)source->length * sizeof(*source->elements));
+    }
+    return copy;
+  }
+  size_t size = type == DATA_ENTRY_TYPE_STRING ? strlen((const char *)data) + 1 : (type == DATA_ENTRY_TYPE_DOUBLE ? sizeof(double) : sizeof(int));
+  void *copy = malloc(size);
+  if (copy != NULL) {
+    memcpy(copy, data, size);
+  }
+  return copy;
+}
+
+/**
+ * Copies a collection of encoded entries.
+ *
+ * @param struct data_entries *entries
+ *   The entries to copy.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ *
+ * @return struct data_entries*
+ *   The copy of the entries, or NULL on failure.
+ */
+static struct data_entries *cache_copy_entries(struct data_entries *entries, enum data_entry_type type) {
+  struct data_entries *copy = data_entries_create(entries->size);
+  if (copy == NULL) {
+    return NULL;
+  }
+  for (int64_t i = 0; i < entries->size; i++) {
+    struct data_entry *entry = entries->entries[i];
+    if (entry == NULL || entry->data == NULL) {
+      continue;
+    }
+    void *payload = cache_copy_payload(entry->data, type);
+    copy->entries[i] = payload != NULL ? data_entry_create(payload) : NULL;
+    if (copy->entries[i] == NULL) {
+      if (type == DATA_ENTRY_TYPE_VECTOR) {
+        vector_destroy(payload);
+      } else {
+        free(payload);
+      }
+      data_entries_destroy(copy);
+      return NULL;
+    }
+  }
+  return copy;
+}
+
+/**
+ * Frees a collection of entries owned by the cache.
+ *
+ * Vector payloads are released with `vector_destroy` so their elements are freed too.
+ *
+ * @param struct data_entries *entries
+ *   The entries to free.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ */
+static void cache_destroy_entries(struct data_entries *entries, enum data_entry_type type) {
+  if (entries == NULL) {
+    return;
+  }
+  if (type == DATA_ENTRY_TYPE_VECTOR) {
+    for (int64_t i = 0; i < entries->size; i++) {
+      if (entries->entries[i] != NULL) {
+        vector_destroy(entries->entries[i]->data);
+        entries->entries[i]->data = NULL;
+      }
+    }
+  }
+  data_entries_destroy(entries);
+}
+
+/**
+ * Finds the position of a key in the index.
+ *
+ * @param struct dataset_encode_cache *cache
+ *   The cache.
+ * @param const void *key
+ *   The key.
+ * @param size_t size
+ *   The number of bytes of the key.
+ * @param uint64_t hash
+ *   The hash of the key.
+ *
+ * @return int
+ *   The position holding the key, or the empty position where it would be inserted.
+ */
+static int cache_find(struct dataset_encode_cache *cache, const void *key, size_t size, uint64_t hash) {
+  int mask = cache->index_capacity - 1;
+  int position = (int)(hash & (uint64_t)mask);
+  while (cache->index[position] >= 0) {
+    struct cache_slot *slot = &cache->slots[cache->index[position]];
+    if (slot->hash == hash && slot->key_size == size && memcmp(slot->key, key, size) == 0) {
+      break;
+    }
+    position = (position + 1) & mask;
+  }
+  return position;
+}
+
+/**
+ * Removes a position from the index, shifting back the entries that follow it.
+ *
+ * @param struct dataset_encode_cache *cache
+ *   The cache.
+ * @param int position
+ *   The position to remove.
+ */
+static void cache_unindex(struct dataset_encode_cache *cache, int position) {
+  int mask = cache->index_capacity - 1;
+  cache->index[position] = -1;
+  int next = position;
+  while (1) {
+    next = (next + 1) & mask;
+    if (cache->index[next] < 0) {
+      return;
+    }
+    // Move the entry back if the freed position lies between its home and its position.
+    int home = (int)(cache->slots[cache->index[next]].hash & (uint64_t)mask);
+    int distance_home = (next - home) & mask;
+    int distance_free = (next - position) & mask;
+    if (distance_free <= distance_home) {
+      cache->index[position] = cache->index[next];
+      cache->index[next] = -1;
+      position = next;
+    }
+  }
+}
+
+/**
+ * Frees every cached result, counting them as evictions.
+ *
+ * @param struct dataset_encode_cache *cache
+ *   The cache.
+ */
+static void cache_clear(struct dataset_encode_cache *cache) {
+  for (int i = 0; i < cache->size; i++) {
+    free(cache->slots[i].key);
+    cache_destroy_entries(cache->slots[i].value, cache->value_type);
+  }
+  memset(cache->index, -1, (size_t)cache->index_capacity * sizeof(int));
+  cache->evictions += (size_t)cache->size;
+  cache->size = 0;
+  cache->hand = 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_encode_cache *dataset_encode_cache_create(int capacity, enum data_entry_type key_type, enum data_entry_type value_type) {
+  // Check if the input params are valid.
+  if (capacity <= 0 || capacity > (1 << 28)) {
+    return NULL;
+  }
+  if (key_type != DATA_ENTRY_TYPE_INT && key_type != DATA_ENTRY_TYPE_DOUBLE && key_type != DATA_ENTRY_TYPE_STRING) {
+    return NULL;
+  }
+  if (value_type == DATA_ENTRY_TYPE_SPARSE) {
+    return NULL;
+  }
+  // Allocate memory for the cache structure.
+  struct dataset_encode_cache *cache = calloc(1, sizeof(struct dataset_encode_cache));
+  if (cache == NULL) {
+    // Memory allocation failed.
+    return NULL;
+  }
+  cache->key_type = key_type;
+  cache->value_type = value_type;
+  cache->capacity = capacity;
+  // Keep the index at most half full.
+  cache->index_capacity = 2;
+  while (cache->index_capacity < capacity * 2) {
+    cache->index_capacity *= 2;
+  }
+  cache->slots = calloc((size_t)capacity, sizeof(struct cache_slot));
+  cache->index = malloc((size_t)cache->index_capacity * sizeof(int));
+  if (cache->slots == NULL || cache->index == NULL) {
+    dataset_encode_cache_destroy(cache);
+    return NULL;
+  }
+  memset(cache->index, -1, (size_t)cache->index_capacity * sizeof(int));
+  // Return the newly created cache.
+  return cache;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_encode_cache_destroy(struct dataset_encode_cache *cache) {
+  if (cache == NULL) {
+    // No action needed if cache is NULL.
+    return;
+  }
+  // Free the cached keys and results.
+  for (int i = 0; cache->slots != NULL && i < cache->size; i++) {
+    free(cache->slots[i].key);
+    cache_destroy_entries(cache->slots[i].value, cache->value_type);
+  }
+  free(cache->slots);
+  free(cache->index);
+  free(cache->tokens);
+  free(cache);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_encode_cache_bind(struct dataset_encode_cache *cache, char *tokens, int tokens_size, struct data_entries *(*encode_entry)(struct data_entry *, char *, int)) {
+  if (cache == NULL || encode_entry == NULL || tokens_size < 0) {
+    return -1;
+  }
+  // The one-hot encoders only read the size, a NULL array binds no content.
+  size_t size = tokens != NULL ? (size_t)tokens_size : 0;
+  if (cache->encode_entry == encode_entry && cache->tokens_size == tokens_size && (cache->tokens != NULL) == (tokens != NULL) && (size == 0 || memcmp(cache->tokens, tokens, size) == 0)) {
+    return 0;
+  }
+  // Copy the new configuration before dropping the results of the old one.
+  char *tokens_copy = NULL;
+  if (tokens != NULL) {
+    tokens_copy = malloc(size + 1);
+    if (tokens_copy == NULL) {
+      return -1;
+    }
+    memcpy(tokens_copy, tokens, size);
+  }
+  cache_clear(cache);
+  free(cache->tokens);
+  cache->encode_entry = encode_entry;
+  cache->tokens = tokens_copy;
+  cache->tokens_size = tokens_size;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+enum data_entry_type dataset_encode_cache_get_value_type(struct dataset_encode_cache *cache) {
+  return cache->value_type;
+}
+
+/**
+ * {@inheritdoc}
+ */
+const struct data_entries *dataset_encode_cache_get(struct dataset_encode_cache *cache, struct data_entry *entry) {
+  if (cache == NULL) {
+    return NULL;
+  }
+  size_t size = 0;
+  const void *key = cache_key(cache, entry, &size);
+  if (key == NULL) {
+    return NULL;
+  }
+  int position = cache_find(cache, key, size, dataset_hash_bytes(key, size));
+  if (cache->index[position] < 0) {
+    cache->misses++;
+    return NULL;
+  }
+  // Mark the slot as recently used and lend the result.
+  struct cache_slot *slot = &cache->slots[cache->index[position]];
+  slot->referenced = 1;
+  cache->hits++;
+  return slot->value;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_encode_cache_put(struct dataset_encode_cache *cache, struct data_entry *entry, struct data_entries *encoded) {
+  if (cache == NULL || encoded == NULL) {
+    return -1;
+  }
+  size_t size = 0;
+  const void *key = cache_key(cache, entry, &size);
+  if (key == NULL) {
+    return -1;
+  }
+  uint64_t hash = dataset_hash_bytes(key, size);
+  if (cache->index[cache_find(cache, key, size, hash)] >= 0) {
+    // The result is already cached.
+    return 0;
+  }
+  // Copy the key and the result before touching the cache.
+  void *key_copy = malloc(size + 1);
+  struct data_entries *value = cache_copy_entries(encoded, cache->value_type);
+  if (key_copy == NULL || value == NULL) {
+    free(key_copy);
+    cache_destroy_entries(value, cache->value_type);
+    return -1;
+  }
+  memcpy(key_copy, key, size);
+  int slot_index;
+  if (cache->size < cache->capacity) {
+    slot_index = cache->size++;
+  } else {
+    // CLOCK: give a second chance to the referenced slots and evict the first other one.
+    while (cache->slots[cache->hand].referenced) {
+      cache->slots[cache->hand].referenced = 0;
+      cache->hand = (cache->hand + 1) % cache->capacity;
+    }
+    slot_index = cache->hand;
+    cache->hand = (cache->hand + 1) % cache->capacity;
+    struct cache_slot *victim = &cache->slots[slot_index];
+    cache_unindex(cache, cache_find(cache, victim->key, victim->key_size, victim->hash));
+    free(victim->key);
+    cache_destroy_entries(victim->value, cache->value_type);
+    cache->evictions++;
+  }
+  struct cache_slot *slot = &cache->slots[slot_index];
+  slot->hash = hash;
+  slot->key = key_copy;
+  slot->key_size = size;
+  slot->value = value;
+  slot->referenced = 0;
+  cache->index[cache_find(cache, key_copy, size, hash)] = slot_index;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_encode_cache_get_stats(struct dataset_encode_cache *cache, struct dataset_encode_cache_stats *stats) {
+  if (cache == NULL || stats == NULL) {
+    return;
+  }
+  stats->hits = cache->hits;
+  stats->misses = cache->misses;
+  stats->evictions = cache->evictions;
+  stats->size = cache->size;
+}
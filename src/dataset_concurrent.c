@@ -0,0 +1,104 @@
+#include <stddef.h>
+#include "../include/dataset.h"
+
+/**
+ * Links a chain of rows after the current tail of a dataset.
+ *
+ * The tail is claimed with an atomic exchange, which gives every chain a unique
+ * predecessor, and the predecessor (or the head of the dataset) is pointed to
+ * the chain afterwards.
+ *
+ * @param struct dataset *data
+ *   The dataset.
+ * @param struct data_row *first
+ *   The first row of the chain.
+ * @param struct data_row *last
+ *   The last row of the chain.
+ * @param int64_t size
+ *   The number of rows of the chain.
+ */
+static void dataset_splice_concurrent(struct dataset *data, struct data_row *first, struct data_row *last, int64_t size) {
+  last->next = NULL;
+  struct data_row *previous = __atomic_exchange_n(&data->last, last, __ATOMIC_ACQ_REL);
+  first->previous = previous;
+  if (previous == NULL) {
+    // The dataset was empty, the chain becomes its head.
+    __atomic_store_n(&data->iterator, first, __ATOMIC_RELEASE);
+  } else {
+    __atomic_store_n(&previous->next, first, __ATOMIC_RELEASE);
+  }
+  __atomic_fetch_add(&data->size, size, __ATOMIC_RELAXED);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_append_row_concurrent(struct dataset *data, struct data_row *row) {
+  // Check if the input params are valid.
+  if (data == NULL || row == NULL) {
+    return -1;
+  }
+  // Log the row first, so a row is only kept when it can be recovered.
+  if (data->journal != NULL && dataset_journal_write_row(data->journal, row) != 0) {
+    return -1;
+  }
+  dataset_splice_concurrent(data, row, row, 1);
+  // Return a success response.
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_append_buffer_init(struct dataset_append_buffer *buffer) {
+  if (buffer == NULL) {
+    // No action needed if buffer is NULL.
+    return;
+  }
+  buffer->first = NULL;
+  buffer->last = NULL;
+  buffer->size = 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_append_buffer_push(struct dataset_append_buffer *buffer, struct data_row *row) {
+  // Check if the input params are valid.
+  if (buffer == NULL || row == NULL) {
+    return -1;
+  }
+  // Link the row locally, no other thread sees the buffer.
+  row->next = NULL;
+  row->previous = buffer->last;
+  if (buffer->last == NULL) {
+    buffer->first = row;
+  } else {
+    buffer->last->next = row;
+  }
+  buffer->last = row;
+  buffer->size++;
+  // Return a success response.
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_append_buffer_flush(struct dataset *data, struct dataset_append_buffer *buffer) {
+  // Check if the input params are valid.
+  if (data == NULL || buffer == NULL) {
+    return -1;
+  }
+  // Log the buffered rows, the buffer is kept if this fails.
+  if (data->journal != NULL && dataset_journal_write_rows(data->journal, buffer->first) != 0) {
+    return -1;
+  }
+  if (buffer->first != NULL) {
+    // Splice the whole chain with a single exchange.
+    dataset_splice_concurrent(data, buffer->first, buffer->last, buffer->size);
+  }
+  dataset_append_buffer_init(buffer);
+  // Return a success response.
+  return 0;
+}
@@ -0,0 +1,294 @@
+#include <limits.h>
+#include <stdlib.h>
+#include "../include/dataset.h"
+
+/**
+ * Represents the value of a generated entry, large enough to be converted to a double in place.
+ */
+union generate_value {
+  int integer;
+  double real;
+};
+
+/**
+ * Represents the state shared by the threads filling the rows.
+ */
+struct generate_job {
+  /**
+   * The operation and the shape of the rows.
+   *
+   * @var struct dataset_generate_options
+   */
+  struct dataset_generate_options options;
+
+  /**
+   * The seed of the random values.
+   *
+   * @var uint64_t
+   */
+  uint64_t seed;
+
+  /**
+   * The number of digits of the DATASET_GENERATE_DIGITS shape.
+   *
+   * @var int
+   */
+  int width;
+
+  /**
+   * The number of input and output entries of each row.
+   *
+   * @var int
+   */
+  int inputs;
+  int outputs;
+
+  /**
+   * The number of rows.
+   *
+   * @var int
+   */
+  int count;
+
+  /**
+   * The bulk arrays of rows, entries collections, entry pointers, entries and values.
+   */
+  struct data_row *rows;
+  struct data_entries *collections;
+  struct data_entry **pointers;
+  struct data_entry *entries;
+  union generate_value *values;
+
+  /**
+   * The storage holding the arrays.
+   *
+   * @var struct dataset_storage *
+   */
+  struct dataset_storage *storage;
+};
+
+/**
+ * Computes the range of the results of an operation.
+ *
+ * @param const struct dataset_generate_options *options
+ *   The operation.
+ * @param long long *low
+ *   Receives the lowest possible result.
+ * @param long long *high
+ *   Receives the highest possible result.
+ *
+ * @return int
+ *   Returns 0 if every result fits in an int, or -1 otherwise.
+ */
+static int generate_result_range(const struct dataset_generate_options *options, long long *low, long long *high) {
+  long long min = options->min;
+  long long max = options->max;
+  long long others = options->operands - 1;
+  long long magnitude = max > -min ? max : -min;
+  switch (options->task) {
+    case DATASET_GENERATE_ADDITION:
+      *low = min * options->operands;
+      *high = max * options->operands;
+      break;
+    case DATASET_GENERATE_SUBTRACTION:
+      *low = min - others * max;
+      *high = max - others * min;
+      break;
+    case DATASET_GENERATE_MULTIPLICATION:
+      // Multiply the ranges one operand at a time, stopping as soon as they overflow.
+      *low = min;
+      *high = max;
+      for (int i = 1; i < options->operands; i++) {
+        long long products[4] = {*low * min, *low * max, *high * min, *high * max};
+        *low = products[0];
+        *high = products[0];
+        for (int j = 1; j < 4; j++) {
+          *low = products[j] < *low ? products[j] : *low;
+          *high = products[j] > *high ? products[j] : *high;
+        }
+        if (*low < INT_MIN || *high > INT_MAX) {
+          return -1;
+        }
+      }
+      break;
+    default:
+      // Quotients and remainders are bounded by the magnitude of the first operand.
+      *low = min < 0 ? -magnitude : 0;
+      *high = magnitude;
+      break;
+  }
+  return (*low < INT_MIN || *high > INT_MAX) ? -1 : 0;
+}
+
+/**
+ * Draws an operand of a row.
+ *
+ * @param const struct generate_job *job
+ *   The generation job.
+ * @param uint64_t counter
+ *   The index of the operand among all the operands of the dataset.
+ * @param int divisor
+ *   Whether the operand is a divisor, which must not be 0.
+ *
+ * @return long long
+ *   The operand.
+ */
+static long long generate_operand(const struct generate_job *job, uint64_t counter, int divisor) {
+  long long min = job->options.min;
+  long long max = job->options.max;
+  uint64_t range = (uint64_t)(max - min + 1);
+  int skip_zero = divisor && min <= 0 && max >= 0;
+  if (skip_zero) {
+    range--;
+  }
+  // Map the high 32 bits onto the range with a multiplication, ranges never exceed 2^32.
+  uint64_t random = dataset_random_at(job->seed, counter);
+  long long value = min + (long long)(((random >> 32) * range) >> 32);
+  if (skip_zero && value >= 0) {
+    value++;
+  }
+  return value;
+}
+
+/**
+ * Fills a range of rows.
+ *
+ * @param void *context
+ *   The job, as a `struct generate_job *`.
+ * @param int begin
+ *   The first row of the range.
+ * @param int end
+ *   The end of the range.
+ */
+static void generate_worker(void *context, int begin, int end) {
+  struct generate_job *job = context;
+  const struct dataset_generate_options *options = &job->options;
+  int values_per_row = job->inputs + job->outputs;
+  for (int i = begin; i < end; i++) {
+    size_t first = (size_t)i * (size_t)values_per_row;
+    union generate_value *values = &job->values[first];
+    // Draw the operands and compute the result.
+    long long result = 0;
+    for (int j = 0; j < options->operands; j++) {
+      int divisor = j > 0 && (options->task == DATASET_GENERATE_DIVISION || options->task == DATASET_GENERATE_MODULO);
+      long long operand = generate_operand(job, (uint64_t)i * (uint64_t)options->operands + (uint64_t)j, divisor);
+      values[j].integer = (int)operand;
+      if (j == 0) {
+        result = operand;
+      } else if (options->task == DATASET_GENERATE_ADDITION) {
+        result += operand;
+      } else if (options->task == DATASET_GENERATE_SUBTRACTION) {
+        result -= operand;
+      } else if (options->task == DATASET_GENERATE_MULTIPLICATION) {
+        result *= operand;
+      } else if (options->task == DATASET_GENERATE_DIVISION) {
+        result /= operand;
+      } else {
+        result %= operand;
+      }
+    }
+    // Store the result in the outputs.
+    union generate_value *outputs = &values[job->inputs];
+    if (options->shape == DATASET_GENERATE_SCALAR) {
+      outputs[0].integer = (int)result;
+    } else {
+      long long magnitude = result < 0 ? -result : result;
+      outputs[0].integer = result < 0;
+      for (int digit = job->width; digit > 0; digit--) {
+        outputs[digit].integer = (int)(magnitude % 10);
+        magnitude /= 10;
+      }
+    }
+    // Wire the row to its entries.
+    struct data_entry **pointers = &job->pointers[first];
+    struct data_entry *entries = &job->entries[first];
+    for (int j = 0; j < values_per_row; j++) {
+      entries[j].data = &values[j];
+      pointers[j] = &entries[j];
+    }
+    struct data_entries *collections = &job->collections[2 * (size_t)i];
+    collections[0].size = job->inputs;
+    collections[0].entries = pointers;
+    collections[1].size = job->outputs;
+    collections[1].entries = pointers + job->inputs;
+    struct data_row *row = &job->rows[i];
+    row->inputs = &collections[0];
+    row->outputs = &collections[1];
+    row->previous = i > 0 ? &job->rows[i - 1] : NULL;
+    row->next = i + 1 < job->count ? &job->rows[i + 1] : NULL;
+    row->storage = job->storage;
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_generate(const struct dataset_generate_options *options, int count, uint64_t seed, int threads) {
+  // Check if the input params are valid.
+  if (options == NULL || count < 0 || options->operands < 2 || options->min == INT_MIN || options->min > options->max) {
+    return NULL;
+  }
+  if (options->task < DATASET_GENERATE_ADDITION || options->task > DATASET_GENERATE_MODULO) {
+    return NULL;
+  }
+  if (options->shape != DATASET_GENERATE_SCALAR && options->shape != DATASET_GENERATE_DIGITS) {
+    return NULL;
+  }
+  int division = options->task == DATASET_GENERATE_DIVISION || options->task == DATASET_GENERATE_MODULO;
+  if (division && options->min == 0 && options->max == 0) {
+    // There is no valid divisor.
+    return NULL;
+  }
+  struct generate_job job = {.options = *options, .seed = seed, .count = count, .inputs = options->operands};
+  long long low;
+  long long high;
+  if (generate_result_range(options, &low, &high) != 0) {
+    return NULL;
+  }
+  // Count the digits of the largest result.
+  long long magnitude = high > -low ? high : -low;
+  job.width = 1;
+  while (magnitude >= 10) {
+    magnitude /= 10;
+    job.width++;
+  }
+  job.outputs = options->shape == DATASET_GENERATE_SCALAR ? 1 : 1 + job.width;
+  struct dataset *data = dataset_create();
+  if (data == NULL || count == 0) {
+    return data;
+  }
+  // Lay out every array of the rows in a single storage.
+  size_t values_per_row = (size_t)job.inputs + (size_t)job.outputs;
+  size_t row_size = sizeof(struct data_row) + 2 * sizeof(struct data_entries);
+  size_t value_size = sizeof(struct data_entry *) + sizeof(struct data_entry) + sizeof(union generate_value);
+  if (values_per_row > (SIZE_MAX - row_size) / value_size || row_size + values_per_row * value_size > SIZE_MAX / (size_t)count) {
+    dataset_destroy(data);
+    return NULL;
+  }
+  size_t rows = (size_t)count;
+  job.storage = dataset_storage_create(rows * (row_size + values_per_row * value_size));
+  if (job.storage == NULL) {
+    dataset_destroy(data);
+    return NULL;
+  }
+  // Place the arrays with the strictest alignment first.
+  unsigned char *memory = job.storage->memory;
+  job.values = (union generate_value *)memory;
+  job.rows = (struct data_row *)(job.values + rows * values_per_row);
+  job.collections = (struct data_entries *)(job.rows + rows);
+  job.pointers = (struct data_entry **)(job.collections + 2 * rows);
+  job.entries = (struct data_entry *)(job.pointers + rows * values_per_row);
+  // Fill the rows in one contiguous range per thread.
+  if (dataset_parallel_for(count, threads, generate_worker, &job) != 0) {
+    dataset_storage_destroy(job.storage);
+    dataset_destroy(data);
+    return NULL;
+  }
+  // Hand the rows over to the dataset, each of them references the storage.
+  dataset_storage_retain(job.storage, rows);
+  data->iterator = &job.rows[0];
+  data->last = &job.rows[count - 1];
+  data->size = count;
+  // Return the generated dataset.
+  return data;
+}
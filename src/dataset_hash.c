@@ -0,0 +1,194 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/dataset.h"
+#include "dataset_internal.h"
+
+/**
+ * Represents a hashed feature before the duplicates are combined.
+ */
+struct hashed_feature {
+  int index;
+  double value;
+};
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_sparse_vector *dataset_sparse_vector_create(int dimension, int size) {
+  // Check if the input params are valid.
+  if (dimension <= 0 || size < 0) {
+    return NULL;
+  }
+  // Allocate the structure followed by the values and the indices in one block.
+  size_t header_size = sizeof(struct dataset_sparse_vector);
+  size_t values_size = (size_t)size * sizeof(double);
+  size_t indices_size = (size_t)size * sizeof(int);
+  struct dataset_sparse_vector *sparse = malloc(header_size + values_size + indices_size);
+  if (sparse == NULL) {
+    // Memory allocation failed.
+    return NULL;
+  }
+  sparse->dimension = dimension;
+  sparse->size = size;
+  sparse->values = (double *)(sparse + 1);
+  sparse->indices = (int *)(sparse->values + size);
+  // Return the newly created sparse vector.
+  return sparse;
+}
+
+/**
+ * Compares two hashed features by index, used to sort them with qsort.
+ *
+ * @param const void *a
+ *   The first hashed feature.
+ * @param const void *b
+ *   The second hashed feature.
+ *
+ * @return int
+ *   A negative, zero or positive value if a is lower, equal or greater than b.
+ */
+static int hashed_feature_compare(const void *a, const void *b) {
+  int index_a = ((const struct hashed_feature *)a)->index;
+  int index_b = ((const struct hashed_feature *)b)->index;
+  return (index_a > index_b) - (index_a < index_b);
+}
+
+/**
+ * Hashes a string data entry into a sparse vector.
+ *
+ * @param struct data_entry *entry
+ *   The data entry containing the string to be encoded.
+ * @param int buckets
+ *   The number of hash buckets.
+ * @param int ngram
+ *   The length of the byte n-grams, or 0 to hash the string as a whole.
+ * @param int signed_hash
+ *   Whether the sign of each feature is picked by the hash.
+ *
+ * @return struct data_entry*
+ *   A new data entry holding the sparse vector, or NULL if encoding fails.
+ */
+static struct data_entry *data_entry_hash_encode(struct data_entry *entry, int buckets, int ngram, int signed_hash) {
+  // Check if the input data entry is NULL or does not contain a value.
+  if (entry == NULL || entry->data == NULL) {
+    return NULL;
+  }
+  const char *string_value = (const char *)entry->data;
+  size_t length = strlen(string_value);
+  // Strings shorter than the n-gram length are hashed as a whole.
+  size_t window = (ngram <= 0 || (size_t)ngram > length) ? length : (size_t)ngram;
+  size_t features_size = length - window + 1;
+  struct hashed_feature *features = malloc(features_size * sizeof(struct hashed_feature));
+  if (features == NULL) {
+    return NULL;
+  }
+  // Hash every feature into its bucket.
+  for (size_t i = 0; i < features_size; i++) {
+    uint64_t hash = dataset_hash_bytes(string_value + i, window);
+    features[i].index = (int)((hash & 0xffffffffULL) % (uint64_t)buckets);
+    features[i].value = (signed_hash && (hash >> 63)) ? -1.0 : 1.0;
+  }
+  // Sort by bucket and combine the collisions in place.
+  qsort(features, features_size, sizeof(struct hashed_feature), hashed_feature_compare);
+  size_t size = 0;
+  for (size_t i = 0; i < features_size; i++) {
+    if (size > 0 && features[size - 1].index == features[i].index) {
+      features[size - 1].value += features[i].value;
+    } else {
+      features[size++] = features[i];
+    }
+  }
+  // Signed collisions can cancel out, keep the non-zero values only.
+  size_t non_zero = 0;
+  for (size_t i = 0; i < size; i++) {
+    if (features[i].value != 0.0) {
+      features[non_zero++] = features[i];
+    }
+  }
+  struct dataset_sparse_vector *sparse = dataset_sparse_vector_create(buckets, (int)non_zero);
+  if (sparse == NULL) {
+    free(features);
+    return NULL;
+  }
+  for (size_t i = 0; i < non_zero; i++) {
+    sparse->indices[i] = features[i].index;
+    sparse->values[i] = features[i].value;
+  }
+  free(features);
+  // Wrap the sparse vector into a data entry.
+  struct data_entry *encoded_entry = data_entry_create(sparse);
+  if (encoded_entry == NULL) {
+    free(sparse);
+    return NULL;
+  }
+  return encoded_entry;
+}
+
+/**
+ * Hashes each string entry of a data entries collection into a sparse vector.
+ *
+ * @param struct data_entries *raw_entries
+ *   The raw data entries to be encoded.
+ * @param int buckets
+ *   The number of hash buckets.
+ * @param int ngram
+ *   The length of the byte n-grams, or 0 to hash the strings as a whole.
+ * @param int signed_hash
+ *   Whether the sign of each feature is picked by the hash.
+ *
+ * @return struct data_entries*
+ *   A new data entries containing the sparse vectors, or NULL on failure.
+ */
+static struct data_entries *data_entries_hash_encode(struct data_entries *raw_entries, int buckets, int ngram, int signed_hash) {
+  if (raw_entries == NULL) {
+    return NULL;
+  }
+  struct data_entries *encoded_entries = data_entries_create(raw_entries->size);
+  if (encoded_entries == NULL) {
+    return NULL;
+  }
+  for (int64_t i = 0; i < raw_entries->size; i++) {
+    encoded_entries->entries[i] = data_entry_hash_encode(raw_entries->entries[i], buckets, ngram, signed_hash);
+    if (encoded_entries->entries[i] == NULL) {
+      data_entries_destroy(encoded_entries);
+      return NULL;
+    }
+  }
+  return encoded_entries;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_hash_encode(struct dataset *string_dataset, int buckets, int ngram, int signed_hash) {
+  // Check if the input parameters are NULL or invalid.
+  if (string_dataset == NULL || buckets <= 0 || ngram < 0) {
+    return NULL;
+  }
+  // Create a new dataset to hold the encoded rows.
+  struct dataset *encoded_dataset = dataset_create();
+  if (encoded_dataset == NULL) {
+    return NULL;
+  }
+  // Process each row in the raw dataset.
+  struct data_row *current = string_dataset->iterator;
+  while (current != NULL) {
+    struct data_row *encoded_row = data_row_create();
+    if (encoded_row == NULL) {
+      dataset_destroy(encoded_dataset);
+      return NULL;
+    }
+    encoded_row->inputs = data_entries_hash_encode(current->inputs, buckets, ngram, signed_hash);
+    encoded_row->outputs = data_entries_hash_encode(current->outputs, buckets, ngram, signed_hash);
+    if (encoded_row->inputs == NULL || encoded_row->outputs == NULL || dataset_append_row(encoded_dataset, encoded_row) != 0) {
+      data_row_destroy(encoded_row);
+      dataset_destroy(encoded_dataset);
+      return NULL;
+    }
+    // Move cursor to the next row in the dataset.
+    current = current->next;
+  }
+  // Return the new dataset containing the encoded rows.
+  return encoded_dataset;
+}
@@ -0,0 +1,75 @@
+#ifndef DATASET_INTERNAL_H
+#define DATASET_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Offset basis and prime of 64-bit FNV-1a.
+#define DATASET_FNV_OFFSET 0xcbf29ce484222325ULL
+#define DATASET_FNV_PRIME 0x100000001b3ULL
+
+/**
+ * Mixes a 64-bit value with the SplitMix64 finalizer.
+ *
+ * Every bit of the input affects every bit of the output, so the low bits can be
+ * used directly as a bucket.
+ *
+ * @param uint64_t value
+ *   The value to mix.
+ *
+ * @return uint64_t
+ *   The mixed value.
+ */
+static inline uint64_t dataset_mix64(uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xbf58476d1ce4e5b9ULL;
+  value ^= value >> 27;
+  value *= 0x94d049bb133111ebULL;
+  value ^= value >> 31;
+  return value;
+}
+
+/**
+ * Feeds a sequence of bytes to a running 64-bit FNV-1a hash.
+ *
+ * Start from `DATASET_FNV_OFFSET` and pass the result to `dataset_mix64` once
+ * every byte is fed.
+ *
+ * @param uint64_t hash
+ *   The running hash.
+ * @param const void *bytes
+ *   The bytes.
+ * @param size_t size
+ *   The number of bytes.
+ *
+ * @return uint64_t
+ *   The updated hash.
+ */
+static inline uint64_t dataset_fnv1a(uint64_t hash, const void *bytes, size_t size) {
+  const unsigned char *data = bytes;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= DATASET_FNV_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * Hashes a sequence of bytes with 64-bit FNV-1a followed by a final avalanche.
+ *
+ * FNV-1a alone distributes the low bits poorly for short keys, so the result is
+ * mixed with the SplitMix64 finalizer before a bucket is taken from it.
+ *
+ * @param const void *bytes
+ *   The bytes.
+ * @param size_t size
+ *   The number of bytes.
+ *
+ * @return uint64_t
+ *   The hash of the bytes.
+ */
+static inline uint64_t dataset_hash_bytes(const void *bytes, size_t size) {
+  return dataset_mix64(dataset_fnv1a(DATASET_FNV_OFFSET, bytes, size));
+}
+
+#endif // DATASET_INTERNAL_H
@@ -0,0 +1,456 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/dataset.h"
+
+/**
+ * Identifies the files written by `dataset_save` ("DSET").
+ */
+#define DATASET_FILE_MAGIC 0x54455344U
+
+/**
+ * The version of the file format.
+ */
+#define DATASET_FILE_VERSION 1U
+
+/**
+ * The size of the stream buffers used to read and write files.
+ */
+#define DATASET_FILE_BUFFER_SIZE (1 << 20)
+
+/**
+ * Represents a dataset file being written.
+ */
+struct dataset_file {
+  /**
+   * The output stream.
+   *
+   * @var FILE *
+   */
+  FILE *stream;
+
+  /**
+   * The buffer rows are serialized into before being written.
+   *
+   * @var unsigned char *
+   */
+  unsigned char *scratch;
+
+  /**
+   * The size of the scratch buffer in bytes.
+   *
+   * @var size_t
+   */
+  size_t scratch_size;
+};
+
+/**
+ * Gets the number of bytes used by the payload of an entry.
+ *
+ * @param struct data_entry *entry
+ *   The data entry.
+ * @param enum data_entry_type type
+ *   The type of the entry.
+ *
+ * @return size_t
+ *   The number of bytes, or 0 if the entry cannot be serialized.
+ */
+static size_t entry_serialized_size(struct data_entry *entry, enum data_entry_type type) {
+  if (entry == NULL || entry->data == NULL) {
+    return 0;
+  }
+  switch (type) {
+    case DATA_ENTRY_TYPE_INT:
+      return sizeof(int32_t);
+    case DATA_ENTRY_TYPE_DOUBLE:
+      return sizeof(double);
+    case DATA_ENTRY_TYPE_STRING: {
+      size_t length = strlen((const char *)entry->data);
+      return length > UINT32_MAX ? 0 : sizeof(uint32_t) + length;
+    }
+    default:
+      return 0;
+  }
+}
+
+/**
+ * Gets the number of bytes used by a collection of entries, including its count.
+ *
+ * @param struct data_entries *entries
+ *   The data entries, NULL is treated as an empty collection.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ *
+ * @return size_t
+ *   The number of bytes, or 0 if an entry cannot be serialized.
+ */
+static size_t entries_serialized_size(struct data_entries *entries, enum data_entry_type type) {
+  size_t size = sizeof(uint32_t);
+  int64_t count = entries != NULL ? entries->size : 0;
+  if (count > UINT32_MAX) {
+    // The count is stored on 32 bits.
+    return 0;
+  }
+  for (int64_t i = 0; i < count; i++) {
+    size_t entry_size = entry_serialized_size(entries->entries[i], type);
+    if (entry_size == 0) {
+      return 0;
+    }
+    size += entry_size;
+  }
+  return size;
+}
+
+/**
+ * Writes a collection of entries, including its count.
+ *
+ * The buffer must have room for `entries_serialized_size` bytes.
+ *
+ * @param struct data_entries *entries
+ *   The data entries, NULL is treated as an empty collection.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ * @param unsigned char *buffer
+ *   The buffer that receives the entries.
+ *
+ * @return unsigned char*
+ *   The position following the last written byte.
+ */
+static unsigned char *entries_serialize(struct data_entries *entries, enum data_entry_type type, unsigned char *buffer) {
+  uint32_t count = entries != NULL ? (uint32_t)entries->size : 0;
+  memcpy(buffer, &count, sizeof(count));
+  buffer += sizeof(count);
+  for (uint32_t i = 0; i < count; i++) {
+    void *data = entries->entries[i]->data;
+    if (type == DATA_ENTRY_TYPE_INT) {
+      int32_t value = *(int *)data;
+      memcpy(buffer, &value, sizeof(value));
+      buffer += sizeof(value);
+    } else if (type == DATA_ENTRY_TYPE_DOUBLE) {
+      memcpy(buffer, data, sizeof(double));
+      buffer += sizeof(double);
+    } else {
+      uint32_t length = (uint32_t)strlen((const char *)data);
+      memcpy(buffer, &length, sizeof(length));
+      memcpy(buffer + sizeof(length), data, length);
+      buffer += sizeof(length) + length;
+    }
+  }
+  return buffer;
+}
+
+/**
+ * Reads a collection of entries written by `entries_serialize`.
+ *
+ * @param const unsigned char **buffer
+ *   The position to read from, advanced past the collection.
+ * @param const unsigned char *end
+ *   The end of the serialized data.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ *
+ * @return struct data_entries*
+ *   A new data entries, or NULL if the data is malformed.
+ */
+static struct data_entries *entries_deserialize(const unsigned char **buffer, const unsigned char *end, enum data_entry_type type) {
+  const unsigned char *position = *buffer;
+  uint32_t count;
+  if ((size_t)(end - position) < sizeof(count)) {
+    return NULL;
+  }
+  memcpy(&count, position, sizeof(count));
+  position += sizeof(count);
+  // Every entry takes at least four bytes, which bounds the count by the remaining data.
+  if (count > (size_t)(end - position) / sizeof(int32_t)) {
+    return NULL;
+  }
+  struct data_entries *entries = data_entries_create(count);
+  if (entries == NULL) {
+    return NULL;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    size_t available = (size_t)(end - position);
+    struct data_entry *entry = NULL;
+    if (type == DATA_ENTRY_TYPE_INT && available >= sizeof(int32_t)) {
+      int32_t value;
+      memcpy(&value, position, sizeof(value));
+      position += sizeof(value);
+      entry = data_entry_create_int(value);
+    } else if (type == DATA_ENTRY_TYPE_DOUBLE && available >= sizeof(double)) {
+      double value;
+      memcpy(&value, position, sizeof(value));
+      position += sizeof(value);
+      entry = data_entry_create_double(value);
+    } else if (type == DATA_ENTRY_TYPE_STRING && available >= sizeof(uint32_t)) {
+      uint32_t length;
+      memcpy(&length, position, sizeof(length));
+      position += sizeof(length);
+      char *string = length <= available - sizeof(length) ? malloc((size_t)length + 1) : NULL;
+      if (string != NULL) {
+        memcpy(string, position, length);
+        string[length] = '\0';
+        position += length;
+        entry = data_entry_create(string);
+        if (entry == NULL) {
+          free(string);
+        }
+      }
+    }
+    if (entry == NULL) {
+      data_entries_destroy(entries);
+      return NULL;
+    }
+    entries->entries[i] = entry;
+  }
+  *buffer = position;
+  return entries;
+}
+
+/**
+ * {@inheritdoc}
+ */
+size_t dataset_row_serialize(struct data_row *row, enum data_entry_type type, unsigned char *buffer, size_t capacity) {
+  // Check if the input params are valid.
+  if (row == NULL || (type != DATA_ENTRY_TYPE_INT && type != DATA_ENTRY_TYPE_DOUBLE && type != DATA_ENTRY_TYPE_STRING)) {
+    return 0;
+  }
+  size_t inputs_size = entries_serialized_size(row->inputs, type);
+  size_t outputs_size = entries_serialized_size(row->outputs, type);
+  if (inputs_size == 0 || outputs_size == 0) {
+    return 0;
+  }
+  size_t size = inputs_size + outputs_size;
+  if (buffer != NULL && size <= capacity) {
+    entries_serialize(row->outputs, type, entries_serialize(row->inputs, type, buffer));
+  }
+  return size;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct data_row *dataset_row_deserialize(const unsigned char *buffer, size_t size, enum data_entry_type type) {
+  // Check if the input params are valid.
+  if (buffer == NULL || (type != DATA_ENTRY_TYPE_INT && type != DATA_ENTRY_TYPE_DOUBLE && type != DATA_ENTRY_TYPE_STRING)) {
+    return NULL;
+  }
+  struct data_row *row = data_row_create();
+  if (row == NULL) {
+    return NULL;
+  }
+  const unsigned char *end = buffer + size;
+  row->inputs = entries_deserialize(&buffer, end, type);
+  row->outputs = row->inputs != NULL ? entries_deserialize(&buffer, end, type) : NULL;
+  if (row->outputs == NULL || buffer != end) {
+    // The data is truncated or has trailing bytes.
+    data_row_destroy(row);
+    return NULL;
+  }
+  return row;
+}
+
+/**
+ * Opens a dataset file and writes its header.
+ *
+ * @param struct dataset_file *file
+ *   The file to open.
+ * @param const char *path
+ *   The path of the file.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ * @param int64_t rows
+ *   The number of rows that will be written.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int dataset_file_open(struct dataset_file *file, const char *path, enum data_entry_type type, int64_t rows) {
+  file->scratch = NULL;
+  file->scratch_size = 0;
+  file->stream = NULL;
+  if (rows < 0 || rows > UINT32_MAX) {
+    // The number of rows is stored on 32 bits.
+    return -1;
+  }
+  file->stream = fopen(path, "wb");
+  if (file->stream == NULL) {
+    return -1;
+  }
+  // Use a large stream buffer so rows are written in big chunks.
+  setvbuf(file->stream, NULL, _IOFBF, DATASET_FILE_BUFFER_SIZE);
+  uint32_t header[4] = {DATASET_FILE_MAGIC, DATASET_FILE_VERSION, (uint32_t)type, (uint32_t)rows};
+  return fwrite(header, sizeof(header), 1, file->stream) == 1 ? 0 : -1;
+}
+
+/**
+ * Writes a row to a dataset file, prefixed by its size.
+ *
+ * @param struct dataset_file *file
+ *   The file.
+ * @param struct data_row *row
+ *   The row to write.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int dataset_file_write_row(struct dataset_file *file, struct data_row *row, enum data_entry_type type) {
+  size_t size = dataset_row_serialize(row, type, file->scratch, file->scratch_size);
+  if (size == 0 || size > UINT32_MAX) {
+    return -1;
+  }
+  if (size > file->scratch_size) {
+    // Grow the scratch buffer and serialize again.
+    size_t scratch_size = size > 2 * file->scratch_size ? size : 2 * file->scratch_size;
+    unsigned char *scratch = realloc(file->scratch, scratch_size);
+    if (scratch == NULL) {
+      return -1;
+    }
+    file->scratch = scratch;
+    file->scratch_size = scratch_size;
+    dataset_row_serialize(row, type, file->scratch, file->scratch_size);
+  }
+  uint32_t length = (uint32_t)size;
+  if (fwrite(&length, sizeof(length), 1, file->stream) != 1 || fwrite(file->scratch, size, 1, file->stream) != 1) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Flushes and closes a dataset file.
+ *
+ * @param struct dataset_file *file
+ *   The file, which may have failed to open.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the buffered rows could not be written.
+ */
+static int dataset_file_close(struct dataset_file *file) {
+  free(file->scratch);
+  file->scratch = NULL;
+  file->scratch_size = 0;
+  if (file->stream == NULL) {
+    return 0;
+  }
+  int status = fclose(file->stream);
+  file->stream = NULL;
+  return status == 0 ? 0 : -1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_save(struct dataset *data, const char *path, enum data_entry_type type) {
+  // Check if the input params are valid.
+  if (data == NULL || path == NULL) {
+    return -1;
+  }
+  struct dataset_file file;
+  int status = dataset_file_open(&file, path, type, data->size);
+  struct dataset_cursor cursor;
+  for (struct data_row *row = dataset_cursor_begin(&cursor, data); status == 0 && row != NULL; row = dataset_cursor_next(&cursor)) {
+    status = dataset_file_write_row(&file, row, type);
+  }
+  // Closing flushes the buffered rows, which can also fail.
+  if (dataset_file_close(&file) != 0) {
+    status = -1;
+  }
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_load(const char *path) {
+  // Check if the input params are valid.
+  if (path == NULL) {
+    return NULL;
+  }
+  FILE *stream = fopen(path, "rb");
+  if (stream == NULL) {
+    return NULL;
+  }
+  setvbuf(stream, NULL, _IOFBF, DATASET_FILE_BUFFER_SIZE);
+  uint32_t header[4];
+  if (fread(header, sizeof(header), 1, stream) != 1 || header[0] != DATASET_FILE_MAGIC || header[1] != DATASET_FILE_VERSION) {
+    fclose(stream);
+    return NULL;
+  }
+  enum data_entry_type type = (enum data_entry_type)header[2];
+  uint32_t rows = header[3];
+  struct dataset *data = dataset_create();
+  unsigned char *buffer = NULL;
+  size_t buffer_size = 0;
+  for (uint32_t i = 0; data != NULL && i < rows; i++) {
+    // Read the size of the row, then the row itself.
+    uint32_t length;
+    struct data_row *row = NULL;
+    if (fread(&length, sizeof(length), 1, stream) == 1) {
+      if (length > buffer_size) {
+        unsigned char *grown = realloc(buffer, length);
+        if (grown != NULL) {
+          buffer = grown;
+          buffer_size = length;
+        }
+      }
+      if (length <= buffer_size && fread(buffer, length, 1, stream) == 1) {
+        row = dataset_row_deserialize(buffer, length, type);
+      }
+    }
+    if (row == NULL || dataset_append_row(data, row) != 0) {
+      data_row_destroy(row);
+      dataset_destroy(data);
+      data = NULL;
+    }
+  }
+  free(buffer);
+  fclose(stream);
+  return data;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_save_shards(struct dataset *data, const char *path, int n_shards, enum dataset_shard_mode mode, enum data_entry_type type) {
+  // Check if the input params are valid.
+  if (data == NULL || path == NULL || n_shards <= 0) {
+    return -1;
+  }
+  size_t path_size = strlen(path) + 16;
+  char *shard_path = malloc(path_size);
+  struct dataset_file *files = calloc((size_t)n_shards, sizeof(struct dataset_file));
+  if (shard_path == NULL || files == NULL) {
+    free(shard_path);
+    free(files);
+    return -1;
+  }
+  // Open every shard file, the shard sizes are known up front.
+  int status = 0;
+  int opened = 0;
+  int64_t size = data->size;
+  for (; status == 0 && opened < n_shards; opened++) {
+    snprintf(shard_path, path_size, "%s.%d", path, opened);
+    int64_t rows = size / n_shards + (opened < size % n_shards);
+    if (mode == DATASET_SHARD_CONTIGUOUS) {
+      rows = size * (opened + 1) / n_shards - size * opened / n_shards;
+    }
+    status = dataset_file_open(&files[opened], shard_path, type, rows);
+  }
+  // Route each row to its shard in a single pass over the dataset.
+  struct dataset_cursor cursor;
+  int64_t position = 0;
+  for (struct data_row *row = dataset_cursor_begin(&cursor, data); status == 0 && row != NULL; row = dataset_cursor_next(&cursor)) {
+    status = dataset_file_write_row(&files[dataset_shard_of(position++, size, n_shards, mode)], row, type);
+  }
+  for (int i = 0; i < opened; i++) {
+    if (dataset_file_close(&files[i]) != 0) {
+      status = -1;
+    }
+  }
+  free(files);
+  free(shard_path);
+  return status;
+}
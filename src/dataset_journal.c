@@ -0,0 +1,522 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+#include "../include/dataset.h"
+
+/**
+ * Identifies the journal files ("DJNL").
+ */
+#define DATASET_JOURNAL_MAGIC 0x4C4E4A44U
+
+/**
+ * The version of the journal format.
+ */
+#define DATASET_JOURNAL_VERSION 1U
+
+/**
+ * The size of the buffer records are gathered in, and of the stream buffer used to recover them.
+ */
+#define DATASET_JOURNAL_BUFFER_SIZE (1 << 20)
+
+/**
+ * The size of the header of a record, its length followed by its checksum.
+ */
+#define DATASET_JOURNAL_RECORD_HEADER 8
+
+/**
+ * Represents the journal of a dataset.
+ */
+struct dataset_journal {
+  /**
+   * The file descriptor of the journal, opened for appending.
+   *
+   * @var int
+   */
+  int fd;
+
+  /**
+   * The type of the entries of the rows.
+   *
+   * @var enum data_entry_type
+   */
+  enum data_entry_type type;
+
+  /**
+   * The number of rows committed by each sync, and the number of rows logged since the last one.
+   *
+   * @var int
+   */
+  int group_rows;
+  int pending_rows;
+
+  /**
+   * The buffer of the records not written yet.
+   */
+  unsigned char *buffer;
+  size_t size;
+  size_t capacity;
+
+  /**
+   * Whether a write failed, after which the journal rejects every row.
+   *
+   * @var int
+   */
+  int error;
+
+  /**
+   * Serializes the rows logged by the concurrent append paths.
+   *
+   * @var pthread_mutex_t
+   */
+  pthread_mutex_t lock;
+};
+
+#ifndef __SSE4_2__
+/**
+ * The lookup table of the CRC-32C (Castagnoli) checksum.
+ */
+static uint32_t journal_crc_table[256];
+
+/**
+ * Guards the initialization of the lookup table.
+ */
+static pthread_once_t journal_crc_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Fills the lookup table of the checksum.
+ */
+static void journal_crc_init(void) {
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0x82F63B78U & (0U - (crc & 1)));
+    }
+    journal_crc_table[i] = crc;
+  }
+}
+#endif
+
+/**
+ * Updates a CRC-32C checksum with a block of bytes.
+ *
+ * The checksum is computed with the crc32 instruction when SSE 4.2 is available,
+ * and with a lookup table otherwise.
+ *
+ * @param uint32_t crc
+ *   The checksum of the previous bytes, without the final inversion.
+ * @param const unsigned char *bytes
+ *   The bytes.
+ * @param size_t size
+ *   The number of bytes.
+ *
+ * @return uint32_t
+ *   The updated checksum.
+ */
+static uint32_t journal_crc(uint32_t crc, const unsigned char *bytes, size_t size) {
+#ifdef __SSE4_2__
+  uint64_t wide = crc;
+  for (; size >= 8; bytes += 8, size -= 8) {
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+    wide = _mm_crc32_u64(wide, word);
+  }
+  crc = (uint32_t)wide;
+  for (; size > 0; bytes++, size--) {
+    crc = _mm_crc32_u8(crc, *bytes);
+  }
+#else
+  pthread_once(&journal_crc_once, journal_crc_init);
+  for (; size > 0; bytes++, size--) {
+    crc = journal_crc_table[(crc ^ *bytes) & 0xff] ^ (crc >> 8);
+  }
+#endif
+  return crc;
+}
+
+/**
+ * Computes the checksum of a record, covering its length and its payload.
+ *
+ * @param uint32_t length
+ *   The length of the payload.
+ * @param const unsigned char *payload
+ *   The payload.
+ *
+ * @return uint32_t
+ *   The checksum.
+ */
+static uint32_t journal_record_crc(uint32_t length, const unsigned char *payload) {
+  uint32_t crc = journal_crc(0xFFFFFFFFU, (const unsigned char *)&length, sizeof(length));
+  return ~journal_crc(crc, payload, length);
+}
+
+/**
+ * Writes a block of bytes to a file descriptor, resuming partial writes.
+ *
+ * @param int fd
+ *   The file descriptor.
+ * @param const unsigned char *bytes
+ *   The bytes.
+ * @param size_t size
+ *   The number of bytes.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int journal_write_all(int fd, const unsigned char *bytes, size_t size) {
+  while (size > 0) {
+    ssize_t written = write(fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    bytes += written;
+    size -= (size_t)written;
+  }
+  return 0;
+}
+
+/**
+ * Writes the buffered records of a journal, without syncing the file.
+ *
+ * @param struct dataset_journal *journal
+ *   The journal.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int journal_flush(struct dataset_journal *journal) {
+  if (!journal->error && journal_write_all(journal->fd, journal->buffer, journal->size) != 0) {
+    journal->error = 1;
+  }
+  journal->size = 0;
+  return journal->error ? -1 : 0;
+}
+
+/**
+ * Writes the buffered records of a journal and syncs the file.
+ *
+ * @param struct dataset_journal *journal
+ *   The journal.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int journal_commit(struct dataset_journal *journal) {
+  if (journal_flush(journal) != 0) {
+    return -1;
+  }
+  if (fdatasync(journal->fd) != 0) {
+    journal->error = 1;
+    return -1;
+  }
+  journal->pending_rows = 0;
+  return 0;
+}
+
+/**
+ * Checks whether the records of a journal can hold entries of a type.
+ *
+ * @param uint32_t type
+ *   The type of the entries.
+ *
+ * @return int
+ *   1 if the type is supported by the row serialization, 0 otherwise.
+ */
+static int journal_type_supported(uint32_t type) {
+  return type == DATA_ENTRY_TYPE_INT || type == DATA_ENTRY_TYPE_DOUBLE || type == DATA_ENTRY_TYPE_STRING;
+}
+
+/**
+ * Reads the valid records of a journal.
+ *
+ * @param const char *path
+ *   The path of the journal.
+ * @param struct dataset *data
+ *   The dataset the rows are appended to, or NULL to only validate the records.
+ * @param enum data_entry_type *type
+ *   Receives the type of the entries of the journal.
+ * @param off_t *end
+ *   Receives the offset following the last valid record.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the file can not be read or is not a journal.
+ */
+static int journal_scan(const char *path, struct dataset *data, enum data_entry_type *type, off_t *end) {
+  FILE *stream = fopen(path, "rb");
+  if (stream == NULL) {
+    return -1;
+  }
+  setvbuf(stream, NULL, _IOFBF, DATASET_JOURNAL_BUFFER_SIZE);
+  // The file size bounds the length of the records, so a corrupted length is not allocated.
+  struct stat status;
+  uint32_t header[3];
+  if (fstat(fileno(stream), &status) != 0 || fread(header, sizeof(header), 1, stream) != 1 || header[0] != DATASET_JOURNAL_MAGIC || header[1] != DATASET_JOURNAL_VERSION || !journal_type_supported(header[2])) {
+    fclose(stream);
+    return -1;
+  }
+  *type = (enum data_entry_type)header[2];
+  off_t offset = (off_t)sizeof(header);
+  unsigned char *buffer = NULL;
+  size_t buffer_size = 0;
+  uint32_t record[2];
+  while (fread(record, sizeof(record), 1, stream) == 1) {
+    uint32_t length = record[0];
+    if (length == 0 || (off_t)length > status.st_size - offset - DATASET_JOURNAL_RECORD_HEADER) {
+      break;
+    }
+    if (length > buffer_size) {
+      unsigned char *grown = realloc(buffer, length);
+      if (grown == NULL) {
+        break;
+      }
+      buffer = grown;
+      buffer_size = length;
+    }
+    if (fread(buffer, length, 1, stream) != 1 || journal_record_crc(length, buffer) != record[1]) {
+      break;
+    }
+    if (data != NULL) {
+      struct data_row *row = dataset_row_deserialize(buffer, length, *type);
+      if (row == NULL || dataset_append_row(data, row) != 0) {
+        data_row_destroy(row);
+        break;
+      }
+    }
+    offset += DATASET_JOURNAL_RECORD_HEADER + (off_t)length;
+  }
+  *end = offset;
+  free(buffer);
+  fclose(stream);
+  return 0;
+}
+
+/**
+ * Syncs the directory of a file, so a newly created file survives a crash.
+ *
+ * @param const char *path
+ *   The path of the file.
+ */
+static void journal_sync_directory(const char *path) {
+  const char *slash = strrchr(path, '/');
+  char *directory = slash == NULL ? strdup(".") : strndup(path, slash == path ? 1 : (size_t)(slash - path));
+  if (directory == NULL) {
+    return;
+  }
+  int fd = open(directory, O_RDONLY | O_DIRECTORY);
+  if (fd >= 0) {
+    fsync(fd);
+    close(fd);
+  }
+  free(directory);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_journal_open(struct dataset *data, const char *path, enum data_entry_type type, int group_rows) {
+  // Check if the input params are valid.
+  if (data == NULL || path == NULL || data->journal != NULL || group_rows < 1 || !journal_type_supported((uint32_t)type)) {
+    return -1;
+  }
+  int fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+  struct stat status;
+  if (fd < 0 || fstat(fd, &status) != 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    return -1;
+  }
+  int failed = 0;
+  if (status.st_size == 0) {
+    // Start a new journal.
+    uint32_t header[3] = {DATASET_JOURNAL_MAGIC, DATASET_JOURNAL_VERSION, (uint32_t)type};
+    failed = journal_write_all(fd, (const unsigned char *)header, sizeof(header)) != 0 || fdatasync(fd) != 0;
+    if (!failed) {
+      journal_sync_directory(path);
+    }
+  } else {
+    // Drop the torn record a crash may have left, and append after the valid ones.
+    enum data_entry_type journal_type;
+    off_t end;
+    failed = journal_scan(path, NULL, &journal_type, &end) != 0 || journal_type != type;
+    if (!failed && end < status.st_size) {
+      failed = ftruncate(fd, end) != 0 || fdatasync(fd) != 0;
+    }
+  }
+  struct dataset_journal *journal = failed ? NULL : malloc(sizeof(struct dataset_journal));
+  unsigned char *buffer = journal == NULL ? NULL : malloc(DATASET_JOURNAL_BUFFER_SIZE);
+  if (buffer == NULL || pthread_mutex_init(&journal->lock, NULL) != 0) {
+    free(buffer);
+    free(journal);
+    close(fd);
+    return -1;
+  }
+  journal->fd = fd;
+  journal->type = type;
+  journal->group_rows = group_rows;
+  journal->pending_rows = 0;
+  journal->buffer = buffer;
+  journal->size = 0;
+  journal->capacity = DATASET_JOURNAL_BUFFER_SIZE;
+  journal->error = 0;
+  data->journal = journal;
+  return 0;
+}
+
+/**
+ * Logs a row to a journal, the lock of the journal being held.
+ *
+ * @param struct dataset_journal *journal
+ *   The journal.
+ * @param struct data_row *row
+ *   The row.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int journal_write_row(struct dataset_journal *journal, struct data_row *row) {
+  if (journal->error) {
+    return -1;
+  }
+  // Serialize the row straight into the buffer, after the header of its record.
+  size_t length;
+  for (;;) {
+    size_t room = journal->capacity - journal->size;
+    unsigned char *payload = room > DATASET_JOURNAL_RECORD_HEADER ? journal->buffer + journal->size + DATASET_JOURNAL_RECORD_HEADER : NULL;
+    length = dataset_row_serialize(row, journal->type, payload, payload == NULL ? 0 : room - DATASET_JOURNAL_RECORD_HEADER);
+    if (length == 0 || length > UINT32_MAX - DATASET_JOURNAL_RECORD_HEADER) {
+      return -1;
+    }
+    if (length + DATASET_JOURNAL_RECORD_HEADER <= room) {
+      break;
+    }
+    if (journal->size > 0) {
+      // Make room by writing the buffered records.
+      if (journal_flush(journal) != 0) {
+        return -1;
+      }
+      continue;
+    }
+    // The row does not fit in an empty buffer, grow it.
+    unsigned char *grown = realloc(journal->buffer, length + DATASET_JOURNAL_RECORD_HEADER);
+    if (grown == NULL) {
+      return -1;
+    }
+    journal->buffer = grown;
+    journal->capacity = length + DATASET_JOURNAL_RECORD_HEADER;
+  }
+  unsigned char *record = journal->buffer + journal->size;
+  uint32_t header[2] = {(uint32_t)length, journal_record_crc((uint32_t)length, record + DATASET_JOURNAL_RECORD_HEADER)};
+  memcpy(record, header, sizeof(header));
+  journal->size += DATASET_JOURNAL_RECORD_HEADER + length;
+  // Commit once the group is complete.
+  if (++journal->pending_rows >= journal->group_rows) {
+    return journal_commit(journal);
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_journal_write_row(struct dataset_journal *journal, struct data_row *row) {
+  // Check if the input params are valid.
+  if (journal == NULL || row == NULL) {
+    return -1;
+  }
+  pthread_mutex_lock(&journal->lock);
+  int status = journal_write_row(journal, row);
+  pthread_mutex_unlock(&journal->lock);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_journal_write_rows(struct dataset_journal *journal, struct data_row *first) {
+  // Check if the input params are valid.
+  if (journal == NULL) {
+    return -1;
+  }
+  pthread_mutex_lock(&journal->lock);
+  int status = journal->error ? -1 : 0;
+  // Measure every row first, so a row that can not be serialized rejects the
+  // chain before any record is written.
+  for (struct data_row *row = first; status == 0 && row != NULL; row = row->next) {
+    size_t length = dataset_row_serialize(row, journal->type, NULL, 0);
+    if (length == 0 || length > UINT32_MAX - DATASET_JOURNAL_RECORD_HEADER) {
+      status = -1;
+    }
+  }
+  for (struct data_row *row = first; status == 0 && row != NULL; row = row->next) {
+    if (journal_write_row(journal, row) != 0) {
+      // Part of the chain may be in the file, latch the error.
+      journal->error = 1;
+      status = -1;
+    }
+  }
+  pthread_mutex_unlock(&journal->lock);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_journal_commit(struct dataset *data) {
+  if (data == NULL || data->journal == NULL) {
+    return -1;
+  }
+  pthread_mutex_lock(&data->journal->lock);
+  int status = journal_commit(data->journal);
+  pthread_mutex_unlock(&data->journal->lock);
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_journal_close(struct dataset *data) {
+  if (data == NULL || data->journal == NULL) {
+    // No action needed without a journal.
+    return 0;
+  }
+  struct dataset_journal *journal = data->journal;
+  int status = journal_commit(journal);
+  if (close(journal->fd) != 0) {
+    status = -1;
+  }
+  pthread_mutex_destroy(&journal->lock);
+  free(journal->buffer);
+  free(journal);
+  data->journal = NULL;
+  return status;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_recover(const char *path) {
+  // Check if the input params are valid.
+  if (path == NULL) {
+    return NULL;
+  }
+  struct dataset *data = dataset_create();
+  enum data_entry_type type;
+  off_t end;
+  if (data != NULL && journal_scan(path, data, &type, &end) != 0) {
+    dataset_destroy(data);
+    return NULL;
+  }
+  return data;
+}
@@ -0,0 +1,372 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/dataset.h"
+#include "dataset_internal.h"
+
+/**
+ * Represents a known string of a label encoder, its id being its index.
+ */
+struct label_slot {
+  /**
+   * The hash of the string, kept to grow the index without hashing again.
+   *
+   * @var uint64_t
+   */
+  uint64_t hash;
+
+  /**
+   * The offset of the string in the arena of the encoder.
+   *
+   * @var size_t
+   */
+  size_t offset;
+
+  /**
+   * The number of bytes of the string, without the terminator.
+   *
+   * @var size_t
+   */
+  size_t length;
+};
+
+/**
+ * Represents a mapping of whole strings to integer ids.
+ */
+struct dataset_label_encoder {
+  /**
+   * The known strings, indexed by id.
+   *
+   * @var struct label_slot *
+   */
+  struct label_slot *slots;
+
+  /**
+   * The number of known strings, and the number of slots allocated.
+   *
+   * @var int
+   */
+  int size;
+  int capacity;
+
+  /**
+   * The null-terminated strings, stored one after the other.
+   */
+  char *arena;
+  size_t arena_size;
+  size_t arena_capacity;
+
+  /**
+   * Open addressing table of ids, -1 for an empty position.
+   *
+   * @var int *
+   */
+  int *index;
+
+  /**
+   * The number of positions of the index, a power of two.
+   *
+   * @var int
+   */
+  int index_capacity;
+
+  /**
+   * Whether the unseen strings are no longer added, and whether they are then
+   * encoded as the extra id `size`.
+   *
+   * @var int
+   */
+  int frozen;
+  int unknown;
+};
+
+/**
+ * Hashes a null-terminated string, measuring it first.
+ *
+ * @param const char *label
+ *   The string.
+ * @param size_t *length
+ *   Receives the number of bytes of the string.
+ *
+ * @return uint64_t
+ *   The hash of the string.
+ */
+static uint64_t label_hash(const char *label, size_t *length) {
+  *length = strlen(label);
+  return dataset_hash_bytes(label, *length);
+}
+
+/**
+ * Finds the position of a string in the index.
+ *
+ * @param struct dataset_label_encoder *encoder
+ *   The encoder.
+ * @param const char *label
+ *   The string.
+ * @param size_t length
+ *   The number of bytes of the string.
+ * @param uint64_t hash
+ *   The hash of the string.
+ *
+ * @return int
+ *   The position holding the string, or the empty position where it would be inserted.
+ */
+static int label_find(struct dataset_label_encoder *encoder, const char *label, size_t length, uint64_t hash) {
+  int mask = encoder->index_capacity - 1;
+  int position = (int)(hash & (uint64_t)mask);
+  while (encoder->index[position] >= 0) {
+    // Compare the stored hashes first, the strings only when they match.
+    struct label_slot *slot = &encoder->slots[encoder->index[position]];
+    if (slot->hash == hash && slot->length == length && memcmp(encoder->arena + slot->offset, label, length) == 0) {
+      break;
+    }
+    position = (position + 1) & mask;
+  }
+  return position;
+}
+
+/**
+ * Doubles the index of an encoder, placing the known strings with their stored hashes.
+ *
+ * @param struct dataset_label_encoder *encoder
+ *   The encoder.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int label_grow_index(struct dataset_label_encoder *encoder) {
+  if (encoder->index_capacity > INT32_MAX / 2) {
+    return -1;
+  }
+  int capacity = encoder->index_capacity * 2;
+  int *index = malloc((size_t)capacity * sizeof(int));
+  if (index == NULL) {
+    return -1;
+  }
+  memset(index, -1, (size_t)capacity * sizeof(int));
+  int mask = capacity - 1;
+  for (int id = 0; id < encoder->size; id++) {
+    int position = (int)(encoder->slots[id].hash & (uint64_t)mask);
+    while (index[position] >= 0) {
+      position = (position + 1) & mask;
+    }
+    index[position] = id;
+  }
+  free(encoder->index);
+  encoder->index = index;
+  encoder->index_capacity = capacity;
+  return 0;
+}
+
+/**
+ * Adds a string to an encoder.
+ *
+ * @param struct dataset_label_encoder *encoder
+ *   The encoder.
+ * @param const char *label
+ *   The string.
+ * @param size_t length
+ *   The number of bytes of the string.
+ * @param uint64_t hash
+ *   The hash of the string.
+ * @param int position
+ *   The empty position of the index returned by `label_find`.
+ *
+ * @return int
+ *   The id of the string, or -1 on failure.
+ */
+static int label_add(struct dataset_label_encoder *encoder, const char *label, size_t length, uint64_t hash, int position) {
+  if (encoder->size >= INT32_MAX / 2 - 1) {
+    // Bound the ids so the index fits in an int, keeping room for the id of the unseen strings.
+    return -1;
+  }
+  // Keep the index at most half full, the position moves when it grows.
+  if ((encoder->size + 1) * 2 > encoder->index_capacity) {
+    if (label_grow_index(encoder) != 0) {
+      return -1;
+    }
+    position = label_find(encoder, label, length, hash);
+  }
+  if (encoder->size == encoder->capacity) {
+    int capacity = encoder->capacity * 2;
+    struct label_slot *slots = realloc(encoder->slots, (size_t)capacity * sizeof(struct label_slot));
+    if (slots == NULL) {
+      return -1;
+    }
+    encoder->slots = slots;
+    encoder->capacity = capacity;
+  }
+  if (length >= encoder->arena_capacity - encoder->arena_size) {
+    size_t needed = encoder->arena_size + length + 1;
+    if (needed <= encoder->arena_size) {
+      return -1;
+    }
+    size_t capacity = encoder->arena_capacity * 2 > needed ? encoder->arena_capacity * 2 : needed;
+    char *arena = realloc(encoder->arena, capacity);
+    if (arena == NULL) {
+      return -1;
+    }
+    encoder->arena = arena;
+    encoder->arena_capacity = capacity;
+  }
+  int id = encoder->size++;
+  struct label_slot *slot = &encoder->slots[id];
+  slot->hash = hash;
+  slot->offset = encoder->arena_size;
+  slot->length = length;
+  memcpy(encoder->arena + encoder->arena_size, label, length + 1);
+  encoder->arena_size += length + 1;
+  encoder->index[position] = id;
+  return id;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_label_encoder *dataset_label_encoder_create() {
+  // Allocate memory for the encoder structure.
+  struct dataset_label_encoder *encoder = calloc(1, sizeof(struct dataset_label_encoder));
+  if (encoder == NULL) {
+    // Memory allocation failed.
+    return NULL;
+  }
+  encoder->capacity = 64;
+  encoder->arena_capacity = 1024;
+  encoder->index_capacity = 128;
+  encoder->slots = malloc((size_t)encoder->capacity * sizeof(struct label_slot));
+  encoder->arena = malloc(encoder->arena_capacity);
+  encoder->index = malloc((size_t)encoder->index_capacity * sizeof(int));
+  if (encoder->slots == NULL || encoder->arena == NULL || encoder->index == NULL) {
+    dataset_label_encoder_destroy(encoder);
+    return NULL;
+  }
+  memset(encoder->index, -1, (size_t)encoder->index_capacity * sizeof(int));
+  // Return the newly created encoder.
+  return encoder;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_label_encoder_destroy(struct dataset_label_encoder *encoder) {
+  if (encoder == NULL) {
+    // No action needed if encoder is NULL.
+    return;
+  }
+  free(encoder->slots);
+  free(encoder->arena);
+  free(encoder->index);
+  free(encoder);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_label_encoder_freeze(struct dataset_label_encoder *encoder, int unknown) {
+  if (encoder == NULL) {
+    return;
+  }
+  encoder->frozen = 1;
+  encoder->unknown = unknown != 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_label_encoder_get_size(struct dataset_label_encoder *encoder) {
+  if (encoder == NULL) {
+    return 0;
+  }
+  return encoder->size + (encoder->frozen && encoder->unknown);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_label_encoder_get_id(struct dataset_label_encoder *encoder, const char *label) {
+  // Check if the input params are valid.
+  if (encoder == NULL || label == NULL) {
+    return -1;
+  }
+  size_t length;
+  uint64_t hash = label_hash(label, &length);
+  int position = label_find(encoder, label, length, hash);
+  if (encoder->index[position] >= 0) {
+    return encoder->index[position];
+  }
+  if (encoder->frozen) {
+    return encoder->unknown ? encoder->size : -1;
+  }
+  return label_add(encoder, label, length, hash, position);
+}
+
+/**
+ * {@inheritdoc}
+ */
+const char *dataset_label_encoder_get_label(struct dataset_label_encoder *encoder, int id) {
+  if (encoder == NULL || id < 0 || id >= encoder->size) {
+    return NULL;
+  }
+  return encoder->arena + encoder->slots[id].offset;
+}
+
+/**
+ * Encodes a collection of string entries as the ids of the strings.
+ *
+ * @param struct data_entries *entries
+ *   The string entries.
+ * @param struct dataset_label_encoder *encoder
+ *   The encoder.
+ *
+ * @return struct data_entries*
+ *   The integer entries, or NULL on failure.
+ */
+static struct data_entries *label_encode_entries(struct data_entries *entries, struct dataset_label_encoder *encoder) {
+  if (entries == NULL) {
+    return NULL;
+  }
+  struct data_entries *encoded = data_entries_create(entries->size);
+  if (encoded == NULL) {
+    return NULL;
+  }
+  for (int64_t i = 0; i < entries->size; i++) {
+    struct data_entry *entry = entries->entries[i];
+    int id = entry == NULL ? -1 : dataset_label_encoder_get_id(encoder, (const char *)entry->data);
+    encoded->entries[i] = id < 0 ? NULL : data_entry_create_int(id);
+    if (encoded->entries[i] == NULL) {
+      data_entries_destroy(encoded);
+      return NULL;
+    }
+  }
+  return encoded;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_label_encode(struct dataset *string_dataset, struct dataset_label_encoder *encoder) {
+  // Check if the input params are valid.
+  if (string_dataset == NULL || encoder == NULL) {
+    return NULL;
+  }
+  // Create a new dataset to hold the encoded rows.
+  struct dataset *encoded_dataset = dataset_create();
+  if (encoded_dataset == NULL) {
+    return NULL;
+  }
+  struct dataset_cursor cursor;
+  for (struct data_row *current = dataset_cursor_begin(&cursor, string_dataset); current != NULL; current = dataset_cursor_next(&cursor)) {
+    struct data_row *encoded_row = data_row_create();
+    if (encoded_row != NULL) {
+      encoded_row->inputs = label_encode_entries(current->inputs, encoder);
+      encoded_row->outputs = encoded_row->inputs == NULL ? NULL : label_encode_entries(current->outputs, encoder);
+    }
+    if (encoded_row == NULL || encoded_row->outputs == NULL || dataset_append_row(encoded_dataset, encoded_row) != 0) {
+      data_row_destroy(encoded_row);
+      dataset_destroy(encoded_dataset);
+      return NULL;
+    }
+  }
+  // Return the new dataset containing the encoded rows.
+  return encoded_dataset;
+}
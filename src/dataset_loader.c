@@ -0,0 +1,350 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include "../include/dataset.h"
+
+/**
+ * The states a batch buffer of the loader goes through.
+ */
+enum loader_slot_state {
+  LOADER_SLOT_FREE,
+  LOADER_SLOT_FILLING,
+  LOADER_SLOT_READY,
+  LOADER_SLOT_IN_USE,
+};
+
+/**
+ * Represents one of the preallocated batch buffers of the ring.
+ */
+struct loader_slot {
+  /**
+   * The batch stored in this buffer.
+   *
+   * @var struct dataset_batch *
+   */
+  struct dataset_batch *batch;
+
+  /**
+   * The current state of the buffer.
+   *
+   * @var enum loader_slot_state
+   */
+  enum loader_slot_state state;
+
+  /**
+   * The sequence number of the next batch allowed to fill this buffer.
+   *
+   * @var int
+   */
+  int sequence;
+
+  /**
+   * Whether the batch stored in this buffer failed to be gathered.
+   *
+   * @var int
+   */
+  int failed;
+};
+
+/**
+ * Represents a background batch loader.
+ */
+struct dataset_loader {
+  /**
+   * The view of the rows to load, indexed for random access.
+   *
+   * @var const struct dataset_view *
+   */
+  const struct dataset_view *view;
+
+  /**
+   * The view created by the loader itself, freed with it, or NULL.
+   *
+   * @var struct dataset_view *
+   */
+  struct dataset_view *owned_view;
+
+  /**
+   * The number of rows per batch.
+   *
+   * @var int
+   */
+  int batch_size;
+
+  /**
+   * The total number of batches of the epoch.
+   *
+   * @var int
+   */
+  int batches;
+
+  /**
+   * The layouts used to encode the inputs and the outputs.
+   *
+   * @var struct dataset_batch_layout
+   */
+  struct dataset_batch_layout input_layout;
+  struct dataset_batch_layout output_layout;
+
+  /**
+   * The ring of batch buffers.
+   *
+   * @var struct loader_slot *
+   */
+  struct loader_slot *slots;
+
+  /**
+   * The number of batch buffers of the ring.
+   *
+   * @var int
+   */
+  int slots_size;
+
+  /**
+   * The sequence number of the next batch to fill and to consume.
+   *
+   * @var int
+   */
+  int next_fill;
+  int next_consume;
+
+  /**
+   * Whether the worker threads must stop.
+   *
+   * @var int
+   */
+  int stopping;
+
+  /**
+   * Whether a batch failed to be gathered, which ends the epoch for the consumer.
+   *
+   * @var int
+   */
+  int failed;
+
+  /**
+   * The worker threads.
+   *
+   * @var pthread_t *
+   */
+  pthread_t *threads;
+
+  /**
+   * The number of worker threads started.
+   *
+   * @var int
+   */
+  int threads_size;
+
+  /**
+   * Synchronization of the ring.
+   */
+  pthread_mutex_t mutex;
+  pthread_cond_t slot_free;
+  pthread_cond_t slot_ready;
+};
+
+/**
+ * Entry point of the worker threads of a loader.
+ *
+ * Each worker claims the next batch sequence number, waits until the buffer of
+ * that batch has been released by the consumer, and fills it outside the lock.
+ *
+ * @param void *argument
+ *   The loader.
+ *
+ * @return void*
+ *   Always NULL.
+ */
+static void *loader_worker(void *argument) {
+  struct dataset_loader *loader = argument;
+  pthread_mutex_lock(&loader->mutex);
+  while (!loader->stopping && loader->next_fill < loader->batches) {
+    // Claim the next batch.
+    int sequence = loader->next_fill++;
+    struct loader_slot *slot = &loader->slots[sequence % loader->slots_size];
+    // Back-pressure: wait until the consumer released the previous batch of the buffer.
+    while (!loader->stopping && (slot->state != LOADER_SLOT_FREE || slot->sequence != sequence)) {
+      pthread_cond_wait(&loader->slot_free, &loader->mutex);
+    }
+    if (loader->stopping) {
+      break;
+    }
+    slot->state = LOADER_SLOT_FILLING;
+    pthread_mutex_unlock(&loader->mutex);
+    // Gather and encode the rows of the batch.
+    int first = sequence * loader->batch_size;
+    int count = loader->view->size - first < loader->batch_size ? loader->view->size - first : loader->batch_size;
+    int failed = dataset_batch_gather_view(slot->batch, loader->view, first, count, &loader->input_layout, &loader->output_layout) != 0;
+    slot->batch->index = sequence;
+    pthread_mutex_lock(&loader->mutex);
+    // Publish the batch, or its failure, to the consumer.
+    slot->failed = failed;
+    slot->state = LOADER_SLOT_READY;
+    pthread_cond_broadcast(&loader->slot_ready);
+  }
+  pthread_mutex_unlock(&loader->mutex);
+  return NULL;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_loader *dataset_loader_create(struct dataset *data, int batch_size, int buffers, int threads, const struct dataset_batch_layout *input_layout, const struct dataset_batch_layout *output_layout) {
+  // Check if the input params are valid.
+  if (data == NULL) {
+    return NULL;
+  }
+  // Index the rows of the dataset in a view owned by the loader.
+  struct dataset_view *view = dataset_view_from_dataset(data);
+  if (view == NULL) {
+    return NULL;
+  }
+  struct dataset_loader *loader = dataset_loader_create_view(view, batch_size, buffers, threads, input_layout, output_layout);
+  if (loader == NULL) {
+    dataset_view_destroy(view);
+    return NULL;
+  }
+  loader->owned_view = view;
+  // Return the newly created loader.
+  return loader;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_loader *dataset_loader_create_view(const struct dataset_view *view, int batch_size, int buffers, int threads, const struct dataset_batch_layout *input_layout, const struct dataset_batch_layout *output_layout) {
+  // Check if the input params are valid.
+  if (view == NULL || batch_size <= 0 || buffers < 1 || threads < 1) {
+    return NULL;
+  }
+  int input_width = dataset_batch_layout_width(input_layout);
+  int output_width = dataset_batch_layout_width(output_layout);
+  if (input_width < 0 || output_width < 0) {
+    return NULL;
+  }
+  // Allocate memory for the loader structure.
+  struct dataset_loader *loader = calloc(1, sizeof(struct dataset_loader));
+  if (loader == NULL) {
+    // Memory allocation failed.
+    return NULL;
+  }
+  loader->batch_size = batch_size;
+  loader->input_layout = *input_layout;
+  loader->output_layout = *output_layout;
+  pthread_mutex_init(&loader->mutex, NULL);
+  pthread_cond_init(&loader->slot_free, NULL);
+  pthread_cond_init(&loader->slot_ready, NULL);
+  loader->view = view;
+  loader->batches = (view->size + batch_size - 1) / batch_size;
+  // Preallocate the ring of batches.
+  loader->slots = calloc(buffers, sizeof(struct loader_slot));
+  if (loader->slots == NULL) {
+    dataset_loader_destroy(loader);
+    return NULL;
+  }
+  loader->slots_size = buffers;
+  for (int i = 0; i < buffers; i++) {
+    loader->slots[i].batch = dataset_batch_create(batch_size, input_width, output_width);
+    loader->slots[i].state = LOADER_SLOT_FREE;
+    loader->slots[i].sequence = i;
+    if (loader->slots[i].batch == NULL) {
+      dataset_loader_destroy(loader);
+      return NULL;
+    }
+  }
+  // Start the worker threads.
+  loader->threads = malloc((size_t)threads * sizeof(pthread_t));
+  if (loader->threads == NULL) {
+    dataset_loader_destroy(loader);
+    return NULL;
+  }
+  for (int i = 0; i < threads; i++) {
+    if (pthread_create(&loader->threads[i], NULL, loader_worker, loader) != 0) {
+      dataset_loader_destroy(loader);
+      return NULL;
+    }
+    loader->threads_size++;
+  }
+  // Return the newly created loader.
+  return loader;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_batch *dataset_loader_next_batch(struct dataset_loader *loader) {
+  if (loader == NULL) {
+    return NULL;
+  }
+  pthread_mutex_lock(&loader->mutex);
+  if (loader->failed || loader->next_consume >= loader->batches) {
+    // Every batch of the epoch was returned, or one of them failed.
+    pthread_mutex_unlock(&loader->mutex);
+    return NULL;
+  }
+  // Wait until the worker finished filling the next batch in order.
+  int sequence = loader->next_consume;
+  struct loader_slot *slot = &loader->slots[sequence % loader->slots_size];
+  while (!loader->stopping && (slot->state != LOADER_SLOT_READY || slot->sequence != sequence)) {
+    pthread_cond_wait(&loader->slot_ready, &loader->mutex);
+  }
+  if (loader->stopping || slot->failed) {
+    loader->failed = 1;
+    pthread_mutex_unlock(&loader->mutex);
+    return NULL;
+  }
+  slot->state = LOADER_SLOT_IN_USE;
+  loader->next_consume++;
+  pthread_mutex_unlock(&loader->mutex);
+  return slot->batch;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_loader_release_batch(struct dataset_loader *loader, struct dataset_batch *batch) {
+  if (loader == NULL || batch == NULL || batch->index < 0) {
+    return;
+  }
+  pthread_mutex_lock(&loader->mutex);
+  struct loader_slot *slot = &loader->slots[batch->index % loader->slots_size];
+  if (slot->batch == batch && slot->state == LOADER_SLOT_IN_USE) {
+    // Hand the buffer over to the batch that follows in the ring.
+    slot->sequence += loader->slots_size;
+    slot->state = LOADER_SLOT_FREE;
+    pthread_cond_broadcast(&loader->slot_free);
+  }
+  pthread_mutex_unlock(&loader->mutex);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_loader_destroy(struct dataset_loader *loader) {
+  if (loader == NULL) {
+    // No action needed if loader is NULL.
+    return;
+  }
+  // Wake up and join the worker threads.
+  pthread_mutex_lock(&loader->mutex);
+  loader->stopping = 1;
+  pthread_cond_broadcast(&loader->slot_free);
+  pthread_cond_broadcast(&loader->slot_ready);
+  pthread_mutex_unlock(&loader->mutex);
+  for (int i = 0; i < loader->threads_size; i++) {
+    pthread_join(loader->threads[i], NULL);
+  }
+  // Free the batches and the loader itself.
+  if (loader->slots != NULL) {
+    for (int i = 0; i < loader->slots_size; i++) {
+      dataset_batch_destroy(loader->slots[i].batch);
+    }
+  }
+  pthread_mutex_destroy(&loader->mutex);
+  pthread_cond_destroy(&loader->slot_free);
+  pthread_cond_destroy(&loader->slot_ready);
+  free(loader->threads);
+  free(loader->slots);
+  dataset_view_destroy(loader->owned_view);
+  free(loader);
+}
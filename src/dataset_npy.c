@@ -0,0 +1,290 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <matrixmath.h>
+#include "../include/dataset.h"
+
+/**
+ * The size of the buffer the small values are gathered into.
+ */
+#define NPY_BUFFER_SIZE (1 << 20)
+
+/**
+ * The maximum number of segments written by a single `writev` call.
+ */
+#define NPY_SEGMENTS 512
+
+/**
+ * The size from which vectors are written from their own elements instead of being copied.
+ */
+#define NPY_DIRECT_SIZE 4096
+
+/**
+ * Represents a file being written with vectored writes.
+ */
+struct npy_writer {
+  /**
+   * The file descriptor.
+   *
+   * @var int
+   */
+  int fd;
+
+  /**
+   * The buffer the small values are copied into, and the number of bytes used.
+   */
+  unsigned char *buffer;
+  size_t used;
+
+  /**
+   * The segments waiting to be written, pointing into the buffer or into vectors.
+   */
+  struct iovec segments[NPY_SEGMENTS];
+  int segments_size;
+};
+
+/**
+ * Writes every pending segment and empties the buffer.
+ *
+ * @param struct npy_writer *writer
+ *   The writer.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int npy_flush(struct npy_writer *writer) {
+  struct iovec *segments = writer->segments;
+  int remaining = writer->segments_size;
+  while (remaining > 0) {
+    ssize_t written = writev(writer->fd, segments, remaining);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    // Skip the segments that were fully written, then the written part of the next one.
+    while (remaining > 0 && (size_t)written >= segments->iov_len) {
+      written -= (ssize_t)segments->iov_len;
+      segments++;
+      remaining--;
+    }
+    if (remaining > 0) {
+      segments->iov_base = (unsigned char *)segments->iov_base + written;
+      segments->iov_len -= (size_t)written;
+    }
+  }
+  writer->segments_size = 0;
+  writer->used = 0;
+  return 0;
+}
+
+/**
+ * Queues bytes that remain valid until the next flush, without copying them.
+ *
+ * @param struct npy_writer *writer
+ *   The writer.
+ * @param const void *bytes
+ *   The bytes to write.
+ * @param size_t size
+ *   The number of bytes.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int npy_write_direct(struct npy_writer *writer, const void *bytes, size_t size) {
+  if (writer->segments_size == NPY_SEGMENTS && npy_flush(writer) != 0) {
+    return -1;
+  }
+  writer->segments[writer->segments_size].iov_base = (void *)bytes;
+  writer->segments[writer->segments_size].iov_len = size;
+  writer->segments_size++;
+  return 0;
+}
+
+/**
+ * Copies bytes into the buffer of the writer.
+ *
+ * @param struct npy_writer *writer
+ *   The writer.
+ * @param const void *bytes
+ *   The bytes to write.
+ * @param size_t size
+ *   The number of bytes, no greater than the size of the buffer.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int npy_write(struct npy_writer *writer, const void *bytes, size_t size) {
+  // Flush before copying when the bytes may need a new segment, since flushing empties the buffer.
+  if ((writer->used + size > NPY_BUFFER_SIZE || writer->segments_size == NPY_SEGMENTS) && npy_flush(writer) != 0) {
+    return -1;
+  }
+  unsigned char *destination = writer->buffer + writer->used;
+  memcpy(destination, bytes, size);
+  writer->used += size;
+  // Extend the last segment when it ends where the bytes were copied.
+  struct iovec *last = writer->segments_size > 0 ? &writer->segments[writer->segments_size - 1] : NULL;
+  if (last != NULL && (unsigned char *)last->iov_base + last->iov_len == destination) {
+    last->iov_len += size;
+    return 0;
+  }
+  return npy_write_direct(writer, destination, size);
+}
+
+/**
+ * Gets the number of values a collection of entries produces.
+ *
+ * @param struct data_entries *entries
+ *   The data entries, may be NULL.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ *
+ * @return long long
+ *   The number of values, or -1 if an entry is missing.
+ */
+static long long npy_row_width(struct data_entries *entries, enum data_entry_type type) {
+  if (entries == NULL) {
+    return 0;
+  }
+  long long width = 0;
+  for (int64_t i = 0; i < entries->size; i++) {
+    struct data_entry *entry = entries->entries[i];
+    if (entry == NULL || entry->data == NULL) {
+      return -1;
+    }
+    width += type == DATA_ENTRY_TYPE_VECTOR ? ((struct vector *)entry->data)->length : 1;
+  }
+  return width;
+}
+
+/**
+ * Writes the header of a 2-D `.npy` array.
+ *
+ * @param struct npy_writer *writer
+ *   The writer.
+ * @param const char *descr
+ *   The NumPy description of the values, without the byte order.
+ * @param long long rows
+ *   The number of rows of the array.
+ * @param long long columns
+ *   The number of columns of the array.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int npy_write_header(struct npy_writer *writer, const char *descr, long long rows, long long columns) {
+  // The byte order mark is '<' on little-endian hosts.
+  const uint16_t probe = 1;
+  char order = *(const unsigned char *)&probe == 1 ? '<' : '>';
+  char header[256];
+  int length = snprintf(header, sizeof(header), "{'descr': '%c%s', 'fortran_order': False, 'shape': (%lld, %lld), }", order, descr, rows, columns);
+  if (length < 0 || (size_t)length >= sizeof(header) - 64) {
+    return -1;
+  }
+  // Pad with spaces and a final newline so the data starts on a 64-byte boundary.
+  size_t total = 10 + (size_t)length + 1;
+  size_t padding = (64 - total % 64) % 64;
+  memset(header + length, ' ', padding);
+  header[length + padding] = '\n';
+  uint16_t header_size = (uint16_t)(length + padding + 1);
+  unsigned char preamble[10] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0, (unsigned char)(header_size & 0xff), (unsigned char)(header_size >> 8)};
+  if (npy_write(writer, preamble, sizeof(preamble)) != 0) {
+    return -1;
+  }
+  return npy_write(writer, header, header_size);
+}
+
+/**
+ * Writes the values of a collection of entries.
+ *
+ * @param struct npy_writer *writer
+ *   The writer.
+ * @param struct data_entries *entries
+ *   The data entries, may be NULL.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int npy_write_entries(struct npy_writer *writer, struct data_entries *entries, enum data_entry_type type) {
+  int64_t count = entries != NULL ? entries->size : 0;
+  for (int64_t i = 0; i < count; i++) {
+    void *data = entries->entries[i]->data;
+    int status;
+    if (type == DATA_ENTRY_TYPE_INT) {
+      int32_t value = *(int *)data;
+      status = npy_write(writer, &value, sizeof(value));
+    } else if (type == DATA_ENTRY_TYPE_DOUBLE) {
+      status = npy_write(writer, data, sizeof(double));
+    } else {
+      struct vector *vector = data;
+      size_t size = (size_t)vector->length * sizeof(double);
+      // Long vectors are written from their own elements, the others are gathered.
+      status = size >= NPY_DIRECT_SIZE ? npy_write_direct(writer, vector->elements, size) : npy_write(writer, vector->elements, size);
+    }
+    if (status != 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_export_npy(struct dataset *data, const char *path, enum data_row_side side, enum data_entry_type type) {
+  // Check if the input params are valid.
+  if (data == NULL || path == NULL) {
+    return -1;
+  }
+  if (type != DATA_ENTRY_TYPE_INT && type != DATA_ENTRY_TYPE_DOUBLE && type != DATA_ENTRY_TYPE_VECTOR) {
+    return -1;
+  }
+  // The first row gives the width of the array.
+  struct data_row *first = data->iterator;
+  long long width = first != NULL ? npy_row_width(data_row_get_entries(first, side), type) : 0;
+  if (width < 0) {
+    return -1;
+  }
+  struct npy_writer writer = {.fd = -1};
+  if (posix_memalign((void **)&writer.buffer, 64, NPY_BUFFER_SIZE) != 0) {
+    return -1;
+  }
+  writer.fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  int status = writer.fd >= 0 ? npy_write_header(&writer, type == DATA_ENTRY_TYPE_INT ? "i4" : "f8", data->size, width) : -1;
+  // Stream the rows, checking that each one has the width of the first.
+  struct dataset_cursor cursor;
+  long long rows = 0;
+  for (struct data_row *row = dataset_cursor_begin(&cursor, data); status == 0 && row != NULL; row = dataset_cursor_next(&cursor)) {
+    struct data_entries *entries = data_row_get_entries(row, side);
+    if (npy_row_width(entries, type) != width) {
+      status = -1;
+      break;
+    }
+    status = npy_write_entries(&writer, entries, type);
+    rows++;
+  }
+  if (status == 0 && rows != data->size) {
+    // The header announced a different number of rows.
+    status = -1;
+  }
+  if (status == 0) {
+    status = npy_flush(&writer);
+  }
+  if (writer.fd >= 0 && close(writer.fd) != 0) {
+    status = -1;
+  }
+  if (status != 0 && writer.fd >= 0) {
+    // Do not leave a truncated array behind.
+    unlink(path);
+  }
+  free(writer.buffer);
+  return status;
+}
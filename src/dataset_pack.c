@@ -0,0 +1,281 @@
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <matrixmath.h>
+#include "../include/dataset.h"
+
+/**
+ * The number of doubles in an aligned block of a slab.
+ */
+#define PACK_BLOCK (DATASET_STORAGE_ALIGNMENT / sizeof(double))
+
+/**
+ * Represents the layout of a packed dataset, and the source of its vectors.
+ */
+struct pack_layout {
+  /**
+   * The length of the one-hot vectors, or 0 to copy the vectors of the source.
+   *
+   * @var int
+   */
+  int tokens_size;
+
+  /**
+   * The number of rows and entries.
+   *
+   * @var size_t
+   */
+  size_t rows;
+  size_t entries;
+
+  /**
+   * The largest number of columns of each side.
+   *
+   * @var int
+   */
+  int columns[2];
+
+  /**
+   * The offset of the next vector of each column in the slabs, in doubles.
+   *
+   * The inputs columns come first, followed by the outputs columns.
+   *
+   * @var size_t *
+   */
+  size_t *offsets;
+
+  /**
+   * The total number of doubles of the slabs.
+   *
+   * @var size_t
+   */
+  size_t doubles;
+};
+
+/**
+ * Returns the entries of one side of a row.
+ *
+ * @param struct data_row *row
+ *   The row.
+ * @param int side
+ *   0 for the inputs, 1 for the outputs.
+ *
+ * @return struct data_entries*
+ *   The entries, possibly NULL.
+ */
+static struct data_entries *pack_side(struct data_row *row, int side) {
+  return side == 0 ? row->inputs : row->outputs;
+}
+
+/**
+ * Computes the number of doubles an entry takes in its slab, validating it.
+ *
+ * @param const struct pack_layout *layout
+ *   The layout of the packed dataset.
+ * @param struct data_entry *entry
+ *   The source entry.
+ * @param size_t *doubles
+ *   Receives the number of doubles, padded to a whole aligned block.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the entry can not be packed.
+ */
+static int pack_entry_size(const struct pack_layout *layout, struct data_entry *entry, size_t *doubles) {
+  if (entry == NULL || entry->data == NULL) {
+    return -1;
+  }
+  int length;
+  if (layout->tokens_size > 0) {
+    // One-hot vectors have a fixed length, and the value must fit in it.
+    int value = *(int *)entry->data;
+    if (value < 0 || value >= layout->tokens_size) {
+      return -1;
+    }
+    length = layout->tokens_size;
+  } else {
+    struct vector *vector = entry->data;
+    if (vector->length < 0 || (vector->length > 0 && vector->elements == NULL)) {
+      return -1;
+    }
+    length = vector->length;
+  }
+  *doubles = ((size_t)length + PACK_BLOCK - 1) / PACK_BLOCK * PACK_BLOCK;
+  return 0;
+}
+
+/**
+ * Measures the rows of the source dataset and computes the slabs of the columns.
+ *
+ * @param struct pack_layout *layout
+ *   The layout to fill, with `tokens_size` set.
+ * @param struct dataset *data
+ *   The source dataset.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int pack_measure(struct pack_layout *layout, struct dataset *data) {
+  // Count the rows, the entries and the columns of each side.
+  for (struct data_row *row = data->iterator; row != NULL; row = row->next) {
+    layout->rows++;
+    for (int side = 0; side < 2; side++) {
+      struct data_entries *entries = pack_side(row, side);
+      if (entries == NULL || entries->size <= 0) {
+        continue;
+      }
+      if (entries->entries == NULL || entries->size > INT_MAX) {
+        return -1;
+      }
+      layout->entries += (size_t)entries->size;
+      layout->columns[side] = entries->size > layout->columns[side] ? (int)entries->size : layout->columns[side];
+    }
+  }
+  size_t columns = (size_t)layout->columns[0] + (size_t)layout->columns[1];
+  layout->offsets = calloc(columns > 0 ? columns : 1, sizeof(size_t));
+  if (layout->offsets == NULL) {
+    return -1;
+  }
+  // Sum the size of each column.
+  for (struct data_row *row = data->iterator; row != NULL; row = row->next) {
+    for (int side = 0; side < 2; side++) {
+      struct data_entries *entries = pack_side(row, side);
+      if (entries == NULL) {
+        continue;
+      }
+      size_t *sizes = layout->offsets + (side == 0 ? 0 : layout->columns[0]);
+      for (int64_t column = 0; column < entries->size; column++) {
+        size_t doubles;
+        if (pack_entry_size(layout, entries->entries[column], &doubles) != 0 || doubles > SIZE_MAX / sizeof(double) - sizes[column]) {
+          return -1;
+        }
+        sizes[column] += doubles;
+      }
+    }
+  }
+  // Turn the sizes into the offsets of the slabs.
+  for (size_t column = 0; column < columns; column++) {
+    size_t size = layout->offsets[column];
+    if (size > SIZE_MAX / sizeof(double) - layout->doubles) {
+      return -1;
+    }
+    layout->offsets[column] = layout->doubles;
+    layout->doubles += size;
+  }
+  return 0;
+}
+
+/**
+ * Builds a packed dataset from a dataset of vectors or of one-hot indices.
+ *
+ * @param struct dataset *data
+ *   The source dataset.
+ * @param int tokens_size
+ *   The length of the one-hot vectors, or 0 to copy the vectors of the source.
+ * @param int huge_pages
+ *   Whether to back the storage with huge pages.
+ *
+ * @return struct dataset*
+ *   A pointer to the packed dataset, or NULL on failure.
+ */
+static struct dataset *pack_dataset(struct dataset *data, int tokens_size, int huge_pages) {
+  struct pack_layout layout = {.tokens_size = tokens_size};
+  if (pack_measure(&layout, data) != 0) {
+    free(layout.offsets);
+    return NULL;
+  }
+  struct dataset *packed = dataset_create();
+  if (packed == NULL || layout.rows == 0) {
+    free(layout.offsets);
+    return packed;
+  }
+  // The slabs come first so they inherit the alignment of the storage, the other arrays follow.
+  size_t row_size = sizeof(struct data_row) + 2 * sizeof(struct data_entries);
+  size_t entry_size = sizeof(struct data_entry *) + sizeof(struct data_entry) + sizeof(struct vector);
+  size_t slabs_size = layout.doubles * sizeof(double);
+  if (layout.rows > (SIZE_MAX - slabs_size) / row_size || layout.entries > (SIZE_MAX - slabs_size - layout.rows * row_size) / entry_size) {
+    free(layout.offsets);
+    dataset_destroy(packed);
+    return NULL;
+  }
+  size_t size = slabs_size + layout.rows * row_size + layout.entries * entry_size;
+  struct dataset_storage *storage = huge_pages ? dataset_storage_create_huge(size) : dataset_storage_create(size);
+  if (storage == NULL) {
+    free(layout.offsets);
+    dataset_destroy(packed);
+    return NULL;
+  }
+  double *slabs = (double *)storage->memory;
+  struct data_row *rows = (struct data_row *)(slabs + layout.doubles);
+  struct data_entries *collections = (struct data_entries *)(rows + layout.rows);
+  struct data_entry **pointers = (struct data_entry **)(collections + 2 * layout.rows);
+  struct data_entry *entries = (struct data_entry *)(pointers + layout.entries);
+  struct vector *vectors = (struct vector *)(entries + layout.entries);
+  // Zero the slabs so the one-hot vectors and the padding need no further writes.
+  memset(slabs, 0, slabs_size);
+  size_t row_index = 0;
+  size_t entry_index = 0;
+  for (struct data_row *source = data->iterator; source != NULL; source = source->next, row_index++) {
+    struct data_row *row = &rows[row_index];
+    for (int side = 0; side < 2; side++) {
+      struct data_entries *source_entries = pack_side(source, side);
+      struct data_entries *collection = &collections[2 * row_index + side];
+      collection->size = source_entries == NULL ? 0 : source_entries->size;
+      collection->entries = &pointers[entry_index];
+      size_t *offsets = layout.offsets + (side == 0 ? 0 : layout.columns[0]);
+      for (int64_t column = 0; column < collection->size; column++, entry_index++) {
+        struct data_entry *source_entry = source_entries->entries[column];
+        struct vector *vector = &vectors[entry_index];
+        // The entries were validated while measuring the layout.
+        size_t doubles = 0;
+        pack_entry_size(&layout, source_entry, &doubles);
+        vector->elements = slabs + offsets[column];
+        offsets[column] += doubles;
+        if (tokens_size > 0) {
+          vector->length = tokens_size;
+          vector->elements[*(int *)source_entry->data] = 1;
+        } else {
+          struct vector *source_vector = source_entry->data;
+          vector->length = source_vector->length;
+          if (vector->length > 0) {
+            memcpy(vector->elements, source_vector->elements, (size_t)vector->length * sizeof(double));
+          }
+        }
+        entries[entry_index].data = vector;
+        pointers[entry_index] = &entries[entry_index];
+      }
+    }
+    row->inputs = &collections[2 * row_index];
+    row->outputs = &collections[2 * row_index + 1];
+    row->previous = row_index > 0 ? &rows[row_index - 1] : NULL;
+    row->next = row_index + 1 < layout.rows ? &rows[row_index + 1] : NULL;
+    row->storage = storage;
+  }
+  free(layout.offsets);
+  // Hand the rows over to the dataset, each of them references the storage.
+  dataset_storage_retain(storage, layout.rows);
+  packed->iterator = &rows[0];
+  packed->last = &rows[layout.rows - 1];
+  packed->size = layout.rows;
+  return packed;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_pack_vectors(struct dataset *data, int huge_pages) {
+  if (data == NULL) {
+    return NULL;
+  }
+  return pack_dataset(data, 0, huge_pages);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_one_hot_encode_packed(struct dataset *int_encoded_dataset, int tokens_size, int huge_pages) {
+  if (int_encoded_dataset == NULL || tokens_size <= 0) {
+    return NULL;
+  }
+  return pack_dataset(int_encoded_dataset, tokens_size, huge_pages);
+}
@@ -0,0 +1,56 @@
+#include <stdint.h>
+#include "../include/dataset.h"
+#include "dataset_internal.h"
+
+// Increment of the SplitMix64 counter (the golden ratio in 64-bit fixed point).
+#define RANDOM_INCREMENT 0x9e3779b97f4a7c15ULL
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_random_seed(struct dataset_random *random, uint64_t seed) {
+  if (random == NULL) {
+    // No action needed if random is NULL.
+    return;
+  }
+  random->state = seed;
+}
+
+/**
+ * {@inheritdoc}
+ */
+uint64_t dataset_random_next(struct dataset_random *random) {
+  random->state += RANDOM_INCREMENT;
+  return dataset_mix64(random->state);
+}
+
+/**
+ * {@inheritdoc}
+ */
+uint64_t dataset_random_at(uint64_t seed, uint64_t counter) {
+  return dataset_mix64(seed + (counter + 1) * RANDOM_INCREMENT);
+}
+
+/**
+ * {@inheritdoc}
+ */
+double dataset_random_uniform(struct dataset_random *random) {
+  // Use the top 53 bits, shifted by one so 0 is never returned.
+  return (double)((dataset_random_next(random) >> 11) + 1) * 0x1.0p-53;
+}
+
+/**
+ * {@inheritdoc}
+ */
+uint64_t dataset_random_below(struct dataset_random *random, uint64_t bound) {
+  if (bound <= 1) {
+    return 0;
+  }
+  // Reject the values of the incomplete last interval to avoid modulo bias.
+  uint64_t threshold = (0 - bound) % bound;
+  uint64_t value = dataset_random_next(random);
+  while (value < threshold) {
+    value = dataset_random_next(random);
+  }
+  return value % bound;
+}
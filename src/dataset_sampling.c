@@ -0,0 +1,810 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "../include/dataset.h"
+#include "dataset_internal.h"
+
+/**
+ * Represents a sampled row along with its position in the stream.
+ */
+struct sampled_row {
+  int64_t position;
+  struct data_row *row;
+};
+
+/**
+ * Represents a class of the stratified sampling.
+ */
+struct sample_class {
+  /**
+   * The hash of the output values of the class, 0 for an empty slot.
+   *
+   * @var uint64_t
+   */
+  uint64_t hash;
+
+  /**
+   * The first row of the class, used to compare the output values.
+   *
+   * @var struct data_row *
+   */
+  struct data_row *representative;
+
+  /**
+   * The sample of the class.
+   *
+   * @var struct dataset_reservoir *
+   */
+  struct dataset_reservoir *reservoir;
+
+  /**
+   * The number of rows of the class, counted to balance the weights of the classes.
+   *
+   * @var int64_t
+   */
+  int64_t rows;
+};
+
+/**
+ * Represents the sort key of a row in the permutation of an epoch.
+ */
+struct weighted_key {
+  double key;
+  int index;
+};
+
+/**
+ * Represents a weighted row sampler.
+ */
+struct dataset_weighted_sampler {
+  /**
+   * The rows of the dataset, in dataset order.
+   *
+   * @var struct dataset_view *
+   */
+  struct dataset_view *rows;
+
+  /**
+   * The weight of each row.
+   *
+   * @var double *
+   */
+  double *weights;
+
+  /**
+   * The alias table: the probability of keeping each column, scaled by 2^53, and
+   * the row drawn otherwise. Only built when drawing with replacement.
+   */
+  uint64_t *thresholds;
+  int *aliases;
+
+  /**
+   * The rows of the current epoch in drawing order, their number and the next one.
+   * Only used when drawing without replacement.
+   */
+  struct weighted_key *order;
+  int order_size;
+  int position;
+
+  /**
+   * Whether the rows are drawn with replacement.
+   *
+   * @var int
+   */
+  int replacement;
+
+  /**
+   * The seed of the sampler, and the number of epochs started so far.
+   */
+  uint64_t seed;
+  uint64_t epoch;
+
+  /**
+   * Whether the end of the current epoch was already reported.
+   *
+   * @var int
+   */
+  int ended;
+
+  /**
+   * The index of the next batch.
+   *
+   * @var int
+   */
+  int batch_index;
+
+  /**
+   * The rows drawn for the next batch, and the number of rows it can hold.
+   */
+  struct data_row **scratch;
+  int scratch_capacity;
+
+  /**
+   * The generator of the draws with replacement.
+   *
+   * @var struct dataset_random
+   */
+  struct dataset_random random;
+};
+
+/**
+ * Draws the number of rows to skip before the next replacement of Algorithm L.
+ *
+ * @param struct dataset_reservoir *reservoir
+ *   The reservoir.
+ *
+ * @return int64_t
+ *   The number of rows to skip.
+ */
+static int64_t reservoir_skip(struct dataset_reservoir *reservoir) {
+  double skip = floor(log(dataset_random_uniform(&reservoir->random)) / log(1.0 - reservoir->weight));
+  if (!(skip < (double)(INT64_MAX / 2))) {
+    // The weight is so small that no other row will ever be selected.
+    return INT64_MAX / 2;
+  }
+  return (int64_t)skip;
+}
+
+/**
+ * Updates the weight of Algorithm L and draws the position of the next replacement.
+ *
+ * @param struct dataset_reservoir *reservoir
+ *   The reservoir.
+ * @param int64_t position
+ *   The position of the current row.
+ */
+static void reservoir_advance(struct dataset_reservoir *reservoir, int64_t position) {
+  double capacity = (double)reservoir->sample->capacity;
+  reservoir->weight *= exp(log(dataset_random_uniform(&reservoir->random)) / capacity);
+  reservoir->next = position + reservoir_skip(reservoir) + 1;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_reservoir *dataset_reservoir_create(struct dataset *source, int capacity, uint64_t seed) {
+  // Check if the input params are valid.
+  if (capacity <= 0) {
+    return NULL;
+  }
+  // Allocate memory for the reservoir structure.
+  struct dataset_reservoir *reservoir = malloc(sizeof(struct dataset_reservoir));
+  if (reservoir == NULL) {
+    // Memory allocation failed.
+    return NULL;
+  }
+  reservoir->sample = dataset_view_create(source, capacity);
+  reservoir->positions = malloc((size_t)capacity * sizeof(int64_t));
+  if (reservoir->sample == NULL || reservoir->positions == NULL) {
+    dataset_view_destroy(reservoir->sample);
+    free(reservoir->positions);
+    free(reservoir);
+    return NULL;
+  }
+  reservoir->seen = 0;
+  reservoir->next = 0;
+  reservoir->weight = 1.0;
+  dataset_random_seed(&reservoir->random, seed);
+  // Return the newly created reservoir.
+  return reservoir;
+}
+
+/**
+ * Offers a row to the reservoir, recording the given position for the row.
+ *
+ * The skips are drawn over the rows offered to this reservoir, while the recorded
+ * position is the one used to restore the order of the sample.
+ *
+ * @param struct dataset_reservoir *reservoir
+ *   The reservoir.
+ * @param struct data_row *row
+ *   The row.
+ * @param int64_t position
+ *   The position recorded for the row.
+ */
+static void reservoir_offer_at(struct dataset_reservoir *reservoir, struct data_row *row, int64_t position) {
+  int64_t offered = reservoir->seen++;
+  struct dataset_view *sample = reservoir->sample;
+  if (sample->size < sample->capacity) {
+    // Fill the reservoir with the first rows.
+    reservoir->positions[sample->size] = position;
+    sample->rows[sample->size++] = row;
+    if (sample->size == sample->capacity) {
+      reservoir_advance(reservoir, offered);
+    }
+    return;
+  }
+  if (offered != reservoir->next) {
+    // The row is skipped.
+    return;
+  }
+  // Replace a random slot with the row and draw the next skip.
+  int slot = (int)dataset_random_below(&reservoir->random, (uint64_t)sample->capacity);
+  reservoir->positions[slot] = position;
+  sample->rows[slot] = row;
+  reservoir_advance(reservoir, offered);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_reservoir_offer(struct dataset_reservoir *reservoir, struct data_row *row) {
+  if (reservoir == NULL || row == NULL) {
+    return;
+  }
+  reservoir_offer_at(reservoir, row, reservoir->seen);
+}
+
+/**
+ * Compares two sampled rows by stream position, used to sort them with qsort.
+ *
+ * @param const void *a
+ *   The first sampled row.
+ * @param const void *b
+ *   The second sampled row.
+ *
+ * @return int
+ *   A negative, zero or positive value if a is before, at or after b.
+ */
+static int sampled_row_compare(const void *a, const void *b) {
+  int64_t position_a = ((const struct sampled_row *)a)->position;
+  int64_t position_b = ((const struct sampled_row *)b)->position;
+  return (position_a > position_b) - (position_a < position_b);
+}
+
+/**
+ * Sorts sampled rows by stream position and stores them into a view.
+ *
+ * @param struct sampled_row *sampled
+ *   The sampled rows.
+ * @param int size
+ *   The number of sampled rows, no greater than the capacity of the view.
+ * @param struct dataset_view *view
+ *   The view that receives the rows.
+ */
+static void sampled_rows_store(struct sampled_row *sampled, int size, struct dataset_view *view) {
+  qsort(sampled, (size_t)size, sizeof(struct sampled_row), sampled_row_compare);
+  for (int i = 0; i < size; i++) {
+    view->rows[i] = sampled[i].row;
+  }
+  view->size = size;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_reservoir_finish(struct dataset_reservoir *reservoir) {
+  if (reservoir == NULL || reservoir->sample->size == 0) {
+    return;
+  }
+  int size = reservoir->sample->size;
+  struct sampled_row *sampled = malloc((size_t)size * sizeof(struct sampled_row));
+  if (sampled == NULL) {
+    // Keep the sample unsorted if the memory could not be allocated.
+    return;
+  }
+  for (int i = 0; i < size; i++) {
+    sampled[i].position = reservoir->positions[i];
+    sampled[i].row = reservoir->sample->rows[i];
+  }
+  sampled_rows_store(sampled, size, reservoir->sample);
+  for (int i = 0; i < size; i++) {
+    reservoir->positions[i] = sampled[i].position;
+  }
+  free(sampled);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_reservoir_destroy(struct dataset_reservoir *reservoir) {
+  if (reservoir == NULL) {
+    // No action needed if reservoir is NULL.
+    return;
+  }
+  dataset_view_destroy(reservoir->sample);
+  free(reservoir->positions);
+  free(reservoir);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_view *dataset_sample_reservoir(struct dataset *data, int k, uint64_t seed) {
+  // Check if the input params are valid.
+  if (data == NULL || k < 0) {
+    return NULL;
+  }
+  if (k == 0) {
+    return dataset_view_create(data, 0);
+  }
+  struct dataset_reservoir *reservoir = dataset_reservoir_create(data, k, seed);
+  if (reservoir == NULL) {
+    return NULL;
+  }
+  // Stream every row of the dataset through the reservoir.
+  struct data_row *current = data->iterator;
+  while (current != NULL) {
+    dataset_reservoir_offer(reservoir, current);
+    current = current->next;
+  }
+  dataset_reservoir_finish(reservoir);
+  // Keep the sample and release the rest of the reservoir.
+  struct dataset_view *sample = reservoir->sample;
+  reservoir->sample = NULL;
+  free(reservoir->positions);
+  free(reservoir);
+  return sample;
+}
+
+/**
+ * Hashes the output values of a row, read as integers.
+ *
+ * @param struct data_row *row
+ *   The row.
+ *
+ * @return uint64_t
+ *   The hash, never 0.
+ */
+static uint64_t sample_class_hash(struct data_row *row) {
+  uint64_t hash = DATASET_FNV_OFFSET;
+  struct data_entries *outputs = row->outputs;
+  for (int64_t i = 0; outputs != NULL && i < outputs->size; i++) {
+    struct data_entry *entry = outputs->entries[i];
+    // A missing value is outside the range of the integers.
+    uint64_t value = (entry != NULL && entry->data != NULL) ? (uint32_t)*(int *)entry->data : 0xffffffffffULL;
+    hash = dataset_fnv1a(hash, &value, sizeof(value));
+  }
+  hash = dataset_mix64(hash);
+  return hash != 0 ? hash : 1;
+}
+
+/**
+ * Checks whether two rows have the same output values, read as integers.
+ *
+ * @param struct data_row *a
+ *   The first row.
+ * @param struct data_row *b
+ *   The second row.
+ *
+ * @return int
+ *   1 if the output values are equal, 0 otherwise.
+ */
+static int sample_class_equals(struct data_row *a, struct data_row *b) {
+  int64_t size_a = a->outputs != NULL ? a->outputs->size : 0;
+  int64_t size_b = b->outputs != NULL ? b->outputs->size : 0;
+  if (size_a != size_b) {
+    return 0;
+  }
+  for (int64_t i = 0; i < size_a; i++) {
+    struct data_entry *entry_a = a->outputs->entries[i];
+    struct data_entry *entry_b = b->outputs->entries[i];
+    int valid_a = entry_a != NULL && entry_a->data != NULL;
+    int valid_b = entry_b != NULL && entry_b->data != NULL;
+    if (valid_a != valid_b || (valid_a && *(int *)entry_a->data != *(int *)entry_b->data)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * Destroys the table of classes of a stratified sampling.
+ *
+ * @param struct sample_class *classes
+ *   The table of classes.
+ * @param int capacity
+ *   The number of slots of the table.
+ */
+static void sample_classes_destroy(struct sample_class *classes, int capacity) {
+  for (int i = 0; i < capacity; i++) {
+    dataset_reservoir_destroy(classes[i].reservoir);
+  }
+  free(classes);
+}
+
+/**
+ * Finds the class of a row, inserting a new class if needed.
+ *
+ * @param struct sample_class **classes
+ *   The table of classes, replaced when it grows.
+ * @param int *capacity
+ *   The number of slots of the table, updated when it grows.
+ * @param int *size
+ *   The number of classes of the table, updated on insertion.
+ * @param struct data_row *row
+ *   The row.
+ *
+ * @return struct sample_class*
+ *   The class of the row, or NULL if the table could not grow.
+ */
+static struct sample_class *sample_classes_find(struct sample_class **classes, int *capacity, int *size, struct data_row *row) {
+  // Keep the table at most half full.
+  if ((*size + 1) * 2 > *capacity) {
+    int grown_capacity = *capacity * 2;
+    struct sample_class *grown = calloc((size_t)grown_capacity, sizeof(struct sample_class));
+    if (grown == NULL) {
+      return NULL;
+    }
+    for (int i = 0; i < *capacity; i++) {
+      if ((*classes)[i].hash == 0) {
+        continue;
+      }
+      int slot = (int)((*classes)[i].hash & (uint64_t)(grown_capacity - 1));
+      while (grown[slot].hash != 0) {
+        slot = (slot + 1) & (grown_capacity - 1);
+      }
+      grown[slot] = (*classes)[i];
+    }
+    free(*classes);
+    *classes = grown;
+    *capacity = grown_capacity;
+  }
+  // Linear probing on the hash of the output values.
+  uint64_t hash = sample_class_hash(row);
+  int slot = (int)(hash & (uint64_t)(*capacity - 1));
+  while ((*classes)[slot].hash != 0) {
+    struct sample_class *candidate = &(*classes)[slot];
+    if (candidate->hash == hash && sample_class_equals(candidate->representative, row)) {
+      return candidate;
+    }
+    slot = (slot + 1) & (*capacity - 1);
+  }
+  (*classes)[slot].hash = hash;
+  (*classes)[slot].representative = row;
+  (*size)++;
+  return &(*classes)[slot];
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_view *dataset_sample_stratified(struct dataset *data, int per_class, uint64_t seed) {
+  // Check if the input params are valid.
+  if (data == NULL || per_class <= 0) {
+    return NULL;
+  }
+  int capacity = 16;
+  int size = 0;
+  struct sample_class *classes = calloc((size_t)capacity, sizeof(struct sample_class));
+  if (classes == NULL) {
+    return NULL;
+  }
+  // Offer each row to the reservoir of its class.
+  int64_t position = 0;
+  struct data_row *current = data->iterator;
+  while (current != NULL) {
+    struct sample_class *class = sample_classes_find(&classes, &capacity, &size, current);
+    if (class == NULL) {
+      sample_classes_destroy(classes, capacity);
+      return NULL;
+    }
+    if (class->reservoir == NULL) {
+      // Each class draws from its own sequence of the seed.
+      class->reservoir = dataset_reservoir_create(data, per_class, dataset_random_at(seed, (uint64_t)size));
+      if (class->reservoir == NULL) {
+        sample_classes_destroy(classes, capacity);
+        return NULL;
+      }
+    }
+    reservoir_offer_at(class->reservoir, current, position++);
+    current = current->next;
+  }
+  // Collect the samples of every class.
+  int total = 0;
+  for (int i = 0; i < capacity; i++) {
+    if (classes[i].reservoir != NULL) {
+      total += classes[i].reservoir->sample->size;
+    }
+  }
+  struct dataset_view *view = dataset_view_create(data, total);
+  struct sampled_row *sampled = malloc(((size_t)total + 1) * sizeof(struct sampled_row));
+  if (view == NULL || sampled == NULL) {
+    dataset_view_destroy(view);
+    free(sampled);
+    sample_classes_destroy(classes, capacity);
+    return NULL;
+  }
+  int collected = 0;
+  for (int i = 0; i < capacity; i++) {
+    struct dataset_reservoir *reservoir = classes[i].reservoir;
+    for (int j = 0; reservoir != NULL && j < reservoir->sample->size; j++) {
+      sampled[collected].position = reservoir->positions[j];
+      sampled[collected].row = reservoir->sample->rows[j];
+      collected++;
+    }
+  }
+  sample_classes_destroy(classes, capacity);
+  // Restore the dataset order of the sample.
+  sampled_rows_store(sampled, collected, view);
+  free(sampled);
+  return view;
+}
+
+/**
+ * Gives every row the same share of the weight of its class, so every class gets a total weight of 1.
+ *
+ * @param const struct dataset_view *rows
+ *   The rows of the dataset.
+ * @param double *weights
+ *   Receives the weight of each row.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int weighted_class_weights(const struct dataset_view *rows, double *weights) {
+  int capacity = 16;
+  int size = 0;
+  struct sample_class *classes = calloc((size_t)capacity, sizeof(struct sample_class));
+  if (classes == NULL) {
+    return -1;
+  }
+  // Count the rows of each class, then look the classes up again to split their weight.
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = 0; i < rows->size; i++) {
+      struct sample_class *class = sample_classes_find(&classes, &capacity, &size, rows->rows[i]);
+      if (class == NULL) {
+        sample_classes_destroy(classes, capacity);
+        return -1;
+      }
+      if (pass == 0) {
+        class->rows++;
+      } else {
+        weights[i] = 1.0 / (double)class->rows;
+      }
+    }
+  }
+  sample_classes_destroy(classes, capacity);
+  return 0;
+}
+
+/**
+ * Builds the alias table of a sampler with Vose's method.
+ *
+ * @param struct dataset_weighted_sampler *sampler
+ *   The sampler, with its weights set.
+ * @param double total
+ *   The sum of the weights.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int weighted_build_alias(struct dataset_weighted_sampler *sampler, double total) {
+  int size = sampler->rows->size;
+  double *scaled = malloc((size_t)size * sizeof(double));
+  int *worklist = malloc((size_t)size * sizeof(int));
+  if (scaled == NULL || worklist == NULL) {
+    free(scaled);
+    free(worklist);
+    return -1;
+  }
+  // Scale the weights to a mean of 1, the columns below 1 are stacked from the front
+  // of the worklist and the others from the back.
+  double scale = (double)size / total;
+  int small = 0;
+  int large = size;
+  for (int i = 0; i < size; i++) {
+    scaled[i] = sampler->weights[i] * scale;
+    sampler->aliases[i] = i;
+    if (scaled[i] < 1.0) {
+      worklist[small++] = i;
+    } else {
+      worklist[--large] = i;
+    }
+  }
+  // Fill each column below 1 with the excess of a column above 1.
+  while (small > 0 && large < size) {
+    int less = worklist[--small];
+    int more = worklist[large];
+    sampler->thresholds[less] = (uint64_t)(scaled[less] * 0x1.0p53);
+    sampler->aliases[less] = more;
+    scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+    if (scaled[more] < 1.0) {
+      large++;
+      worklist[small++] = more;
+    }
+  }
+  // The remaining columns are full, up to rounding errors.
+  for (int i = 0; i < small; i++) {
+    sampler->thresholds[worklist[i]] = (uint64_t)1 << 53;
+  }
+  for (int i = large; i < size; i++) {
+    sampler->thresholds[worklist[i]] = (uint64_t)1 << 53;
+  }
+  free(scaled);
+  free(worklist);
+  return 0;
+}
+
+/**
+ * Compares the keys of two rows of an epoch, breaking ties by dataset order.
+ *
+ * @param const void *a
+ *   The first key.
+ * @param const void *b
+ *   The second key.
+ *
+ * @return int
+ *   A negative value if a comes first, a positive value if b comes first.
+ */
+static int weighted_key_compare(const void *a, const void *b) {
+  const struct weighted_key *key_a = a;
+  const struct weighted_key *key_b = b;
+  if (key_a->key != key_b->key) {
+    return key_a->key < key_b->key ? -1 : 1;
+  }
+  return (key_a->index > key_b->index) - (key_a->index < key_b->index);
+}
+
+/**
+ * Starts the next epoch of a sampler without replacement.
+ *
+ * Each row of positive weight w gets the key E / w, where E is exponentially
+ * distributed, and the rows are drawn by increasing key: this is the weighted
+ * random permutation of Efraimidis and Spirakis. Each epoch is seeded from the
+ * seed of the sampler and its number, so it does not depend on earlier draws.
+ *
+ * @param struct dataset_weighted_sampler *sampler
+ *   The sampler.
+ */
+static void weighted_start_epoch(struct dataset_weighted_sampler *sampler) {
+  struct dataset_random random;
+  dataset_random_seed(&random, dataset_random_at(sampler->seed, sampler->epoch++));
+  int size = 0;
+  for (int i = 0; i < sampler->rows->size; i++) {
+    if (sampler->weights[i] > 0.0) {
+      sampler->order[size].key = -log(dataset_random_uniform(&random)) / sampler->weights[i];
+      sampler->order[size].index = i;
+      size++;
+    }
+  }
+  qsort(sampler->order, (size_t)size, sizeof(struct weighted_key), weighted_key_compare);
+  sampler->order_size = size;
+  sampler->position = 0;
+  sampler->ended = 0;
+  sampler->batch_index = 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_weighted_sampler *dataset_weighted_sampler_create(struct dataset *data, const double *weights, int replacement, uint64_t seed) {
+  // Check if the input params are valid.
+  if (data == NULL) {
+    return NULL;
+  }
+  // Allocate memory for the sampler structure.
+  struct dataset_weighted_sampler *sampler = calloc(1, sizeof(struct dataset_weighted_sampler));
+  if (sampler == NULL) {
+    // Memory allocation failed.
+    return NULL;
+  }
+  sampler->replacement = replacement != 0;
+  sampler->seed = seed;
+  sampler->ended = 1;
+  dataset_random_seed(&sampler->random, seed);
+  // Index the rows, and copy or compute their weights.
+  sampler->rows = dataset_view_from_dataset(data);
+  if (sampler->rows == NULL) {
+    dataset_weighted_sampler_destroy(sampler);
+    return NULL;
+  }
+  int size = sampler->rows->size;
+  sampler->weights = malloc(((size_t)size + 1) * sizeof(double));
+  if (sampler->weights == NULL || (weights == NULL && weighted_class_weights(sampler->rows, sampler->weights) != 0)) {
+    dataset_weighted_sampler_destroy(sampler);
+    return NULL;
+  }
+  double total = 0.0;
+  for (int i = 0; i < size; i++) {
+    if (weights != NULL) {
+      sampler->weights[i] = weights[i];
+    }
+    if (!isfinite(sampler->weights[i]) || sampler->weights[i] < 0.0) {
+      dataset_weighted_sampler_destroy(sampler);
+      return NULL;
+    }
+    total += sampler->weights[i];
+  }
+  if (!(total > 0.0) || !isfinite(total)) {
+    // There is no row to draw.
+    dataset_weighted_sampler_destroy(sampler);
+    return NULL;
+  }
+  // Build the alias table, or the permutation buffer of the epochs.
+  if (sampler->replacement) {
+    sampler->thresholds = malloc((size_t)size * sizeof(uint64_t));
+    sampler->aliases = malloc((size_t)size * sizeof(int));
+    if (sampler->thresholds == NULL || sampler->aliases == NULL || weighted_build_alias(sampler, total) != 0) {
+      dataset_weighted_sampler_destroy(sampler);
+      return NULL;
+    }
+  } else {
+    sampler->order = malloc((size_t)size * sizeof(struct weighted_key));
+    if (sampler->order == NULL) {
+      dataset_weighted_sampler_destroy(sampler);
+      return NULL;
+    }
+  }
+  // Return the newly created sampler.
+  return sampler;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_weighted_sampler_destroy(struct dataset_weighted_sampler *sampler) {
+  if (sampler == NULL) {
+    // No action needed if sampler is NULL.
+    return;
+  }
+  dataset_view_destroy(sampler->rows);
+  free(sampler->weights);
+  free(sampler->thresholds);
+  free(sampler->aliases);
+  free(sampler->order);
+  free(sampler->scratch);
+  free(sampler);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_weighted_sampler_draw(struct dataset_weighted_sampler *sampler, struct data_row **rows, int count) {
+  // Check if the input params are valid.
+  if (sampler == NULL || (rows == NULL && count > 0) || count < 0) {
+    return -1;
+  }
+  struct data_row **source = sampler->rows->rows;
+  if (sampler->replacement) {
+    // Pick a column uniformly, then either the column or its alias.
+    uint64_t size = (uint64_t)sampler->rows->size;
+    for (int i = 0; i < count; i++) {
+      int column = (int)dataset_random_below(&sampler->random, size);
+      int keep = (dataset_random_next(&sampler->random) >> 11) < sampler->thresholds[column];
+      rows[i] = source[keep ? column : sampler->aliases[column]];
+    }
+    return count;
+  }
+  if (sampler->position == sampler->order_size) {
+    if (!sampler->ended) {
+      // Report the end of the epoch once before starting the next one.
+      sampler->ended = 1;
+      return 0;
+    }
+    weighted_start_epoch(sampler);
+  }
+  int remaining = sampler->order_size - sampler->position;
+  int drawn = count < remaining ? count : remaining;
+  for (int i = 0; i < drawn; i++) {
+    rows[i] = source[sampler->order[sampler->position++].index];
+  }
+  return drawn;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_weighted_sampler_next_batch(struct dataset_weighted_sampler *sampler, struct dataset_batch *batch, const struct dataset_batch_layout *input_layout, const struct dataset_batch_layout *output_layout) {
+  // Check if the input params are valid, before any row is drawn.
+  if (sampler == NULL || batch == NULL) {
+    return -1;
+  }
+  if (dataset_batch_layout_width(input_layout) != batch->input_width || dataset_batch_layout_width(output_layout) != batch->output_width) {
+    return -1;
+  }
+  if (batch->capacity > sampler->scratch_capacity) {
+    struct data_row **scratch = realloc(sampler->scratch, (size_t)batch->capacity * sizeof(struct data_row *));
+    if (scratch == NULL) {
+      return -1;
+    }
+    sampler->scratch = scratch;
+    sampler->scratch_capacity = batch->capacity;
+  }
+  int count = dataset_weighted_sampler_draw(sampler, sampler->scratch, batch->capacity);
+  if (count < 0 || dataset_batch_gather(batch, sampler->scratch, count, input_layout, output_layout) != 0) {
+    return -1;
+  }
+  batch->index = count > 0 ? sampler->batch_index++ : -1;
+  return count;
+}
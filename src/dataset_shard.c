@@ -0,0 +1,54 @@
+#include <limits.h>
+#include <stdlib.h>
+#include "../include/dataset.h"
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_shard_of(int64_t position, int64_t size, int n_shards, enum dataset_shard_mode mode) {
+  if (mode == DATASET_SHARD_ROUND_ROBIN || size <= 0) {
+    return (int)(position % n_shards);
+  }
+  // Shard i starts at floor(i * size / n_shards), so the row belongs to the last
+  // shard i with i * size < (position + 1) * n_shards.
+  return (int)(((position + 1) * n_shards - 1) / size);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_view *dataset_shard(struct dataset *data, int shard_index, int n_shards, enum dataset_shard_mode mode) {
+  // Check if the input params are valid.
+  if (data == NULL || n_shards <= 0 || shard_index < 0 || shard_index >= n_shards) {
+    return NULL;
+  }
+  int64_t size = data->size;
+  int64_t start = shard_index;
+  int stride = n_shards;
+  int64_t count = size / n_shards + (shard_index < size % n_shards);
+  if (mode == DATASET_SHARD_CONTIGUOUS) {
+    start = size * shard_index / n_shards;
+    stride = 1;
+    count = size * (shard_index + 1) / n_shards - start;
+  }
+  if (count > INT_MAX) {
+    // A view holds at most INT_MAX rows, split the dataset into more shards.
+    return NULL;
+  }
+  struct dataset_view *view = dataset_view_create(data, (int)count);
+  if (view == NULL || count == 0) {
+    return view;
+  }
+  // Seek to the first row of the shard, then step over the rows of the other shards.
+  struct dataset_cursor cursor;
+  dataset_cursor_begin(&cursor, data);
+  struct data_row *row = dataset_cursor_seek(&cursor, start);
+  while (row != NULL && view->size < count) {
+    view->rows[view->size++] = row;
+    for (int i = 0; i < stride && row != NULL; i++) {
+      row = dataset_cursor_next(&cursor);
+    }
+  }
+  // Return the rows of the shard.
+  return view;
+}
@@ -0,0 +1,424 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/dataset.h"
+
+/**
+ * Represents a row along with its extracted sort key.
+ */
+struct sort_item {
+  /**
+   * The key mapped to an unsigned integer with the same order (radix sort).
+   *
+   * @var uint64_t
+   */
+  uint64_t key;
+
+  /**
+   * The key of string columns (merge sort).
+   *
+   * @var const char *
+   */
+  const char *string;
+
+  /**
+   * The row.
+   *
+   * @var struct data_row *
+   */
+  struct data_row *row;
+};
+
+/**
+ * Gets the data entry at the given column of a row, if it exists.
+ *
+ * @param struct data_row *row
+ *   The data row.
+ * @param enum data_row_side side
+ *   Whether the column belongs to the inputs or to the outputs of the row.
+ * @param int column
+ *   The index of the column.
+ *
+ * @return struct data_entry*
+ *   The data entry, or NULL if the row has no such column.
+ */
+static struct data_entry *sort_column_entry(struct data_row *row, enum data_row_side side, int column) {
+  struct data_entries *entries = data_row_get_entries(row, side);
+  if (entries == NULL || column >= entries->size) {
+    return NULL;
+  }
+  struct data_entry *entry = entries->entries[column];
+  if (entry == NULL || entry->data == NULL) {
+    return NULL;
+  }
+  return entry;
+}
+
+/**
+ * Maps the value of an entry to an unsigned key with the same order.
+ *
+ * Integers get their sign bit flipped. Doubles get their sign bit flipped when
+ * positive and all their bits flipped when negative.
+ *
+ * @param struct data_entry *entry
+ *   The data entry.
+ * @param enum data_entry_type type
+ *   The type of the entry, either DATA_ENTRY_TYPE_INT or DATA_ENTRY_TYPE_DOUBLE.
+ *
+ * @return uint64_t
+ *   The key of the entry.
+ */
+static uint64_t sort_key(struct data_entry *entry, enum data_entry_type type) {
+  if (type == DATA_ENTRY_TYPE_INT) {
+    return (uint64_t)((uint32_t)*(int *)entry->data ^ 0x80000000U);
+  }
+  uint64_t bits;
+  memcpy(&bits, entry->data, sizeof(bits));
+  return (bits & 0x8000000000000000ULL) ? ~bits : bits ^ 0x8000000000000000ULL;
+}
+
+/**
+ * Sorts items by key with a stable LSD radix sort on 8-bit digits.
+ *
+ * The histograms of every digit are computed in a single pass, and the digits
+ * where all the keys fall into the same bucket are skipped.
+ *
+ * @param struct sort_item *items
+ *   The items to sort.
+ * @param struct sort_item *buffer
+ *   A scratch buffer with room for the same number of items.
+ * @param size_t size
+ *   The number of items.
+ *
+ * @return struct sort_item*
+ *   The array holding the sorted items, either items or buffer.
+ */
+static struct sort_item *sort_radix(struct sort_item *items, struct sort_item *buffer, size_t size) {
+  static const int digits = sizeof(uint64_t);
+  size_t (*counts)[256] = calloc((size_t)digits, sizeof(*counts));
+  if (counts == NULL) {
+    return NULL;
+  }
+  for (size_t i = 0; i < size; i++) {
+    for (int digit = 0; digit < digits; digit++) {
+      counts[digit][(items[i].key >> (digit * 8)) & 0xff]++;
+    }
+  }
+  struct sort_item *source = items;
+  struct sort_item *destination = buffer;
+  for (int digit = 0; digit < digits; digit++) {
+    size_t *count = counts[digit];
+    if (count[(source[0].key >> (digit * 8)) & 0xff] == size) {
+      // Every key shares this digit.
+      continue;
+    }
+    // Turn the histogram into the start offset of each bucket.
+    size_t offset = 0;
+    for (int bucket = 0; bucket < 256; bucket++) {
+      size_t bucket_size = count[bucket];
+      count[bucket] = offset;
+      offset += bucket_size;
+    }
+    for (size_t i = 0; i < size; i++) {
+      destination[count[(source[i].key >> (digit * 8)) & 0xff]++] = source[i];
+    }
+    struct sort_item *swap = source;
+    source = destination;
+    destination = swap;
+  }
+  free(counts);
+  return source;
+}
+
+/**
+ * Sorts items by string with a stable bottom-up merge sort.
+ *
+ * @param struct sort_item *items
+ *   The items to sort.
+ * @param struct sort_item *buffer
+ *   A scratch buffer with room for the same number of items.
+ * @param size_t size
+ *   The number of items.
+ * @param int direction
+ *   1 to sort in ascending order, -1 to sort in descending order.
+ *
+ * @return struct sort_item*
+ *   The array holding the sorted items, either items or buffer.
+ */
+static struct sort_item *sort_merge(struct sort_item *items, struct sort_item *buffer, size_t size, int direction) {
+  struct sort_item *source = items;
+  struct sort_item *destination = buffer;
+  for (size_t width = 1; width < size; width *= 2) {
+    for (size_t left = 0; left < size; left += 2 * width) {
+      size_t middle = left + width < size ? left + width : size;
+      size_t right = left + 2 * width < size ? left + 2 * width : size;
+      size_t i = left;
+      size_t j = middle;
+      size_t k = left;
+      while (i < middle && j < right) {
+        // Take from the right run only when strictly before, to keep the sort stable.
+        if (direction * strcmp(source[j].string, source[i].string) < 0) {
+          destination[k++] = source[j++];
+        } else {
+          destination[k++] = source[i++];
+        }
+      }
+      while (i < middle) {
+        destination[k++] = source[i++];
+      }
+      while (j < right) {
+        destination[k++] = source[j++];
+      }
+    }
+    struct sort_item *swap = source;
+    source = destination;
+    destination = swap;
+  }
+  return source;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_sort_by(struct dataset *data, enum data_row_side side, int column, enum data_entry_type type, enum dataset_sort_order order) {
+  // Check if the input params are valid.
+  if (data == NULL || column < 0) {
+    return -1;
+  }
+  if (type != DATA_ENTRY_TYPE_INT && type != DATA_ENTRY_TYPE_DOUBLE && type != DATA_ENTRY_TYPE_STRING) {
+    return -1;
+  }
+  size_t size = (size_t)data->size;
+  if (size < 2) {
+    // Nothing to sort.
+    return 0;
+  }
+  struct sort_item *items = malloc(size * sizeof(struct sort_item));
+  struct sort_item *buffer = malloc(size * sizeof(struct sort_item));
+  if (items == NULL || buffer == NULL) {
+    free(items);
+    free(buffer);
+    return -1;
+  }
+  // Extract the keys, moving the rows without the column to the tail of the buffer.
+  size_t keyed = 0;
+  size_t missing = 0;
+  struct data_row *current = data->iterator;
+  while (current != NULL && keyed + missing < size) {
+    struct data_entry *entry = sort_column_entry(current, side, column);
+    if (entry == NULL) {
+      buffer[missing++].row = current;
+    } else {
+      struct sort_item *item = &items[keyed++];
+      item->row = current;
+      item->string = type == DATA_ENTRY_TYPE_STRING ? (const char *)entry->data : NULL;
+      item->key = type == DATA_ENTRY_TYPE_STRING ? 0 : sort_key(entry, type);
+      if (order == DATASET_SORT_DESCENDING) {
+        // Inverting the keys reverses the order and keeps the sort stable.
+        item->key = ~item->key;
+      }
+    }
+    current = current->next;
+  }
+  for (size_t i = 0; i < missing; i++) {
+    items[keyed + i].row = buffer[i].row;
+  }
+  // Sort the rows that have the column.
+  struct sort_item *sorted = items;
+  if (keyed > 1 && type == DATA_ENTRY_TYPE_STRING) {
+    sorted = sort_merge(items, buffer, keyed, order == DATASET_SORT_DESCENDING ? -1 : 1);
+  } else if (keyed > 1) {
+    sorted = sort_radix(items, buffer, keyed);
+  }
+  if (sorted == NULL) {
+    free(items);
+    free(buffer);
+    return -1;
+  }
+  // Relink the rows in place.
+  size_t total = keyed + missing;
+  for (size_t i = 0; i < total; i++) {
+    struct data_row *row = i < keyed ? sorted[i].row : items[i].row;
+    struct data_row *previous = i == 0 ? NULL : (i - 1 < keyed ? sorted[i - 1].row : items[i - 1].row);
+    row->previous = previous;
+    row->next = NULL;
+    if (previous == NULL) {
+      data->iterator = row;
+    } else {
+      previous->next = row;
+    }
+    data->last = row;
+  }
+  free(items);
+  free(buffer);
+  return 0;
+}
+
+/**
+ * Represents the head row of one of the datasets being merged.
+ */
+struct merge_head {
+  /**
+   * The sort key of the row.
+   *
+   * @var struct sort_item
+   */
+  struct sort_item item;
+
+  /**
+   * Whether the row has no entry in the column.
+   *
+   * @var int
+   */
+  int missing;
+
+  /**
+   * The index of the dataset the row comes from.
+   *
+   * @var int
+   */
+  int source;
+};
+
+/**
+ * Fills the key of a merge head from its row.
+ *
+ * @param struct merge_head *head
+ *   The merge head, with its row set.
+ * @param enum data_row_side side
+ *   Whether the column belongs to the inputs or to the outputs of the rows.
+ * @param int column
+ *   The index of the column.
+ * @param enum data_entry_type type
+ *   The type of the column entries.
+ * @param enum dataset_sort_order order
+ *   The order of the merge.
+ */
+static void merge_head_load(struct merge_head *head, enum data_row_side side, int column, enum data_entry_type type, enum dataset_sort_order order) {
+  struct data_entry *entry = sort_column_entry(head->item.row, side, column);
+  head->missing = entry == NULL;
+  head->item.string = entry != NULL && type == DATA_ENTRY_TYPE_STRING ? (const char *)entry->data : NULL;
+  head->item.key = entry != NULL && type != DATA_ENTRY_TYPE_STRING ? sort_key(entry, type) : 0;
+  if (order == DATASET_SORT_DESCENDING) {
+    // Inverting the keys reverses the order, as in dataset_sort_by.
+    head->item.key = ~head->item.key;
+  }
+}
+
+/**
+ * Checks whether a merge head must be taken before another one.
+ *
+ * @param const struct merge_head *a
+ *   The first merge head.
+ * @param const struct merge_head *b
+ *   The second merge head.
+ * @param int direction
+ *   1 for string keys in ascending order, -1 in descending order.
+ *
+ * @return int
+ *   Non-zero if a comes first.
+ */
+static int merge_head_before(const struct merge_head *a, const struct merge_head *b, int direction) {
+  if (a->missing != b->missing) {
+    return b->missing;
+  }
+  if (!a->missing) {
+    int comparison = a->item.string != NULL ? direction * strcmp(a->item.string, b->item.string) : (a->item.key > b->item.key) - (a->item.key < b->item.key);
+    if (comparison != 0) {
+      return comparison < 0;
+    }
+  }
+  // Equal keys are taken in dataset order, which keeps the merge stable.
+  return a->source < b->source;
+}
+
+/**
+ * Restores the heap property below a position of a binary min-heap of merge heads.
+ *
+ * @param struct merge_head *heap
+ *   The heap.
+ * @param int size
+ *   The number of heads in the heap.
+ * @param int position
+ *   The position whose head may be out of place.
+ * @param int direction
+ *   1 for string keys in ascending order, -1 in descending order.
+ */
+static void merge_sift_down(struct merge_head *heap, int size, int position, int direction) {
+  struct merge_head head = heap[position];
+  for (;;) {
+    int child = 2 * position + 1;
+    if (child >= size) {
+      break;
+    }
+    if (child + 1 < size && merge_head_before(&heap[child + 1], &heap[child], direction)) {
+      child++;
+    }
+    if (!merge_head_before(&heap[child], &head, direction)) {
+      break;
+    }
+    heap[position] = heap[child];
+    position = child;
+  }
+  heap[position] = head;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_merge_sorted(struct dataset **datasets, int count, enum data_row_side side, int column, enum data_entry_type type, enum dataset_sort_order order) {
+  // Check if the input params are valid.
+  if ((datasets == NULL && count > 0) || count < 0 || column < 0) {
+    return NULL;
+  }
+  if (type != DATA_ENTRY_TYPE_INT && type != DATA_ENTRY_TYPE_DOUBLE && type != DATA_ENTRY_TYPE_STRING) {
+    return NULL;
+  }
+  for (int i = 0; i < count; i++) {
+    if (datasets[i] == NULL) {
+      return NULL;
+    }
+  }
+  struct merge_head *heap = malloc(((size_t)count + 1) * sizeof(struct merge_head));
+  struct dataset *merged = dataset_create();
+  if (heap == NULL || merged == NULL) {
+    free(heap);
+    dataset_destroy(merged);
+    return NULL;
+  }
+  int direction = order == DATASET_SORT_DESCENDING ? -1 : 1;
+  // Build the heap from the first row of each dataset.
+  int size = 0;
+  for (int i = 0; i < count; i++) {
+    if (datasets[i]->iterator != NULL) {
+      heap[size].item.row = datasets[i]->iterator;
+      heap[size].source = i;
+      merge_head_load(&heap[size], side, column, type, order);
+      size++;
+    }
+  }
+  for (int i = size / 2 - 1; i >= 0; i--) {
+    merge_sift_down(heap, size, i, direction);
+  }
+  // Repeatedly move the first head to the merged dataset and replace it by its successor.
+  while (size > 0) {
+    struct data_row *row = heap[0].item.row;
+    struct data_row *next = row->next;
+    dataset_append_row(merged, row);
+    if (next != NULL) {
+      heap[0].item.row = next;
+      merge_head_load(&heap[0], side, column, type, order);
+    } else {
+      heap[0] = heap[--size];
+    }
+    merge_sift_down(heap, size, 0, direction);
+  }
+  // The rows now belong to the merged dataset.
+  for (int i = 0; i < count; i++) {
+    datasets[i]->iterator = NULL;
+    datasets[i]->last = NULL;
+    datasets[i]->size = 0;
+  }
+  free(heap);
+  return merged;
+}
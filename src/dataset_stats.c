@@ -0,0 +1,385 @@
+#include <stdlib.h>
+#include <math.h>
+#include "../include/dataset.h"
+
+// Number of values processed per block by the array kernels.
+#define STATS_BLOCK_SIZE 1024
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_column_stats_init(struct dataset_column_stats *stats) {
+  if (stats == NULL) {
+    // No action needed if stats is NULL.
+    return;
+  }
+  // Start with an empty set of values.
+  stats->count = 0;
+  stats->min = INFINITY;
+  stats->max = -INFINITY;
+  stats->mean = 0.0;
+  stats->m2 = 0.0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_column_stats_update(struct dataset_column_stats *stats, double value) {
+  if (stats == NULL) {
+    // No action needed if stats is NULL.
+    return;
+  }
+  // Update the extremes.
+  if (value < stats->min) {
+    stats->min = value;
+  }
+  if (value > stats->max) {
+    stats->max = value;
+  }
+  // Welford's update of the running mean and sum of squared differences.
+  stats->count++;
+  double delta = value - stats->mean;
+  stats->mean += delta / (double)stats->count;
+  stats->m2 += delta * (value - stats->mean);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_column_stats_merge(struct dataset_column_stats *stats, const struct dataset_column_stats *other) {
+  if (stats == NULL || other == NULL || other->count == 0) {
+    // Nothing to merge.
+    return;
+  }
+  if (stats->count == 0) {
+    // Merging into empty statistics is a plain copy.
+    *stats = *other;
+    return;
+  }
+  // Combine both partial results (Chan et al. parallel variance).
+  double count_a = (double)stats->count;
+  double count_b = (double)other->count;
+  double count = count_a + count_b;
+  double delta = other->mean - stats->mean;
+  stats->mean += delta * count_b / count;
+  stats->m2 += other->m2 + delta * delta * count_a * count_b / count;
+  stats->count += other->count;
+  // Combine the extremes.
+  if (other->min < stats->min) {
+    stats->min = other->min;
+  }
+  if (other->max > stats->max) {
+    stats->max = other->max;
+  }
+}
+
+/**
+ * Computes the statistics of a single block of contiguous values.
+ *
+ * The sum and the extremes are accumulated with four independent lanes so the
+ * loop carries no dependency between consecutive values, and the sum of squared
+ * differences is computed in a second pass over the block while it is still
+ * in cache.
+ *
+ * @param const double *values
+ *   The block of values.
+ * @param size_t size
+ *   The number of values in the block, greater than 0.
+ * @param struct dataset_column_stats *block
+ *   A pointer to the statistics to populate.
+ */
+static void column_stats_block(const double *restrict values, size_t size, struct dataset_column_stats *block) {
+  double sum[4] = {0.0, 0.0, 0.0, 0.0};
+  double min[4] = {INFINITY, INFINITY, INFINITY, INFINITY};
+  double max[4] = {-INFINITY, -INFINITY, -INFINITY, -INFINITY};
+  size_t i = 0;
+  // Accumulate four lanes at a time.
+  for (; i + 4 <= size; i += 4) {
+    for (int lane = 0; lane < 4; lane++) {
+      double value = values[i + lane];
+      sum[lane] += value;
+      min[lane] = value < min[lane] ? value : min[lane];
+      max[lane] = value > max[lane] ? value : max[lane];
+    }
+  }
+  // Accumulate the remaining values in the first lane.
+  for (; i < size; i++) {
+    sum[0] += values[i];
+    min[0] = values[i] < min[0] ? values[i] : min[0];
+    max[0] = values[i] > max[0] ? values[i] : max[0];
+  }
+  // Reduce the lanes.
+  block->count = size;
+  block->mean = (sum[0] + sum[1] + sum[2] + sum[3]) / (double)size;
+  block->min = min[0];
+  block->max = max[0];
+  for (int lane = 1; lane < 4; lane++) {
+    block->min = min[lane] < block->min ? min[lane] : block->min;
+    block->max = max[lane] > block->max ? max[lane] : block->max;
+  }
+  // Sum of squared differences from the block mean.
+  double m2 = 0.0;
+  for (i = 0; i < size; i++) {
+    double delta = values[i] - block->mean;
+    m2 += delta * delta;
+  }
+  block->m2 = m2;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_column_stats_update_array(struct dataset_column_stats *stats, const double *values, size_t size) {
+  if (stats == NULL || values == NULL) {
+    // No action needed if the parameters are NULL.
+    return;
+  }
+  // Process the array block by block and merge each block into the running stats.
+  for (size_t offset = 0; offset < size; offset += STATS_BLOCK_SIZE) {
+    size_t block_size = size - offset < STATS_BLOCK_SIZE ? size - offset : STATS_BLOCK_SIZE;
+    struct dataset_column_stats block;
+    column_stats_block(values + offset, block_size, &block);
+    dataset_column_stats_merge(stats, &block);
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+double dataset_column_stats_variance(const struct dataset_column_stats *stats) {
+  if (stats == NULL || stats->count == 0) {
+    // The variance of an empty set is defined as 0.
+    return 0.0;
+  }
+  return stats->m2 / (double)stats->count;
+}
+
+/**
+ * Gets the data entry at the given column of a row, if it exists.
+ *
+ * @param struct data_row *row
+ *   The data row.
+ * @param enum data_row_side side
+ *   Whether the column belongs to the inputs or to the outputs of the row.
+ * @param int column
+ *   The index of the column.
+ *
+ * @return struct data_entry*
+ *   The data entry, or NULL if the row has no such column.
+ */
+static struct data_entry *column_entry(struct data_row *row, enum data_row_side side, int column) {
+  struct data_entries *entries = data_row_get_entries(row, side);
+  if (entries == NULL || column >= entries->size) {
+    return NULL;
+  }
+  struct data_entry *entry = entries->entries[column];
+  if (entry == NULL || entry->data == NULL) {
+    return NULL;
+  }
+  return entry;
+}
+
+/**
+ * Reads the numeric value stored in a data entry.
+ *
+ * @param struct data_entry *entry
+ *   The data entry, which must not be NULL.
+ * @param enum data_entry_type type
+ *   The type of the entry, either DATA_ENTRY_TYPE_INT or DATA_ENTRY_TYPE_DOUBLE.
+ *
+ * @return double
+ *   The value of the entry.
+ */
+static double column_entry_value(struct data_entry *entry, enum data_entry_type type) {
+  if (type == DATA_ENTRY_TYPE_INT) {
+    return (double)*(int *)entry->data;
+  }
+  return *(double *)entry->data;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_column_stats(struct dataset *data, enum data_row_side side, int column, enum data_entry_type type, struct dataset_column_stats *stats) {
+  // Check if the input params are valid.
+  if (data == NULL || stats == NULL || column < 0) {
+    return -1;
+  }
+  if (type != DATA_ENTRY_TYPE_INT && type != DATA_ENTRY_TYPE_DOUBLE) {
+    return -1;
+  }
+  // Accumulate every value of the column in a single pass.
+  dataset_column_stats_init(stats);
+  struct data_row *current = data->iterator;
+  while (current != NULL) {
+    struct data_entry *entry = column_entry(current, side, column);
+    if (entry != NULL) {
+      dataset_column_stats_update(stats, column_entry_value(entry, type));
+    }
+    current = current->next;
+  }
+  // Return a success response.
+  return 0;
+}
+
+/**
+ * Applies the affine transformation `(value - offset) * scale` to a column in place.
+ *
+ * Integer entries are converted to double entries by replacing their payload.
+ * Every replacement is allocated before any entry is modified, so a failure
+ * leaves the column unchanged. The payloads of rows held by a bulk storage have
+ * room for a double already.
+ *
+ * @param struct dataset *data
+ *   The dataset.
+ * @param enum data_row_side side
+ *   Whether the column belongs to the inputs or to the outputs of the rows.
+ * @param int column
+ *   The index of the column.
+ * @param enum data_entry_type type
+ *   The type of the column entries.
+ * @param double offset
+ *   The value subtracted from each entry.
+ * @param double scale
+ *   The factor applied to each entry after the subtraction.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the payloads could not be allocated.
+ */
+static int column_rescale(struct dataset *data, enum data_row_side side, int column, enum data_entry_type type, double offset, double scale) {
+  // Count the integer payloads too small to hold a double.
+  size_t replaced = 0;
+  for (struct data_row *current = data->iterator; type == DATA_ENTRY_TYPE_INT && current != NULL; current = current->next) {
+    replaced += current->storage == NULL && column_entry(current, side, column) != NULL;
+  }
+  double **payloads = replaced > 0 ? malloc(replaced * sizeof(double *)) : NULL;
+  if (replaced > 0 && payloads == NULL) {
+    return -1;
+  }
+  for (size_t i = 0; i < replaced; i++) {
+    payloads[i] = malloc(sizeof(double));
+    if (payloads[i] == NULL) {
+      while (i > 0) {
+        free(payloads[--i]);
+      }
+      free(payloads);
+      return -1;
+    }
+  }
+  // Nothing can fail from here on, rescale the entries and swap in the new payloads.
+  size_t next = 0;
+  for (struct data_row *current = data->iterator; current != NULL; current = current->next) {
+    struct data_entry *entry = column_entry(current, side, column);
+    if (entry == NULL) {
+      continue;
+    }
+    double value = (column_entry_value(entry, type) - offset) * scale;
+    if (type == DATA_ENTRY_TYPE_INT && current->storage == NULL) {
+      free(entry->data);
+      entry->data = payloads[next++];
+    }
+    *(double *)entry->data = value;
+  }
+  free(payloads);
+  return 0;
+}
+
+/**
+ * Resolves the statistics used by a rescaling operation.
+ *
+ * @param struct dataset *data
+ *   The dataset.
+ * @param enum data_row_side side
+ *   Whether the column belongs to the inputs or to the outputs of the rows.
+ * @param int column
+ *   The index of the column.
+ * @param enum data_entry_type type
+ *   The type of the column entries.
+ * @param const struct dataset_column_stats *stats
+ *   The statistics given by the caller, or NULL.
+ * @param struct dataset_column_stats *resolved
+ *   The statistics to populate.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 if the parameters are invalid.
+ */
+static int column_resolve_stats(struct dataset *data, enum data_row_side side, int column, enum data_entry_type type, const struct dataset_column_stats *stats, struct dataset_column_stats *resolved) {
+  if (stats != NULL) {
+    if (data == NULL || column < 0 || (type != DATA_ENTRY_TYPE_INT && type != DATA_ENTRY_TYPE_DOUBLE)) {
+      return -1;
+    }
+    *resolved = *stats;
+    return 0;
+  }
+  return dataset_column_stats(data, side, column, type, resolved);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_normalize(struct dataset *data, enum data_row_side side, int column, enum data_entry_type type, const struct dataset_column_stats *stats) {
+  struct dataset_column_stats resolved;
+  if (column_resolve_stats(data, side, column, type, stats, &resolved) != 0) {
+    return -1;
+  }
+  // A constant column is mapped to 0.
+  double range = resolved.max - resolved.min;
+  double scale = range > 0.0 ? 1.0 / range : 0.0;
+  return column_rescale(data, side, column, type, resolved.min, scale);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_standardize(struct dataset *data, enum data_row_side side, int column, enum data_entry_type type, const struct dataset_column_stats *stats) {
+  struct dataset_column_stats resolved;
+  if (column_resolve_stats(data, side, column, type, stats, &resolved) != 0) {
+    return -1;
+  }
+  // A constant column is mapped to 0.
+  double deviation = sqrt(dataset_column_stats_variance(&resolved));
+  double scale = deviation > 0.0 ? 1.0 / deviation : 0.0;
+  return column_rescale(data, side, column, type, resolved.mean, scale);
+}
+
+/**
+ * Applies the affine transformation `(value - offset) * scale` to an array in place.
+ *
+ * @param double *values
+ *   The array of values.
+ * @param size_t size
+ *   The number of values in the array.
+ * @param double offset
+ *   The value subtracted from each value.
+ * @param double scale
+ *   The factor applied to each value after the subtraction.
+ */
+static void array_rescale(double *restrict values, size_t size, double offset, double scale) {
+  for (size_t i = 0; i < size; i++) {
+    values[i] = (values[i] - offset) * scale;
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_normalize_array(double *values, size_t size, const struct dataset_column_stats *stats) {
+  if (values == NULL || stats == NULL) {
+    // No action needed if the parameters are NULL.
+    return;
+  }
+  double range = stats->max - stats->min;
+  array_rescale(values, size, stats->min, range > 0.0 ? 1.0 / range : 0.0);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_standardize_array(double *values, size_t size, const struct dataset_column_stats *stats) {
+  if (values == NULL || stats == NULL) {
+    // No action needed if the parameters are NULL.
+    return;
+  }
+  double deviation = sqrt(dataset_column_stats_variance(stats));
+  array_rescale(values, size, stats->mean, deviation > 0.0 ? 1.0 / deviation : 0.0);
+}
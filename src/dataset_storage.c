@@ -0,0 +1,107 @@
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "../include/dataset.h"
+
+/**
+ * The alignment of the storages backed by huge pages.
+ */
+#define STORAGE_HUGE_PAGE_SIZE (2 << 20)
+
+/**
+ * Creates a storage with a memory block of the given size and alignment.
+ *
+ * @param size_t size
+ *   The size of the memory block in bytes.
+ * @param size_t alignment
+ *   The alignment of the memory block, a power of two multiple of `sizeof(void *)`.
+ *
+ * @return struct dataset_storage*
+ *   A pointer to the newly created storage, or NULL on failure.
+ */
+static struct dataset_storage *storage_create_aligned(size_t size, size_t alignment) {
+  // Allocate memory for the storage structure.
+  struct dataset_storage *storage = malloc(sizeof(struct dataset_storage));
+  if (storage == NULL) {
+    // Memory allocation failed.
+    return NULL;
+  }
+  // Allocate the memory block, at least one byte so an empty storage is valid.
+  void *memory = NULL;
+  if (posix_memalign(&memory, alignment, size > 0 ? size : 1) != 0) {
+    free(storage);
+    return NULL;
+  }
+  storage->memory = memory;
+  storage->references = 0;
+  storage->size = size;
+  // Return the newly created storage.
+  return storage;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_storage *dataset_storage_create(size_t size) {
+  return storage_create_aligned(size, DATASET_STORAGE_ALIGNMENT);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_storage *dataset_storage_create_huge(size_t size) {
+  // Round the size up to whole huge pages so the advice covers the whole block.
+  size_t rounded = size + (STORAGE_HUGE_PAGE_SIZE - 1);
+  if (rounded < size) {
+    return NULL;
+  }
+  rounded -= rounded % STORAGE_HUGE_PAGE_SIZE;
+  struct dataset_storage *storage = storage_create_aligned(rounded, STORAGE_HUGE_PAGE_SIZE);
+  if (storage == NULL) {
+    return NULL;
+  }
+  storage->size = size;
+#ifdef MADV_HUGEPAGE
+  if (rounded > 0) {
+    // The advice is only a hint, a failure leaves regular pages.
+    madvise(storage->memory, rounded, MADV_HUGEPAGE);
+  }
+#endif
+  return storage;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_storage_retain(struct dataset_storage *storage, size_t references) {
+  if (storage == NULL) {
+    return;
+  }
+  // Rows can be destroyed from several threads, so the count is updated atomically.
+  __atomic_add_fetch(&storage->references, references, __ATOMIC_RELAXED);
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_storage_release(struct dataset_storage *storage) {
+  if (storage == NULL) {
+    return;
+  }
+  // The last release frees the storage.
+  if (__atomic_sub_fetch(&storage->references, 1, __ATOMIC_ACQ_REL) == 0) {
+    dataset_storage_destroy(storage);
+  }
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_storage_destroy(struct dataset_storage *storage) {
+  if (storage == NULL) {
+    // No action needed if storage is NULL.
+    return;
+  }
+  // Free the memory block and the storage itself.
+  free(storage->memory);
+  free(storage);
+}
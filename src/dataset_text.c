@@ -0,0 +1,624 @@
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <matrixmath.h>
+#include "../include/dataset.h"
+
+/**
+ * The size of the buffer used to write a whole dataset.
+ */
+#define TEXT_BUFFER_SIZE (1 << 20)
+
+/**
+ * The size of the buffer used to write a single entry.
+ */
+#define TEXT_ENTRY_BUFFER_SIZE 256
+
+/**
+ * The room reserved for a formatted number.
+ */
+#define TEXT_NUMBER_SIZE 32
+
+/**
+ * Represents a buffered text writer over a stream or a file descriptor.
+ */
+struct text_writer {
+  /**
+   * The stream to write to, or NULL to write to the file descriptor.
+   *
+   * @var FILE *
+   */
+  FILE *stream;
+
+  /**
+   * The file descriptor to write to when there is no stream.
+   *
+   * @var int
+   */
+  int fd;
+
+  /**
+   * The buffer and the number of bytes it holds.
+   */
+  char *buffer;
+  size_t size;
+  size_t capacity;
+
+  /**
+   * The text format and the significant digits of the doubles.
+   */
+  enum dataset_text_format format;
+  int precision;
+
+  /**
+   * Whether a write failed, in which case the following writes are dropped.
+   *
+   * @var int
+   */
+  int error;
+};
+
+/**
+ * Writes a block of bytes to the destination of the writer, bypassing the buffer.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param const char *bytes
+ *   The bytes.
+ * @param size_t size
+ *   The number of bytes.
+ */
+static void text_write_through(struct text_writer *writer, const char *bytes, size_t size) {
+  if (writer->error || size == 0) {
+    return;
+  }
+  if (writer->stream != NULL) {
+    writer->error = fwrite(bytes, 1, size, writer->stream) != size;
+    return;
+  }
+  // Write to the file descriptor, resuming partial writes.
+  while (size > 0) {
+    ssize_t written = write(writer->fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      writer->error = 1;
+      return;
+    }
+    bytes += written;
+    size -= (size_t)written;
+  }
+}
+
+/**
+ * Writes the content of the buffer and empties it.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ */
+static void text_flush(struct text_writer *writer) {
+  text_write_through(writer, writer->buffer, writer->size);
+  writer->size = 0;
+}
+
+/**
+ * Makes room in the buffer.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param size_t size
+ *   The number of bytes needed, at most the capacity of the buffer.
+ *
+ * @return char*
+ *   The free space of the buffer.
+ */
+static char *text_reserve(struct text_writer *writer, size_t size) {
+  if (writer->capacity - writer->size < size) {
+    text_flush(writer);
+  }
+  return writer->buffer + writer->size;
+}
+
+/**
+ * Appends bytes to the buffer.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param const char *bytes
+ *   The bytes.
+ * @param size_t size
+ *   The number of bytes.
+ */
+static void text_append(struct text_writer *writer, const char *bytes, size_t size) {
+  if (size > writer->capacity) {
+    // Large blocks go straight to the destination.
+    text_flush(writer);
+    text_write_through(writer, bytes, size);
+    return;
+  }
+  memcpy(text_reserve(writer, size), bytes, size);
+  writer->size += size;
+}
+
+/**
+ * Appends a null-terminated string to the buffer.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param const char *text
+ *   The string.
+ */
+static void text_puts(struct text_writer *writer, const char *text) {
+  text_append(writer, text, strlen(text));
+}
+
+/**
+ * Appends a single character to the buffer.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param char character
+ *   The character.
+ */
+static void text_putc(struct text_writer *writer, char character) {
+  *text_reserve(writer, 1) = character;
+  writer->size++;
+}
+
+/**
+ * Formats an integer into a buffer.
+ *
+ * @param char *destination
+ *   The buffer, with room for at least 20 characters.
+ * @param long long value
+ *   The integer.
+ *
+ * @return size_t
+ *   The number of characters written.
+ */
+static size_t text_format_integer(char *destination, long long value) {
+  // Work on the magnitude as unsigned so the lowest value does not overflow.
+  unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+  char digits[20];
+  size_t count = 0;
+  do {
+    digits[count++] = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+  size_t length = 0;
+  if (value < 0) {
+    destination[length++] = '-';
+  }
+  while (count > 0) {
+    destination[length++] = digits[--count];
+  }
+  return length;
+}
+
+/**
+ * Appends an integer to the buffer.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param long long value
+ *   The integer.
+ */
+static void text_integer(struct text_writer *writer, long long value) {
+  writer->size += text_format_integer(text_reserve(writer, TEXT_NUMBER_SIZE), value);
+}
+
+/**
+ * Appends a double to the buffer, formatted like `%.*g` with the precision of the writer.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param double value
+ *   The double.
+ */
+static void text_double(struct text_writer *writer, double value) {
+  char *destination = text_reserve(writer, TEXT_NUMBER_SIZE);
+  if (!isfinite(value) && writer->format == DATASET_TEXT_JSON_LINES) {
+    // JSON has no representation of NaN and infinities.
+    memcpy(destination, "null", 4);
+    writer->size += 4;
+    return;
+  }
+  // Whole numbers below the exponent threshold of %g print as plain integers,
+  // which covers one-hot vectors and integer valued features.
+  double limit = writer->precision < 16 ? 1e6 : 9007199254740992.0;
+  if (value == trunc(value) && fabs(value) < limit && !(value == 0 && signbit(value))) {
+    writer->size += text_format_integer(destination, (long long)value);
+    return;
+  }
+  int length = snprintf(destination, TEXT_NUMBER_SIZE, "%.*g", writer->precision, value);
+  writer->size += length > 0 ? (size_t)length : 0;
+}
+
+/**
+ * Appends a string, quoted and escaped as the format requires.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param const char *text
+ *   The null-terminated string.
+ */
+static void text_string(struct text_writer *writer, const char *text) {
+  if (writer->format == DATASET_TEXT_PLAIN) {
+    text_putc(writer, '\'');
+    text_puts(writer, text);
+    text_putc(writer, '\'');
+    return;
+  }
+  if (writer->format == DATASET_TEXT_CSV) {
+    // Only fields holding separators, quotes or line breaks are quoted.
+    if (strpbrk(text, ",\"\r\n") == NULL) {
+      text_puts(writer, text);
+      return;
+    }
+    text_putc(writer, '"');
+    for (const char *next; (next = strchr(text, '"')) != NULL; text = next + 1) {
+      text_append(writer, text, (size_t)(next - text) + 1);
+      text_putc(writer, '"');
+    }
+    text_puts(writer, text);
+    text_putc(writer, '"');
+    return;
+  }
+  // Escape quotes, backslashes and control characters for JSON, copying the runs between them.
+  static const char hex[] = "0123456789abcdef";
+  text_putc(writer, '"');
+  const char *run = text;
+  for (; *text != '\0'; text++) {
+    unsigned char character = (unsigned char)*text;
+    if (character >= 0x20 && character != '"' && character != '\\') {
+      continue;
+    }
+    text_append(writer, run, (size_t)(text - run));
+    run = text + 1;
+    char escape[6] = {'\\', (char)character, 0, 0, 0, 0};
+    size_t length = 2;
+    if (character == '\n') {
+      escape[1] = 'n';
+    } else if (character == '\t') {
+      escape[1] = 't';
+    } else if (character == '\r') {
+      escape[1] = 'r';
+    } else if (character < 0x20) {
+      memcpy(escape, "\\u00", 4);
+      escape[4] = hex[character >> 4];
+      escape[5] = hex[character & 0xf];
+      length = 6;
+    }
+    text_append(writer, escape, length);
+  }
+  text_append(writer, run, (size_t)(text - run));
+  text_putc(writer, '"');
+}
+
+/**
+ * Appends the separator between two values of the format.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ */
+static void text_separator(struct text_writer *writer) {
+  if (writer->format == DATASET_TEXT_PLAIN) {
+    text_append(writer, ", ", 2);
+  } else {
+    text_putc(writer, ',');
+  }
+}
+
+/**
+ * Appends a vector, as a list in the plain and JSON formats or as fields in CSV.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param const struct vector *vector
+ *   The vector.
+ */
+static void text_vector(struct text_writer *writer, const struct vector *vector) {
+  int csv = writer->format == DATASET_TEXT_CSV;
+  if (!csv) {
+    text_putc(writer, '[');
+  }
+  for (int i = 0; i < vector->length; i++) {
+    if (i != 0) {
+      text_separator(writer);
+    }
+    text_double(writer, vector->elements[i]);
+  }
+  if (!csv) {
+    text_putc(writer, ']');
+  }
+}
+
+/**
+ * Appends a sparse vector, as index/value pairs in the plain and JSON formats or as dense fields in CSV.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param const struct dataset_sparse_vector *sparse
+ *   The sparse vector.
+ */
+static void text_sparse(struct text_writer *writer, const struct dataset_sparse_vector *sparse) {
+  if (writer->format == DATASET_TEXT_PLAIN) {
+    text_putc(writer, '{');
+    for (int i = 0; i < sparse->size; i++) {
+      if (i != 0) {
+        text_separator(writer);
+      }
+      text_integer(writer, sparse->indices[i]);
+      text_append(writer, ": ", 2);
+      text_double(writer, sparse->values[i]);
+    }
+    text_putc(writer, '}');
+  } else if (writer->format == DATASET_TEXT_CSV) {
+    // Expand the vector, the indices are in increasing order.
+    int next = 0;
+    for (int i = 0; i < sparse->dimension; i++) {
+      if (i != 0) {
+        text_separator(writer);
+      }
+      if (next < sparse->size && sparse->indices[next] == i) {
+        text_double(writer, sparse->values[next++]);
+      } else {
+        text_putc(writer, '0');
+      }
+    }
+  } else {
+    text_puts(writer, "{\"dimension\":");
+    text_integer(writer, sparse->dimension);
+    text_puts(writer, ",\"indices\":[");
+    for (int i = 0; i < sparse->size; i++) {
+      if (i != 0) {
+        text_separator(writer);
+      }
+      text_integer(writer, sparse->indices[i]);
+    }
+    text_puts(writer, "],\"values\":[");
+    for (int i = 0; i < sparse->size; i++) {
+      if (i != 0) {
+        text_separator(writer);
+      }
+      text_double(writer, sparse->values[i]);
+    }
+    text_puts(writer, "]}");
+  }
+}
+
+/**
+ * Appends a data entry.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param struct data_entry *entry
+ *   The entry, possibly NULL.
+ * @param enum data_entry_type type
+ *   The type of the entry.
+ */
+static void text_entry(struct text_writer *writer, struct data_entry *entry, enum data_entry_type type) {
+  if (entry == NULL || entry->data == NULL) {
+    // Missing values are an empty field in CSV and null in JSON.
+    if (writer->format == DATASET_TEXT_PLAIN) {
+      text_puts(writer, "Invalid data entry.\n");
+    } else if (writer->format == DATASET_TEXT_JSON_LINES) {
+      text_puts(writer, "null");
+    }
+    return;
+  }
+  switch (type) {
+    case DATA_ENTRY_TYPE_INT:
+      text_integer(writer, *(int *)entry->data);
+      break;
+    case DATA_ENTRY_TYPE_DOUBLE:
+      text_double(writer, *(double *)entry->data);
+      break;
+    case DATA_ENTRY_TYPE_STRING:
+      text_string(writer, (char *)entry->data);
+      break;
+    case DATA_ENTRY_TYPE_VECTOR:
+      text_vector(writer, (struct vector *)entry->data);
+      break;
+    case DATA_ENTRY_TYPE_SPARSE:
+      text_sparse(writer, (struct dataset_sparse_vector *)entry->data);
+      break;
+  }
+}
+
+/**
+ * Appends a collection of entries, separated as the format requires.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param struct data_entries *entries
+ *   The entries, possibly NULL.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ * @param int first
+ *   Whether no value of the line was written yet, for the CSV separators.
+ *
+ * @return int
+ *   Whether no value of the line was written yet after the entries.
+ */
+static int text_entries(struct text_writer *writer, struct data_entries *entries, enum data_entry_type type, int first) {
+  if (entries == NULL) {
+    return first;
+  }
+  for (int64_t i = 0; i < entries->size; i++) {
+    if (writer->format == DATASET_TEXT_PLAIN) {
+      // The plain format skips the missing entries, as data_entries_print does.
+      if (entries->entries[i] == NULL) {
+        continue;
+      }
+      if (i != 0) {
+        text_separator(writer);
+      }
+    } else if (!first) {
+      text_separator(writer);
+    }
+    text_entry(writer, entries->entries[i], type);
+    first = 0;
+  }
+  return first;
+}
+
+/**
+ * Appends a row, terminated by a line break.
+ *
+ * @param struct text_writer *writer
+ *   The writer.
+ * @param struct data_row *row
+ *   The row.
+ * @param int64_t number
+ *   The number of the row, starting at 1.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ */
+static void text_row(struct text_writer *writer, struct data_row *row, int64_t number, enum data_entry_type type) {
+  if (writer->format == DATASET_TEXT_PLAIN) {
+    text_puts(writer, "Row #");
+    text_integer(writer, number);
+    text_puts(writer, ": Input [");
+    text_entries(writer, row->inputs, type, 1);
+    text_puts(writer, "] - Output [");
+    text_entries(writer, row->outputs, type, 1);
+    text_puts(writer, "]\n");
+  } else if (writer->format == DATASET_TEXT_CSV) {
+    text_entries(writer, row->outputs, type, text_entries(writer, row->inputs, type, 1));
+    text_putc(writer, '\n');
+  } else {
+    text_puts(writer, "{\"inputs\":[");
+    text_entries(writer, row->inputs, type, 1);
+    text_puts(writer, "],\"outputs\":[");
+    text_entries(writer, row->outputs, type, 1);
+    text_puts(writer, "]}\n");
+  }
+}
+
+/**
+ * Initializes a writer.
+ *
+ * @param struct text_writer *writer
+ *   The writer to initialize.
+ * @param FILE *stream
+ *   The stream to write to, or NULL to write to the file descriptor.
+ * @param int fd
+ *   The file descriptor to write to.
+ * @param char *buffer
+ *   The buffer.
+ * @param size_t capacity
+ *   The size of the buffer, at least TEXT_NUMBER_SIZE.
+ * @param enum dataset_text_format format
+ *   The text format.
+ */
+static void text_writer_init(struct text_writer *writer, FILE *stream, int fd, char *buffer, size_t capacity, enum dataset_text_format format) {
+  writer->stream = stream;
+  writer->fd = fd;
+  writer->buffer = buffer;
+  writer->size = 0;
+  writer->capacity = capacity;
+  writer->format = format;
+  writer->precision = format == DATASET_TEXT_PLAIN ? 6 : 17;
+  writer->error = 0;
+}
+
+/**
+ * Checks whether an entry type and a text format are known.
+ *
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ * @param enum dataset_text_format format
+ *   The text format.
+ *
+ * @return int
+ *   Returns 1 if both are valid, or 0 otherwise.
+ */
+static int text_valid(enum data_entry_type type, enum dataset_text_format format) {
+  return type >= DATA_ENTRY_TYPE_INT && type <= DATA_ENTRY_TYPE_SPARSE && format >= DATASET_TEXT_PLAIN && format <= DATASET_TEXT_JSON_LINES;
+}
+
+/**
+ * Writes a dataset through a writer.
+ *
+ * @param struct dataset *data
+ *   The dataset.
+ * @param FILE *stream
+ *   The stream to write to, or NULL to write to the file descriptor.
+ * @param int fd
+ *   The file descriptor to write to.
+ * @param enum data_entry_type type
+ *   The type of the entries.
+ * @param enum dataset_text_format format
+ *   The text format.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int text_write_dataset(struct dataset *data, FILE *stream, int fd, enum data_entry_type type, enum dataset_text_format format) {
+  if (data == NULL || !text_valid(type, format)) {
+    return -1;
+  }
+  char *buffer = malloc(TEXT_BUFFER_SIZE);
+  if (buffer == NULL) {
+    return -1;
+  }
+  struct text_writer writer;
+  text_writer_init(&writer, stream, fd, buffer, TEXT_BUFFER_SIZE, format);
+  if (format == DATASET_TEXT_PLAIN) {
+    text_puts(&writer, "-----------------------------------------------\nDataset: # rows ");
+    text_integer(&writer, data->size);
+    text_puts(&writer, ".\n");
+  }
+  // Write the rows, the buffer is reused for the whole dataset.
+  struct dataset_cursor cursor;
+  int64_t number = 1;
+  for (struct data_row *row = dataset_cursor_begin(&cursor, data); row != NULL && !writer.error; row = dataset_cursor_next(&cursor)) {
+    text_row(&writer, row, number++, type);
+  }
+  if (format == DATASET_TEXT_PLAIN) {
+    text_puts(&writer, "-----------------------------------------------\n");
+  }
+  text_flush(&writer);
+  free(buffer);
+  return writer.error ? -1 : 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int data_entry_write_text(struct data_entry *entry, FILE *stream, enum data_entry_type type, enum dataset_text_format format) {
+  if (stream == NULL || !text_valid(type, format)) {
+    return -1;
+  }
+  // A single entry is small, a buffer on the stack is enough.
+  char buffer[TEXT_ENTRY_BUFFER_SIZE];
+  struct text_writer writer;
+  text_writer_init(&writer, stream, -1, buffer, sizeof(buffer), format);
+  text_entry(&writer, entry, type);
+  text_flush(&writer);
+  return writer.error ? -1 : 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_write_text(struct dataset *data, FILE *stream, enum data_entry_type type, enum dataset_text_format format) {
+  if (stream == NULL) {
+    return -1;
+  }
+  return text_write_dataset(data, stream, -1, type, format);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_write_text_fd(struct dataset *data, int fd, enum data_entry_type type, enum dataset_text_format format) {
+  if (fd < 0) {
+    return -1;
+  }
+  return text_write_dataset(data, NULL, fd, type, format);
+}
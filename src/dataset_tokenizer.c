@@ -0,0 +1,265 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/dataset.h"
+
+/**
+ * Grows the tables of a tokenizer so they hold its current number of nodes.
+ *
+ * The capacity doubles when it is exceeded, and the new rows have no transition
+ * and accept no token.
+ *
+ * @param struct dataset_tokenizer *tokenizer
+ *   The tokenizer.
+ * @param int *capacity
+ *   The number of nodes the tables can hold, updated when they grow.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 on failure.
+ */
+static int tokenizer_reserve(struct dataset_tokenizer *tokenizer, int *capacity) {
+  if (tokenizer->states <= *capacity) {
+    return 0;
+  }
+  size_t classes = (size_t)tokenizer->classes;
+  size_t grown = *capacity > 0 ? (size_t)*capacity * 2 : 16;
+  if (grown > INT32_MAX) {
+    grown = INT32_MAX;
+  }
+  if (grown > SIZE_MAX / sizeof(int) / classes) {
+    return -1;
+  }
+  int *transitions = realloc(tokenizer->transitions, grown * classes * sizeof(int));
+  if (transitions == NULL) {
+    return -1;
+  }
+  tokenizer->transitions = transitions;
+  int *accepts = realloc(tokenizer->accepts, grown * sizeof(int));
+  if (accepts == NULL) {
+    return -1;
+  }
+  tokenizer->accepts = accepts;
+  memset(transitions + (size_t)*capacity * classes, -1, (grown - (size_t)*capacity) * classes * sizeof(int));
+  memset(accepts + *capacity, -1, (grown - (size_t)*capacity) * sizeof(int));
+  *capacity = (int)grown;
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_tokenizer *dataset_tokenizer_create(char **vocabulary, int vocabulary_size) {
+  // Check if the input params are valid.
+  if (vocabulary == NULL || vocabulary_size <= 0) {
+    return NULL;
+  }
+  // Allocate memory for the tokenizer structure.
+  struct dataset_tokenizer *tokenizer = calloc(1, sizeof(struct dataset_tokenizer));
+  if (tokenizer == NULL) {
+    // Memory allocation failed.
+    return NULL;
+  }
+  // Give a column to each byte used by the vocabulary, column 0 is shared by the others.
+  tokenizer->classes = 1;
+  for (int i = 0; i < vocabulary_size; i++) {
+    if (vocabulary[i] == NULL) {
+      continue;
+    }
+    for (const unsigned char *byte = (const unsigned char *)vocabulary[i]; *byte != '\0'; byte++) {
+      if (tokenizer->byte_class[*byte] == 0) {
+        tokenizer->byte_class[*byte] = tokenizer->classes++;
+      }
+    }
+  }
+  // Start with the root alone, the table grows as nodes are added.
+  int capacity = 0;
+  tokenizer->states = 1;
+  if (tokenizer_reserve(tokenizer, &capacity) != 0) {
+    dataset_tokenizer_destroy(tokenizer);
+    return NULL;
+  }
+  size_t classes = (size_t)tokenizer->classes;
+  // Insert every token into the trie.
+  for (int i = 0; i < vocabulary_size; i++) {
+    if (vocabulary[i] == NULL || vocabulary[i][0] == '\0') {
+      continue;
+    }
+    int state = 0;
+    for (const unsigned char *byte = (const unsigned char *)vocabulary[i]; *byte != '\0'; byte++) {
+      size_t transition = (size_t)state * classes + tokenizer->byte_class[*byte];
+      if (tokenizer->transitions[transition] < 0) {
+        if (tokenizer->states == INT32_MAX) {
+          dataset_tokenizer_destroy(tokenizer);
+          return NULL;
+        }
+        tokenizer->states++;
+        if (tokenizer_reserve(tokenizer, &capacity) != 0) {
+          dataset_tokenizer_destroy(tokenizer);
+          return NULL;
+        }
+        tokenizer->transitions[transition] = tokenizer->states - 1;
+      }
+      state = tokenizer->transitions[transition];
+    }
+    // Keep the first id of duplicated tokens, as find_token_index does.
+    if (tokenizer->accepts[state] < 0) {
+      tokenizer->accepts[state] = i;
+    }
+  }
+  // Release the rows of the table that were not used.
+  int *transitions = realloc(tokenizer->transitions, (size_t)tokenizer->states * classes * sizeof(int));
+  if (transitions != NULL) {
+    tokenizer->transitions = transitions;
+  }
+  int *accepts = realloc(tokenizer->accepts, (size_t)tokenizer->states * sizeof(int));
+  if (accepts != NULL) {
+    tokenizer->accepts = accepts;
+  }
+  // Return the newly created tokenizer.
+  return tokenizer;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_tokenizer_destroy(struct dataset_tokenizer *tokenizer) {
+  if (tokenizer == NULL) {
+    // No action needed if tokenizer is NULL.
+    return;
+  }
+  // Free the tables and the tokenizer structure itself.
+  free(tokenizer->transitions);
+  free(tokenizer->accepts);
+  free(tokenizer);
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_tokenizer_encode(const struct dataset_tokenizer *tokenizer, const char *string, int *ids) {
+  // Check if the input params are valid.
+  if (tokenizer == NULL || string == NULL || ids == NULL) {
+    return -1;
+  }
+  const unsigned char *bytes = (const unsigned char *)string;
+  const int *transitions = tokenizer->transitions;
+  const int *accepts = tokenizer->accepts;
+  size_t classes = (size_t)tokenizer->classes;
+  int count = 0;
+  size_t position = 0;
+  while (bytes[position] != '\0') {
+    // Walk the trie as far as possible, remembering the longest accepted token.
+    int state = 0;
+    int token = -1;
+    size_t token_end = position;
+    for (size_t i = position; bytes[i] != '\0'; i++) {
+      state = transitions[(size_t)state * classes + tokenizer->byte_class[bytes[i]]];
+      if (state < 0) {
+        break;
+      }
+      if (accepts[state] >= 0) {
+        token = accepts[state];
+        token_end = i + 1;
+      }
+    }
+    ids[count++] = token;
+    if (token >= 0) {
+      position = token_end;
+      continue;
+    }
+    // Unknown character: skip its lead byte and its UTF-8 continuation bytes.
+    position++;
+    for (int i = 0; i < 3 && (bytes[position] & 0xC0) == 0x80; i++) {
+      position++;
+    }
+  }
+  return count;
+}
+
+/**
+ * Encodes every string entry of a collection into a single collection of token ids.
+ *
+ * @param struct data_entries *raw_entries
+ *   The string data entries to be encoded.
+ * @param const struct dataset_tokenizer *tokenizer
+ *   The tokenizer.
+ *
+ * @return struct data_entries*
+ *   A new data entries containing the token ids, or NULL on failure.
+ */
+static struct data_entries *data_entries_tokenize(struct data_entries *raw_entries, const struct dataset_tokenizer *tokenizer) {
+  if (raw_entries == NULL) {
+    return NULL;
+  }
+  // Every token consumes at least one byte, so the total length bounds the ids.
+  size_t capacity = 0;
+  for (int64_t i = 0; i < raw_entries->size; i++) {
+    struct data_entry *entry = raw_entries->entries[i];
+    if (entry == NULL || entry->data == NULL) {
+      return NULL;
+    }
+    capacity += strlen((const char *)entry->data);
+  }
+  if (capacity >= SIZE_MAX / sizeof(int)) {
+    return NULL;
+  }
+  int *ids = malloc((capacity + 1) * sizeof(int));
+  if (ids == NULL) {
+    return NULL;
+  }
+  int64_t size = 0;
+  for (int64_t i = 0; i < raw_entries->size; i++) {
+    size += dataset_tokenizer_encode(tokenizer, (const char *)raw_entries->entries[i]->data, ids + size);
+  }
+  // Store the ids as integer entries.
+  struct data_entries *encoded_entries = data_entries_create(size);
+  if (encoded_entries == NULL) {
+    free(ids);
+    return NULL;
+  }
+  for (int64_t i = 0; i < size; i++) {
+    encoded_entries->entries[i] = data_entry_create_int(ids[i]);
+    if (encoded_entries->entries[i] == NULL) {
+      free(ids);
+      data_entries_destroy(encoded_entries);
+      return NULL;
+    }
+  }
+  free(ids);
+  return encoded_entries;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_tokenizer_encode_dataset(struct dataset *string_dataset, const struct dataset_tokenizer *tokenizer) {
+  // Check if the input parameters are NULL.
+  if (string_dataset == NULL || tokenizer == NULL) {
+    return NULL;
+  }
+  // Create a new dataset to hold the encoded rows.
+  struct dataset *encoded_dataset = dataset_create();
+  if (encoded_dataset == NULL) {
+    return NULL;
+  }
+  // Process each row in the raw dataset.
+  struct data_row *current = string_dataset->iterator;
+  while (current != NULL) {
+    struct data_row *encoded_row = data_row_create();
+    if (encoded_row == NULL) {
+      dataset_destroy(encoded_dataset);
+      return NULL;
+    }
+    encoded_row->inputs = data_entries_tokenize(current->inputs, tokenizer);
+    encoded_row->outputs = data_entries_tokenize(current->outputs, tokenizer);
+    if (encoded_row->inputs == NULL || encoded_row->outputs == NULL || dataset_append_row(encoded_dataset, encoded_row) != 0) {
+      data_row_destroy(encoded_row);
+      dataset_destroy(encoded_dataset);
+      return NULL;
+    }
+    // Move cursor to the next row in the dataset.
+    current = current->next;
+  }
+  // Return the new dataset containing the encoded rows.
+  return encoded_dataset;
+}
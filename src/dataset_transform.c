@@ -0,0 +1,314 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include "../include/dataset.h"
+
+/**
+ * Represents an operation applied in parallel to the rows of a dataset.
+ */
+struct transform_job {
+  /**
+   * The rows, indexed for random access.
+   *
+   * @var struct data_row **
+   */
+  struct data_row **rows;
+
+  /**
+   * The function applied to the rows, only one of them is set.
+   */
+  int (*predicate)(struct data_row *, void *);
+  struct data_row *(*map)(struct data_row *, void *);
+  int (*update)(struct data_row *, void *);
+
+  /**
+   * The context passed to the function.
+   *
+   * @var void *
+   */
+  void *context;
+
+  /**
+   * Whether each row matched the predicate.
+   *
+   * @var unsigned char *
+   */
+  unsigned char *keep;
+
+  /**
+   * The rows built by the map function.
+   *
+   * @var struct data_row **
+   */
+  struct data_row **results;
+
+  /**
+   * Whether the function failed for any row.
+   *
+   * @var int
+   */
+  int failed;
+};
+
+/**
+ * Represents the range of indices processed by one thread.
+ */
+struct parallel_range {
+  void (*worker)(void *, int, int);
+  void *context;
+  int begin;
+  int end;
+};
+
+/**
+ * Runs the worker of a range.
+ *
+ * @param void *argument
+ *   The range, as a `struct parallel_range *`.
+ *
+ * @return void*
+ *   Always NULL.
+ */
+static void *parallel_worker(void *argument) {
+  struct parallel_range *range = argument;
+  range->worker(range->context, range->begin, range->end);
+  return NULL;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_parallel_for(int count, int threads, void (*worker)(void *, int, int), void *context) {
+  // Check if the input params are valid.
+  if (count < 0 || worker == NULL) {
+    return -1;
+  }
+  if (threads > count) {
+    threads = count;
+  }
+  if (threads <= 1) {
+    worker(context, 0, count);
+    return 0;
+  }
+  struct parallel_range *ranges = malloc((size_t)threads * sizeof(struct parallel_range));
+  pthread_t *handles = malloc((size_t)threads * sizeof(pthread_t));
+  int *started = calloc((size_t)threads, sizeof(int));
+  if (ranges == NULL || handles == NULL || started == NULL) {
+    free(ranges);
+    free(handles);
+    free(started);
+    return -1;
+  }
+  for (int i = 0; i < threads; i++) {
+    ranges[i].worker = worker;
+    ranges[i].context = context;
+    ranges[i].begin = (int)((long long)count * i / threads);
+    ranges[i].end = (int)((long long)count * (i + 1) / threads);
+  }
+  // The calling thread processes the first range, and any range whose thread fails to start.
+  for (int i = 1; i < threads; i++) {
+    started[i] = pthread_create(&handles[i], NULL, parallel_worker, &ranges[i]) == 0;
+  }
+  parallel_worker(&ranges[0]);
+  for (int i = 1; i < threads; i++) {
+    if (started[i]) {
+      pthread_join(handles[i], NULL);
+    } else {
+      parallel_worker(&ranges[i]);
+    }
+  }
+  free(ranges);
+  free(handles);
+  free(started);
+  return 0;
+}
+
+/**
+ * Applies the function of a job to a range of rows.
+ *
+ * @param void *context
+ *   The job, as a `struct transform_job *`.
+ * @param int begin
+ *   The first row of the range.
+ * @param int end
+ *   The end of the range.
+ */
+static void transform_worker(void *context, int begin, int end) {
+  struct transform_job *job = context;
+  int failed = 0;
+  for (int i = begin; i < end; i++) {
+    struct data_row *row = job->rows[i];
+    if (job->predicate != NULL) {
+      job->keep[i] = job->predicate(row, job->context) != 0;
+    } else if (job->map != NULL) {
+      job->results[i] = job->map(row, job->context);
+      if (job->results[i] == row) {
+        // The row stays linked in its dataset, it cannot be appended to another one.
+        job->results[i] = NULL;
+      }
+      failed |= job->results[i] == NULL;
+    } else {
+      failed |= job->update(row, job->context) != 0;
+    }
+  }
+  if (failed) {
+    __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+  }
+}
+
+/**
+ * Evaluates a predicate on every row of a dataset.
+ *
+ * @param struct dataset *data
+ *   The dataset.
+ * @param int (*predicate)(struct data_row *, void *)
+ *   The predicate.
+ * @param void *context
+ *   The context passed to the predicate.
+ * @param int threads
+ *   The number of threads.
+ * @param unsigned char **keep
+ *   Receives whether each row matched, to be freed by the caller.
+ *
+ * @return struct dataset_view*
+ *   A view of every row of the dataset, or NULL on failure.
+ */
+static struct dataset_view *transform_match(struct dataset *data, int (*predicate)(struct data_row *, void *), void *context, int threads, unsigned char **keep) {
+  struct dataset_view *all = dataset_view_from_dataset(data);
+  *keep = all != NULL ? malloc((size_t)all->size + 1) : NULL;
+  if (*keep == NULL) {
+    dataset_view_destroy(all);
+    return NULL;
+  }
+  struct transform_job job = {.rows = all->rows, .predicate = predicate, .context = context, .keep = *keep};
+  if (dataset_parallel_for(all->size, threads, transform_worker, &job) != 0) {
+    free(*keep);
+    *keep = NULL;
+    dataset_view_destroy(all);
+    return NULL;
+  }
+  return all;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_view *dataset_filter(struct dataset *data, int (*predicate)(struct data_row *, void *), void *context, int threads) {
+  // Check if the input params are valid.
+  if (data == NULL || predicate == NULL) {
+    return NULL;
+  }
+  unsigned char *keep;
+  struct dataset_view *all = transform_match(data, predicate, context, threads, &keep);
+  if (all == NULL) {
+    return NULL;
+  }
+  // Compact the matching rows in place, the view of every row becomes the result.
+  int size = 0;
+  for (int i = 0; i < all->size; i++) {
+    if (keep[i]) {
+      all->rows[size++] = all->rows[i];
+    }
+  }
+  all->size = size;
+  free(keep);
+  return all;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_filter_in_place(struct dataset *data, int (*predicate)(struct data_row *, void *), void *context, int threads) {
+  // Check if the input params are valid.
+  if (data == NULL || predicate == NULL) {
+    return -1;
+  }
+  unsigned char *keep;
+  struct dataset_view *all = transform_match(data, predicate, context, threads, &keep);
+  if (all == NULL) {
+    return -1;
+  }
+  // Relink the kept rows and destroy the others.
+  struct data_row *previous = NULL;
+  int removed = 0;
+  data->iterator = NULL;
+  for (int i = 0; i < all->size; i++) {
+    struct data_row *row = all->rows[i];
+    if (!keep[i]) {
+      data_row_destroy(row);
+      removed++;
+      continue;
+    }
+    row->previous = previous;
+    if (previous == NULL) {
+      data->iterator = row;
+    } else {
+      previous->next = row;
+    }
+    previous = row;
+  }
+  if (previous != NULL) {
+    previous->next = NULL;
+  }
+  data->last = previous;
+  data->size = all->size - removed;
+  free(keep);
+  dataset_view_destroy(all);
+  return removed;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_map(struct dataset *data, struct data_row *(*function)(struct data_row *, void *), void *context, int threads) {
+  // Check if the input params are valid.
+  if (data == NULL || function == NULL) {
+    return NULL;
+  }
+  struct dataset_view *all = dataset_view_from_dataset(data);
+  struct data_row **results = all != NULL ? calloc((size_t)all->size + 1, sizeof(struct data_row *)) : NULL;
+  struct dataset *mapped = results != NULL ? dataset_create() : NULL;
+  if (mapped == NULL) {
+    free(results);
+    dataset_view_destroy(all);
+    return NULL;
+  }
+  struct transform_job job = {.rows = all->rows, .map = function, .context = context, .results = results};
+  int status = dataset_parallel_for(all->size, threads, transform_worker, &job);
+  if (status == 0 && job.failed) {
+    status = -1;
+  }
+  // Append the new rows in order, or destroy the rest once any row failed.
+  for (int i = 0; i < all->size; i++) {
+    if (status == 0 && dataset_append_row(mapped, results[i]) != 0) {
+      status = -1;
+    }
+    if (status != 0) {
+      data_row_destroy(results[i]);
+    }
+  }
+  free(results);
+  dataset_view_destroy(all);
+  if (status != 0) {
+    dataset_destroy(mapped);
+    return NULL;
+  }
+  return mapped;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_map_in_place(struct dataset *data, int (*function)(struct data_row *, void *), void *context, int threads) {
+  // Check if the input params are valid.
+  if (data == NULL || function == NULL) {
+    return -1;
+  }
+  struct dataset_view *all = dataset_view_from_dataset(data);
+  if (all == NULL) {
+    return -1;
+  }
+  struct transform_job job = {.rows = all->rows, .update = function, .context = context};
+  int status = dataset_parallel_for(all->size, threads, transform_worker, &job);
+  dataset_view_destroy(all);
+  return status == 0 && !job.failed ? 0 : -1;
+}
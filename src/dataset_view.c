@@ -0,0 +1,198 @@
+#include <limits.h>
+#include <stdlib.h>
+#include "../include/dataset.h"
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_view *dataset_view_create(struct dataset *source, int capacity) {
+  // Check if the input params are valid.
+  if (capacity < 0) {
+    return NULL;
+  }
+  // Allocate memory for the view structure.
+  struct dataset_view *view = malloc(sizeof(struct dataset_view));
+  if (view == NULL) {
+    // Memory allocation failed.
+    return NULL;
+  }
+  // Allocate the array of rows, at least one slot so an empty view is valid.
+  view->rows = malloc(((size_t)capacity + 1) * sizeof(struct data_row *));
+  if (view->rows == NULL) {
+    free(view);
+    return NULL;
+  }
+  view->source = source;
+  view->size = 0;
+  view->capacity = capacity;
+  // Keep every column until the view is projected.
+  view->input_columns = NULL;
+  view->input_columns_size = 0;
+  view->output_columns = NULL;
+  view->output_columns_size = 0;
+  // Return the newly created view.
+  return view;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_view *dataset_view_from_dataset(struct dataset *source) {
+  // Check if the input params are valid.
+  if (source == NULL || source->size > INT_MAX) {
+    // A view holds at most INT_MAX rows.
+    return NULL;
+  }
+  // Create a view large enough for every row.
+  struct dataset_view *view = dataset_view_create(source, (int)source->size);
+  if (view == NULL) {
+    return NULL;
+  }
+  // Index the rows of the dataset in order.
+  struct data_row *current = source->iterator;
+  while (current != NULL && view->size < view->capacity) {
+    view->rows[view->size++] = current;
+    current = current->next;
+  }
+  // Return the populated view.
+  return view;
+}
+
+/**
+ * {@inheritdoc}
+ */
+void dataset_view_destroy(struct dataset_view *view) {
+  if (view == NULL) {
+    // No action needed if view is NULL.
+    return;
+  }
+  // Free the arrays of rows and columns and the view itself, the rows are borrowed.
+  free(view->rows);
+  free(view->input_columns);
+  free(view->output_columns);
+  free(view);
+}
+
+/**
+ * Composes the column map of one side of a view with a new selection of columns.
+ *
+ * @param const int *current
+ *   The current column map, or NULL if every column is kept.
+ * @param int current_size
+ *   The number of columns of the current map.
+ * @param const int *columns
+ *   The columns to select, relative to the current map.
+ * @param int columns_size
+ *   The number of columns to select.
+ *
+ * @return int*
+ *   The new column map, or NULL if a column is invalid or memory allocation fails.
+ */
+static int *view_compose_columns(const int *current, int current_size, const int *columns, int columns_size) {
+  // Allocate at least one column so an empty projection is valid.
+  int *composed = malloc(((size_t)columns_size + 1) * sizeof(int));
+  if (composed == NULL) {
+    return NULL;
+  }
+  for (int i = 0; i < columns_size; i++) {
+    if (columns[i] < 0 || (current != NULL && columns[i] >= current_size)) {
+      free(composed);
+      return NULL;
+    }
+    composed[i] = current != NULL ? current[columns[i]] : columns[i];
+  }
+  return composed;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_view_project(struct dataset_view *view, const int *input_columns, int input_columns_size, const int *output_columns, int output_columns_size) {
+  // Check if the input params are valid.
+  if (view == NULL || (input_columns != NULL && input_columns_size < 0) || (output_columns != NULL && output_columns_size < 0)) {
+    return -1;
+  }
+  // Build both column maps before changing the view.
+  int *inputs = NULL;
+  int *outputs = NULL;
+  if (input_columns != NULL) {
+    inputs = view_compose_columns(view->input_columns, view->input_columns_size, input_columns, input_columns_size);
+    if (inputs == NULL) {
+      return -1;
+    }
+  }
+  if (output_columns != NULL) {
+    outputs = view_compose_columns(view->output_columns, view->output_columns_size, output_columns, output_columns_size);
+    if (outputs == NULL) {
+      free(inputs);
+      return -1;
+    }
+  }
+  if (inputs != NULL) {
+    free(view->input_columns);
+    view->input_columns = inputs;
+    view->input_columns_size = input_columns_size;
+  }
+  if (outputs != NULL) {
+    free(view->output_columns);
+    view->output_columns = outputs;
+    view->output_columns_size = output_columns_size;
+  }
+  return 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset_view *dataset_project(struct dataset *data, const int *input_columns, int input_columns_size, const int *output_columns, int output_columns_size) {
+  // Select every row, then restrict the columns.
+  struct dataset_view *view = dataset_view_from_dataset(data);
+  if (view == NULL) {
+    return NULL;
+  }
+  if (dataset_view_project(view, input_columns, input_columns_size, output_columns, output_columns_size) != 0) {
+    dataset_view_destroy(view);
+    return NULL;
+  }
+  return view;
+}
+
+/**
+ * {@inheritdoc}
+ */
+int dataset_view_get_width(const struct dataset_view *view, int index, enum data_row_side side) {
+  // Check if the input params are valid.
+  if (view == NULL || index < 0 || index >= view->size) {
+    return -1;
+  }
+  const int *columns = side == DATA_ROW_INPUTS ? view->input_columns : view->output_columns;
+  if (columns != NULL) {
+    return side == DATA_ROW_INPUTS ? view->input_columns_size : view->output_columns_size;
+  }
+  struct data_entries *entries = data_row_get_entries(view->rows[index], side);
+  return entries != NULL ? (int)entries->size : 0;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct data_entry *dataset_view_get_entry(const struct dataset_view *view, int index, enum data_row_side side, int column) {
+  // Check if the input params are valid.
+  if (view == NULL || index < 0 || index >= view->size || column < 0) {
+    return NULL;
+  }
+  // Map the column of the view to the column of the row.
+  const int *columns = side == DATA_ROW_INPUTS ? view->input_columns : view->output_columns;
+  if (columns != NULL) {
+    int columns_size = side == DATA_ROW_INPUTS ? view->input_columns_size : view->output_columns_size;
+    if (column >= columns_size) {
+      return NULL;
+    }
+    column = columns[column];
+  }
+  struct data_entries *entries = data_row_get_entries(view->rows[index], side);
+  if (entries == NULL || column >= entries->size) {
+    return NULL;
+  }
+  return entries->entries[column];
+}
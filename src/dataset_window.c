@@ -0,0 +1,112 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "../include/dataset.h"
+
+/**
+ * Represents a value of the sequence, large enough to be converted to a double in place.
+ */
+union window_value {
+  int integer;
+  double real;
+};
+
+/**
+ * Creates a dataset of sliding windows over a sequence of doubles or integers.
+ *
+ * @param const double *reals
+ *   The sequence of doubles, or NULL.
+ * @param const int *integers
+ *   The sequence of integers, used when there are no doubles.
+ * @param int n
+ *   The length of the sequence.
+ * @param int window
+ *   The number of inputs of each row.
+ * @param int horizon
+ *   The number of outputs of each row.
+ * @param int stride
+ *   The distance between the first values of two consecutive rows.
+ *
+ * @return struct dataset*
+ *   A pointer to the dataset, or NULL on failure.
+ */
+static struct dataset *windows_create(const double *reals, const int *integers, int n, int window, int horizon, int stride) {
+  // Check if the input params are valid.
+  if ((reals == NULL && integers == NULL) || n < 0 || window <= 0 || horizon < 0 || stride <= 0) {
+    return NULL;
+  }
+  struct dataset *data = dataset_create();
+  long long span = (long long)window + horizon;
+  if (data == NULL || n < span) {
+    return data;
+  }
+  size_t rows = (size_t)((n - span) / stride + 1);
+  size_t values = (size_t)n;
+  // Lay out the values, entries and entry pointers of the sequence and the rows in a single storage.
+  size_t row_size = sizeof(struct data_row) + 2 * sizeof(struct data_entries);
+  size_t value_size = sizeof(union window_value) + sizeof(struct data_entry) + sizeof(struct data_entry *);
+  if (rows > SIZE_MAX / row_size || values > (SIZE_MAX - rows * row_size) / value_size) {
+    dataset_destroy(data);
+    return NULL;
+  }
+  struct dataset_storage *storage = dataset_storage_create(rows * row_size + values * value_size);
+  if (storage == NULL) {
+    dataset_destroy(data);
+    return NULL;
+  }
+  // Place the arrays with the strictest alignment first.
+  union window_value *slots = (union window_value *)storage->memory;
+  struct data_row *row_array = (struct data_row *)(slots + values);
+  struct data_entries *collections = (struct data_entries *)(row_array + rows);
+  struct data_entry **pointers = (struct data_entry **)(collections + 2 * rows);
+  struct data_entry *entries = (struct data_entry *)(pointers + values);
+  // Every value of the sequence has a single entry, shared by the windows holding it.
+  for (size_t i = 0; i < values; i++) {
+    if (reals != NULL) {
+      slots[i].real = reals[i];
+    } else {
+      slots[i].integer = integers[i];
+    }
+    entries[i].data = &slots[i];
+    pointers[i] = &entries[i];
+  }
+  // The entries of each row are a slice of the shared pointers.
+  for (size_t i = 0; i < rows; i++) {
+    struct data_entry **first = pointers + i * (size_t)stride;
+    collections[2 * i].size = window;
+    collections[2 * i].entries = first;
+    collections[2 * i + 1].size = horizon;
+    collections[2 * i + 1].entries = first + window;
+    struct data_row *row = &row_array[i];
+    row->inputs = &collections[2 * i];
+    row->outputs = &collections[2 * i + 1];
+    row->previous = i > 0 ? &row_array[i - 1] : NULL;
+    row->next = i + 1 < rows ? &row_array[i + 1] : NULL;
+    row->storage = storage;
+  }
+  // Hand the rows over to the dataset, each of them references the storage.
+  dataset_storage_retain(storage, rows);
+  data->iterator = &row_array[0];
+  data->last = &row_array[rows - 1];
+  data->size = rows;
+  return data;
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_from_windows(const double *values, int n, int window, int horizon, int stride) {
+  if (values == NULL) {
+    return NULL;
+  }
+  return windows_create(values, NULL, n, window, horizon, stride);
+}
+
+/**
+ * {@inheritdoc}
+ */
+struct dataset *dataset_from_windows_int(const int *values, int n, int window, int horizon, int stride) {
+  if (values == NULL) {
+    return NULL;
+  }
+  return windows_create(NULL, values, n, window, horizon, stride);
+}
@@ -3,44 +3,18 @@
 
 #include "../include/dataset.h"
 
-// Define constants for the number of inputs and outputs for each data row.
+// Define the number of inputs for each data row.
 #define NUM_INPUTS 2
-#define NUM_OUTPUTS 1
 
-/**
- * Generates a random integer within a specified range.
- *
- * @param int min
- *   The minimum value of the generated integer.
- *
- * @param int max
- *   The maximum value of the generated integer.
- *
- * @return int
- *   A randomly generated integer within the specified range [min, max].
- */
-int random_generate_integer(int min, int max);
-
-/**
- * Function to create a data row with random integer values and their sum.
- *
- * @param int min
- *   The minimum integer value for the random numbers.
- *
- * @param int max
- *   The maximum integer value for the random numbers.
- *
- * @return struct data_row*
- *   A pointer to the newly created data row, otherwise NULL.
- */
-struct data_row *random_generate_addition_row(int min, int max);
+// Define the number of threads generating the rows.
+#define GENERATE_THREADS 4
 
 /**
  * Function to generate a dataset with random data.
  *
  * This function creates a dataset with rows containing random integer values
  * and their sums. Each row's input consists of random integers, and the output
- * is the sum of these integers.
+ * is the sum of these integers. The rows are built by `dataset_generate`.
  *
  * @param int count
  *   The number of additions (rows) to generate.
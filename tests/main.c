@@ -1,8 +1,1419 @@
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <matrixmath.h>
 #include "arithmetic_operations.h"
 
+/**
+ * Creates a vector entry holding consecutive values.
+ *
+ * @param int length
+ *   The number of values of the vector.
+ * @param double *next
+ *   The first value, advanced past the last one.
+ *
+ * @return struct data_entry*
+ *   The vector entry.
+ */
+static struct data_entry *check_vector_entry(int length, double *next) {
+  struct vector *vector = vector_create(length);
+  for (int i = 0; i < length; i++) {
+    vector->elements[i] = (*next)++;
+  }
+  return data_entry_create(vector);
+}
+
+/**
+ * Exports vectors to a `.npy` file and reads them back.
+ *
+ * The rows mix vectors large enough to be written directly with small ones that
+ * are buffered, so the writer flushes with segments pointing into its buffer.
+ *
+ * @return int
+ *   Returns 0 if every value is read back, or -1 otherwise.
+ */
+static int check_npy_round_trip() {
+  const char *path = "libdataset_check.npy";
+  int rows = 600;
+  int width = 513;
+  struct dataset *data = dataset_create();
+  double next = 0;
+  for (int i = 0; i < rows; i++) {
+    struct data_row *row = data_row_create();
+    row->inputs = data_entries_create(2);
+    row->inputs->entries[0] = check_vector_entry(i < rows / 2 ? 512 : 256, &next);
+    row->inputs->entries[1] = check_vector_entry(i < rows / 2 ? 1 : 257, &next);
+    row->outputs = data_entries_create(0);
+    dataset_append_row(data, row);
+  }
+  int status = dataset_export_npy(data, path, DATA_ROW_INPUTS, DATA_ENTRY_TYPE_VECTOR);
+  // The values are stored at the end of the file, after the header.
+  size_t count = (size_t)rows * width;
+  double *values = malloc(count * sizeof(double));
+  FILE *stream = status == 0 ? fopen(path, "rb") : NULL;
+  if (stream == NULL || values == NULL || fseek(stream, -(long)(count * sizeof(double)), SEEK_END) != 0 || fread(values, sizeof(double), count, stream) != count) {
+    status = -1;
+  }
+  for (size_t i = 0; status == 0 && i < count; i++) {
+    status = values[i] == (double)i ? 0 : -1;
+  }
+  if (stream != NULL) {
+    fclose(stream);
+  }
+  remove(path);
+  free(values);
+  // Destroy the vectors themselves, the entries only free their structure.
+  for (struct data_row *row = data->iterator; row != NULL; row = row->next) {
+    for (int64_t i = 0; i < row->inputs->size; i++) {
+      vector_destroy(row->inputs->entries[i]->data);
+      row->inputs->entries[i]->data = NULL;
+    }
+  }
+  dataset_destroy(data);
+  return status;
+}
+
+/**
+ * Reports the result of a check.
+ *
+ * @param const char *name
+ *   The name of the check.
+ * @param int result
+ *   The result of the check, 0 if it passed.
+ *
+ * @return int
+ *   EXIT_SUCCESS if the check passed, or EXIT_FAILURE otherwise.
+ */
+static int check_report(const char *name, int result) {
+  printf("%s: %s.\n", name, result == 0 ? "ok" : "failed");
+  return result == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Compares the contents of two streams from their start.
+ *
+ * @param FILE *first
+ *   The first stream.
+ * @param FILE *second
+ *   The second stream.
+ *
+ * @return int
+ *   Returns 0 if the streams hold the same bytes, or -1 otherwise.
+ */
+static int check_streams_equal(FILE *first, FILE *second) {
+  rewind(first);
+  rewind(second);
+  int a;
+  int b;
+  do {
+    a = fgetc(first);
+    b = fgetc(second);
+  } while (a == b && a != EOF);
+  return a == b ? 0 : -1;
+}
+
+/**
+ * Prints a dataset with the `printf` layout of `dataset_print` that predates the text writer.
+ *
+ * @param struct dataset *data
+ *   The dataset.
+ * @param FILE *stream
+ *   The stream to print to.
+ * @param enum data_entry_type type
+ *   The type of the entries: DATA_ENTRY_TYPE_INT, DATA_ENTRY_TYPE_DOUBLE or DATA_ENTRY_TYPE_STRING.
+ */
+static void check_print_legacy(struct dataset *data, FILE *stream, enum data_entry_type type) {
+  fprintf(stream, "-----------------------------------------------\n");
+  fprintf(stream, "Dataset: # rows %lld.\n", (long long)data->size);
+  int row_number = 1;
+  for (struct data_row *row = data->iterator; row != NULL; row = row->next, row_number++) {
+    fprintf(stream, "Row #%d: ", row_number);
+    for (int side = 0; side < 2; side++) {
+      struct data_entries *entries = side == 0 ? row->inputs : row->outputs;
+      fprintf(stream, side == 0 ? "Input [" : " - Output [");
+      for (int64_t i = 0; i < entries->size; i++) {
+        if (i != 0) {
+          fprintf(stream, ", ");
+        }
+        void *value = entries->entries[i]->data;
+        if (type == DATA_ENTRY_TYPE_INT) {
+          fprintf(stream, "%d", *(int *)value);
+        } else if (type == DATA_ENTRY_TYPE_DOUBLE) {
+          fprintf(stream, "%g", *(double *)value);
+        } else {
+          fprintf(stream, "'%s'", (char *)value);
+        }
+      }
+      fprintf(stream, "]");
+    }
+    fprintf(stream, "\n");
+  }
+  fprintf(stream, "-----------------------------------------------\n");
+}
+
+/**
+ * Writes datasets in the plain text format and compares them with the legacy layout.
+ *
+ * @return int
+ *   Returns 0 if every dataset is written as it used to be printed, or -1 otherwise.
+ */
+static int check_text_plain() {
+  int integers[] = {0, -7, 42, INT_MIN, INT_MAX, 1000000, -1};
+  double reals[] = {0.0, -2.5, 1e-7, 123456789.0, 3.14159265, -0.0, 1e300};
+  const char *strings[] = {"", "a", "hello, world", "'quoted'", "12", "+", " "};
+  int status = 0;
+  for (int type = DATA_ENTRY_TYPE_INT; status == 0 && type <= DATA_ENTRY_TYPE_STRING; type++) {
+    struct dataset *data = dataset_create();
+    // Rows of one to three inputs and a single output.
+    for (int i = 0; i < 7; i++) {
+      struct data_row *row = data_row_create();
+      row->inputs = data_entries_create(1 + i % 3);
+      row->outputs = data_entries_create(1);
+      for (int64_t j = 0; j <= row->inputs->size; j++) {
+        int k = (int)((i + j) % 7);
+        struct data_entry *entry;
+        if (type == DATA_ENTRY_TYPE_INT) {
+          entry = data_entry_create_int(integers[k]);
+        } else if (type == DATA_ENTRY_TYPE_DOUBLE) {
+          double *value = malloc(sizeof(double));
+          *value = reals[k];
+          entry = data_entry_create(value);
+        } else {
+          entry = data_entry_create(strdup(strings[k]));
+        }
+        if (j < row->inputs->size) {
+          row->inputs->entries[j] = entry;
+        } else {
+          row->outputs->entries[0] = entry;
+        }
+      }
+      dataset_append_row(data, row);
+    }
+    FILE *written = tmpfile();
+    FILE *expected = tmpfile();
+    if (written == NULL || expected == NULL || dataset_write_text(data, written, type, DATASET_TEXT_PLAIN) != 0) {
+      status = -1;
+    } else {
+      check_print_legacy(data, expected, type);
+      status = check_streams_equal(written, expected);
+    }
+    if (written != NULL) {
+      fclose(written);
+    }
+    if (expected != NULL) {
+      fclose(expected);
+    }
+    dataset_destroy(data);
+  }
+  return status;
+}
+
+/**
+ * Creates the row at a position of a checked dataset.
+ *
+ * @param int i
+ *   The position of the row.
+ *
+ * @return struct data_row*
+ *   The row, with the inputs [i, -i] and the output [i * i].
+ */
+static struct data_row *check_row(int i) {
+  struct data_row *row = data_row_create();
+  row->inputs = data_entries_create(2);
+  row->inputs->entries[0] = data_entry_create_int(i);
+  row->inputs->entries[1] = data_entry_create_int(-i);
+  row->outputs = data_entries_create(1);
+  row->outputs->entries[0] = data_entry_create_int(i * i);
+  return row;
+}
+
+/**
+ * Checks whether a row holds the values of `check_row`.
+ *
+ * @param struct data_row *row
+ *   The row.
+ * @param int i
+ *   The position the row must have been created for.
+ *
+ * @return int
+ *   1 if the row matches, 0 otherwise.
+ */
+static int check_row_is(struct data_row *row, int i) {
+  return row->inputs->size == 2 && row->outputs->size == 1 && *(int *)row->inputs->entries[0]->data == i && *(int *)row->inputs->entries[1]->data == -i && *(int *)row->outputs->entries[0]->data == i * i;
+}
+
+/**
+ * Checks the size of a dataset and walks its rows in both directions.
+ *
+ * @param struct dataset *data
+ *   The dataset.
+ * @param int64_t expected
+ *   The number of rows the dataset must have.
+ *
+ * @return int
+ *   Returns 0 if the size, the next and previous links and the last row agree,
+ *   or -1 otherwise.
+ */
+static int check_links(struct dataset *data, int64_t expected) {
+  int64_t forward = 0;
+  struct data_row *tail = NULL;
+  for (struct data_row *row = data->iterator; row != NULL && forward <= expected; row = row->next) {
+    if (row->previous != tail) {
+      return -1;
+    }
+    tail = row;
+    forward++;
+  }
+  int64_t backward = 0;
+  struct data_row *head = NULL;
+  for (struct data_row *row = data->last; row != NULL && backward <= expected; row = row->previous) {
+    head = row;
+    backward++;
+  }
+  return data->size == expected && forward == expected && backward == expected && tail == data->last && head == data->iterator ? 0 : -1;
+}
+
+/**
+ * Checks that the rows recovered from a journal are the first rows written to it.
+ *
+ * Row i holds the inputs [i, -i] and the output [i * i].
+ *
+ * @param const char *path
+ *   The path of the journal.
+ * @param int64_t expected
+ *   The number of rows that must be recovered.
+ *
+ * @return int
+ *   Returns 0 if the rows match, or -1 otherwise.
+ */
+static int check_journal_rows(const char *path, int64_t expected) {
+  struct dataset *recovered = dataset_recover(path);
+  int status = recovered != NULL && recovered->size == expected ? 0 : -1;
+  int i = 0;
+  for (struct data_row *row = status == 0 ? recovered->iterator : NULL; row != NULL; row = row->next, i++) {
+    if (!check_row_is(row, i)) {
+      status = -1;
+    }
+  }
+  dataset_destroy(recovered);
+  return status;
+}
+
+/**
+ * Writes rows to a journal, damages it and recovers the rows before the damage.
+ *
+ * The last rows are moved in by a concat, after one that fails. A flipped byte
+ * is caught by the checksum of its record, and a truncated last record by its
+ * length.
+ *
+ * @return int
+ *   Returns 0 if every recovery stops at the damaged record, or -1 otherwise.
+ */
+static int check_journal_recovery() {
+  const char *path = "libdataset_check.journal";
+  int rows = 10;
+  remove(path);
+  struct dataset *data = dataset_create();
+  // Vector entries can not be serialized in the records.
+  int status = dataset_journal_open(data, path, DATA_ENTRY_TYPE_VECTOR, 4) == -1 ? 0 : -1;
+  if (status == 0) {
+    status = dataset_journal_open(data, path, DATA_ENTRY_TYPE_INT, 4);
+  }
+  for (int i = 0; status == 0 && i < rows - 2; i++) {
+    status = dataset_append_row(data, check_row(i));
+  }
+  // A concat with a row that can not be serialized logs none of the rows.
+  struct dataset *source = dataset_create();
+  for (int i = rows - 2; i < rows; i++) {
+    dataset_append_row(source, check_row(i));
+  }
+  struct data_row *invalid = check_row(rows);
+  data_entry_destroy(invalid->outputs->entries[0]);
+  invalid->outputs->entries[0] = NULL;
+  dataset_append_row(source, invalid);
+  if (status == 0 && (dataset_concat(data, source) != -1 || data->size != rows - 2 || source->size != 3)) {
+    status = -1;
+  }
+  // Drop the invalid row and move the others.
+  source->last = invalid->previous;
+  source->last->next = NULL;
+  source->size--;
+  data_row_destroy(invalid);
+  if (status == 0 && (dataset_concat(data, source) != 0 || data->size != rows)) {
+    status = -1;
+  }
+  dataset_destroy(source);
+  // Closing the journal commits the last, incomplete group.
+  if (dataset_journal_close(data) != 0) {
+    status = -1;
+  }
+  dataset_destroy(data);
+  if (status == 0) {
+    status = check_journal_rows(path, rows);
+  }
+  // The records follow a 12-byte header and all have the same length here.
+  FILE *stream = status == 0 ? fopen(path, "r+b") : NULL;
+  long size = stream != NULL && fseek(stream, 0, SEEK_END) == 0 ? ftell(stream) : -1;
+  long record = (size - 12) / rows;
+  if (stream == NULL || size <= 12 || (size - 12) % rows != 0) {
+    status = -1;
+  }
+  // Flip the last byte of the sixth record.
+  long offset = 12 + 6 * record - 1;
+  int byte = status == 0 && fseek(stream, offset, SEEK_SET) == 0 ? fgetc(stream) : EOF;
+  if (byte == EOF || fseek(stream, offset, SEEK_SET) != 0 || fputc(byte ^ 0x5a, stream) == EOF || fflush(stream) != 0) {
+    status = -1;
+  }
+  if (status == 0) {
+    status = check_journal_rows(path, 5);
+  }
+  // Restore the byte and cut the last record short.
+  if (status == 0 && (fseek(stream, offset, SEEK_SET) != 0 || fputc(byte, stream) == EOF || fflush(stream) != 0)) {
+    status = -1;
+  }
+  if (stream != NULL) {
+    fclose(stream);
+  }
+  if (status == 0 && truncate(path, size - 1) != 0) {
+    status = -1;
+  }
+  if (status == 0) {
+    status = check_journal_rows(path, rows - 1);
+  }
+  remove(path);
+  return status;
+}
+
+/**
+ * Creates a dataset of rows with a single string input and a single string output.
+ *
+ * @param const char **labels
+ *   The labels, two per row.
+ * @param int rows
+ *   The number of rows.
+ *
+ * @return struct dataset*
+ *   The dataset.
+ */
+static struct dataset *check_label_dataset(const char **labels, int rows) {
+  struct dataset *data = dataset_create();
+  for (int i = 0; i < rows; i++) {
+    struct data_row *row = data_row_create();
+    row->inputs = data_entries_create(1);
+    row->inputs->entries[0] = data_entry_create(strdup(labels[2 * i]));
+    row->outputs = data_entries_create(1);
+    row->outputs->entries[0] = data_entry_create(strdup(labels[2 * i + 1]));
+    dataset_append_row(data, row);
+  }
+  return data;
+}
+
+/**
+ * Checks that the ids of a label encoded dataset decode back to its strings.
+ *
+ * @param struct dataset *strings
+ *   The string dataset.
+ * @param struct dataset *ids
+ *   The label encoded dataset.
+ * @param struct dataset_label_encoder *encoder
+ *   The encoder.
+ * @param const char *unknown
+ *   The only string that may be encoded as the unknown id, or NULL.
+ *
+ * @return int
+ *   Returns 0 if every id decodes to its string, or -1 otherwise.
+ */
+static int check_label_ids(struct dataset *strings, struct dataset *ids, struct dataset_label_encoder *encoder, const char *unknown) {
+  if (ids == NULL || ids->size != strings->size) {
+    return -1;
+  }
+  for (struct data_row *string_row = strings->iterator, *id_row = ids->iterator; string_row != NULL; string_row = string_row->next, id_row = id_row->next) {
+    for (int side = 0; side < 2; side++) {
+      const char *label = (side == 0 ? string_row->inputs : string_row->outputs)->entries[0]->data;
+      int id = *(int *)(side == 0 ? id_row->inputs : id_row->outputs)->entries[0]->data;
+      const char *decoded = dataset_label_encoder_get_label(encoder, id);
+      if (decoded == NULL ? unknown == NULL || strcmp(label, unknown) != 0 : strcmp(decoded, label) != 0) {
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * Label encodes a training set, then validation sets with a frozen encoder.
+ *
+ * The training set has enough distinct labels to grow the table of the encoder.
+ *
+ * @return int
+ *   Returns 0 if the ids round-trip and unseen labels are handled as documented, or -1 otherwise.
+ */
+static int check_label_round_trip() {
+  int rows = 200;
+  char names[100][16];
+  const char *labels[400];
+  for (int i = 0; i < 100; i++) {
+    snprintf(names[i], sizeof(names[i]), "label-%d", i);
+  }
+  for (int i = 0; i < rows; i++) {
+    labels[2 * i] = names[(i * 7) % 100];
+    labels[2 * i + 1] = names[i % 3];
+  }
+  struct dataset *train = check_label_dataset(labels, rows);
+  struct dataset_label_encoder *encoder = dataset_label_encoder_create();
+  struct dataset *train_ids = dataset_label_encode(train, encoder);
+  int status = check_label_ids(train, train_ids, encoder, NULL);
+  // The ids are given in the order the labels are first seen.
+  if (status == 0 && (dataset_label_encoder_get_size(encoder) != 100 || dataset_label_encoder_get_id(encoder, "label-0") != 0 || dataset_label_encoder_get_id(encoder, "label-7") != 1 || dataset_label_encoder_get_id(encoder, "label-1") != 2)) {
+    status = -1;
+  }
+  const char *unseen_labels[] = {"label-3", "label-1", "unseen", "label-99"};
+  struct dataset *unseen = check_label_dataset(unseen_labels, 2);
+  // A frozen encoder without an unknown id rejects the unseen label and learns nothing.
+  dataset_label_encoder_freeze(encoder, 0);
+  struct dataset *rejected = dataset_label_encode(unseen, encoder);
+  if (rejected != NULL || dataset_label_encoder_get_size(encoder) != 100) {
+    status = -1;
+  }
+  // With an unknown id, the unseen label takes the id after the known ones.
+  dataset_label_encoder_freeze(encoder, 1);
+  struct dataset *unseen_ids = dataset_label_encode(unseen, encoder);
+  if (status == 0) {
+    status = check_label_ids(unseen, unseen_ids, encoder, "unseen");
+  }
+  if (status == 0 && (dataset_label_encoder_get_size(encoder) != 101 || *(int *)unseen_ids->iterator->next->inputs->entries[0]->data != 100)) {
+    status = -1;
+  }
+  dataset_destroy(rejected);
+  dataset_destroy(unseen_ids);
+  dataset_destroy(unseen);
+  dataset_destroy(train_ids);
+  dataset_destroy(train);
+  dataset_label_encoder_destroy(encoder);
+  return status;
+}
+
+/**
+ * Compares the vector entries of two datasets, and checks the alignment of the second.
+ *
+ * @param struct dataset *expected
+ *   The dataset of vector entries.
+ * @param struct dataset *packed
+ *   The packed copy.
+ *
+ * @return int
+ *   Returns 0 if every vector is equal and 64-byte aligned in the copy, or -1 otherwise.
+ */
+static int check_packed_vectors(struct dataset *expected, struct dataset *packed) {
+  if (packed == NULL || packed->size != expected->size) {
+    return -1;
+  }
+  for (struct data_row *row = expected->iterator, *copy = packed->iterator; row != NULL; row = row->next, copy = copy->next) {
+    for (int side = 0; side < 2; side++) {
+      struct data_entries *entries = side == 0 ? row->inputs : row->outputs;
+      struct data_entries *copies = side == 0 ? copy->inputs : copy->outputs;
+      if (copies->size != entries->size) {
+        return -1;
+      }
+      for (int64_t i = 0; i < entries->size; i++) {
+        struct vector *vector = entries->entries[i]->data;
+        struct vector *packed_vector = copies->entries[i]->data;
+        if (packed_vector->length != vector->length || (uintptr_t)packed_vector->elements % 64 != 0 || memcmp(packed_vector->elements, vector->elements, (size_t)vector->length * sizeof(double)) != 0) {
+          return -1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * Destroys the vectors held by the entries of a dataset.
+ *
+ * The entries only free the vector structure, not its elements.
+ *
+ * @param struct dataset *data
+ *   The dataset of vector entries, may be NULL.
+ */
+static void check_vectors_destroy(struct dataset *data) {
+  for (struct data_row *row = data != NULL ? data->iterator : NULL; row != NULL; row = row->next) {
+    for (int side = 0; side < 2; side++) {
+      struct data_entries *entries = side == 0 ? row->inputs : row->outputs;
+      for (int64_t i = 0; i < entries->size; i++) {
+        vector_destroy(entries->entries[i]->data);
+        entries->entries[i]->data = NULL;
+      }
+    }
+  }
+}
+
+/**
+ * Packs vector and one-hot datasets into slabs and compares them with their source.
+ *
+ * @return int
+ *   Returns 0 if the packed datasets hold the same vectors, or -1 otherwise.
+ */
+static int check_pack_round_trip() {
+  int rows = 50;
+  int tokens_size = 13;
+  struct dataset *vectors = dataset_create();
+  struct dataset *ints = dataset_create();
+  double next = 0;
+  for (int i = 0; i < rows; i++) {
+    // Lengths that are not multiples of 8 doubles need padding in the slabs.
+    struct data_row *row = data_row_create();
+    row->inputs = data_entries_create(2);
+    row->inputs->entries[0] = check_vector_entry(1 + i % 11, &next);
+    row->inputs->entries[1] = check_vector_entry(3, &next);
+    row->outputs = data_entries_create(1);
+    row->outputs->entries[0] = check_vector_entry(i % 2 == 0 ? 9 : 16, &next);
+    dataset_append_row(vectors, row);
+    struct data_row *int_row = data_row_create();
+    int_row->inputs = data_entries_create(3);
+    for (int j = 0; j < 3; j++) {
+      int_row->inputs->entries[j] = data_entry_create_int((i + j * 5) % tokens_size);
+    }
+    int_row->outputs = data_entries_create(1);
+    int_row->outputs->entries[0] = data_entry_create_int(i % tokens_size);
+    dataset_append_row(ints, int_row);
+  }
+  struct dataset *packed = dataset_pack_vectors(vectors, 0);
+  int status = check_packed_vectors(vectors, packed);
+  struct dataset *one_hot = dataset_one_hot_encode(ints, tokens_size);
+  struct dataset *one_hot_packed = dataset_one_hot_encode_packed(ints, tokens_size, 1);
+  if (status == 0) {
+    status = one_hot != NULL ? check_packed_vectors(one_hot, one_hot_packed) : -1;
+  }
+  check_vectors_destroy(vectors);
+  check_vectors_destroy(one_hot);
+  dataset_destroy(one_hot_packed);
+  dataset_destroy(one_hot);
+  dataset_destroy(packed);
+  dataset_destroy(ints);
+  dataset_destroy(vectors);
+  return status;
+}
+
+/**
+ * Builds sliding windows over sequences and checks the values and the sharing of every row.
+ *
+ * @return int
+ *   Returns 0 if every window holds its slice of the sequence, or -1 otherwise.
+ */
+static int check_windows() {
+  int n = 23;
+  int window = 4;
+  int horizon = 2;
+  int stride = 3;
+  int values[23];
+  double reals[23];
+  for (int i = 0; i < n; i++) {
+    values[i] = i * i - 50;
+    reals[i] = i / 4.0;
+  }
+  struct dataset *integers = dataset_from_windows_int(values, n, window, horizon, stride);
+  struct dataset *doubles = dataset_from_windows(reals, n, window, horizon, stride);
+  // A window and its horizon starting at 15 is the last one to fit in 23 values.
+  int status = integers != NULL && doubles != NULL && integers->size == 6 && doubles->size == 6 ? 0 : -1;
+  int first = 0;
+  for (struct data_row *row = status == 0 ? integers->iterator : NULL, *real_row = doubles->iterator; row != NULL; row = row->next, real_row = real_row->next, first += stride) {
+    if (row->inputs->size != window || row->outputs->size != horizon || (row->next != NULL && row->next->inputs->entries != row->inputs->entries + stride)) {
+      status = -1;
+      break;
+    }
+    for (int i = 0; i < window + horizon; i++) {
+      struct data_entry *entry = i < window ? row->inputs->entries[i] : row->outputs->entries[i - window];
+      struct data_entry *real_entry = i < window ? real_row->inputs->entries[i] : real_row->outputs->entries[i - window];
+      if (*(int *)entry->data != values[first + i] || *(double *)real_entry->data != reals[first + i]) {
+        status = -1;
+      }
+    }
+  }
+  // A sequence shorter than a window and its horizon has no row.
+  struct dataset *empty = dataset_from_windows_int(values, window + horizon - 1, window, horizon, stride);
+  if (empty == NULL || empty->size != 0) {
+    status = -1;
+  }
+  dataset_destroy(empty);
+  dataset_destroy(doubles);
+  dataset_destroy(integers);
+  return status;
+}
+
+/**
+ * Checks the size computations that must not be truncated to 32 bits.
+ *
+ * @return int
+ *   Returns 0 if every size past INT_MAX is handled, or -1 otherwise.
+ */
+static int check_large_sizes() {
+  int status = 0;
+  // Sizes whose array of pointers cannot be allocated are rejected before any allocation.
+  if (data_entries_create(INT64_MAX) != NULL || data_entries_create(-1) != NULL) {
+    status = -1;
+  }
+  // Shards of a dataset of 6 billion rows.
+  int64_t size = 6000000000LL;
+  if (dataset_shard_of(1500000000LL - 1, size, 4, DATASET_SHARD_CONTIGUOUS) != 0 || dataset_shard_of(1500000000LL, size, 4, DATASET_SHARD_CONTIGUOUS) != 1 || dataset_shard_of(size - 1, size, 4, DATASET_SHARD_CONTIGUOUS) != 3) {
+    status = -1;
+  }
+  if (dataset_shard_of(5000000003LL, size, 4, DATASET_SHARD_ROUND_ROBIN) != 3) {
+    status = -1;
+  }
+  // A position of 2^32 would be the first row once truncated.
+  struct dataset *data = dataset_create();
+  for (int i = 0; i < 3; i++) {
+    struct data_row *row = data_row_create();
+    row->inputs = data_entries_create(1);
+    row->inputs->entries[0] = data_entry_create_int(i);
+    row->outputs = data_entries_create(0);
+    dataset_append_row(data, row);
+  }
+  struct dataset_cursor cursor;
+  dataset_cursor_begin(&cursor, data);
+  struct data_row *row = dataset_cursor_seek(&cursor, 2);
+  if (row == NULL || *(int *)row->inputs->entries[0]->data != 2 || dataset_cursor_seek(&cursor, INT64_C(1) << 32) != NULL) {
+    status = -1;
+  }
+  dataset_destroy(data);
+  return status;
+}
+
+/**
+ * Draws rows from weighted samplers and checks the epochs and the frequencies.
+ *
+ * Row i of the dataset has the input i and the class i % 3 as output, except that
+ * the rows 0 to 9 all belong to class 0, so the classes have 13, 4 and 3 rows.
+ *
+ * @return int
+ *   Returns 0 if the draws follow the weights, or -1 otherwise.
+ */
+static int check_weighted_sampler() {
+  int rows = 20;
+  struct dataset *data = dataset_create();
+  double weights[20];
+  for (int i = 0; i < rows; i++) {
+    struct data_row *row = data_row_create();
+    row->inputs = data_entries_create(1);
+    row->inputs->entries[0] = data_entry_create_int(i);
+    row->outputs = data_entries_create(1);
+    row->outputs->entries[0] = data_entry_create_int(i < 10 ? 0 : i % 3);
+    dataset_append_row(data, row);
+    // Row 5 is never drawn, row 7 is drawn as often as all the others together.
+    weights[i] = i == 5 ? 0 : (i == 7 ? rows - 2 : 1);
+  }
+  struct data_row *drawn[64];
+  int counts[20] = {0};
+  // Without replacement, an epoch returns every row of positive weight once.
+  struct dataset_weighted_sampler *epochs = dataset_weighted_sampler_create(data, weights, 0, 7);
+  int status = epochs != NULL ? 0 : -1;
+  for (int epoch = 0; status == 0 && epoch < 2; epoch++) {
+    int size = dataset_weighted_sampler_draw(epochs, drawn, 64);
+    int seen[20] = {0};
+    for (int i = 0; i < size; i++) {
+      seen[*(int *)drawn[i]->inputs->entries[0]->data]++;
+    }
+    for (int i = 0; status == 0 && i < rows; i++) {
+      status = seen[i] == (i != 5) ? 0 : -1;
+    }
+    if (size != rows - 1 || dataset_weighted_sampler_draw(epochs, drawn, 64) != 0) {
+      status = -1;
+    }
+  }
+  dataset_weighted_sampler_destroy(epochs);
+  // With replacement, row 7 takes half of the draws.
+  struct dataset_weighted_sampler *weighted = dataset_weighted_sampler_create(data, weights, 1, 7);
+  int draws = 64 * 625;
+  for (int k = 0; status == 0 && k < draws / 64; k++) {
+    status = weighted != NULL && dataset_weighted_sampler_draw(weighted, drawn, 64) == 64 ? 0 : -1;
+    for (int i = 0; status == 0 && i < 64; i++) {
+      counts[*(int *)drawn[i]->inputs->entries[0]->data]++;
+    }
+  }
+  if (status == 0 && (counts[5] != 0 || counts[7] < draws / 2 - 1000 || counts[7] > draws / 2 + 1000)) {
+    status = -1;
+  }
+  dataset_weighted_sampler_destroy(weighted);
+  // Balanced classes take a third of the draws each.
+  struct dataset_weighted_sampler *balanced = dataset_weighted_sampler_create(data, NULL, 1, 7);
+  int classes[3] = {0};
+  for (int k = 0; status == 0 && k < draws / 64; k++) {
+    status = balanced != NULL && dataset_weighted_sampler_draw(balanced, drawn, 64) == 64 ? 0 : -1;
+    for (int i = 0; status == 0 && i < 64; i++) {
+      classes[*(int *)drawn[i]->outputs->entries[0]->data]++;
+    }
+  }
+  for (int c = 0; status == 0 && c < 3; c++) {
+    status = classes[c] > draws / 3 - 1000 && classes[c] < draws / 3 + 1000 ? 0 : -1;
+  }
+  dataset_weighted_sampler_destroy(balanced);
+  dataset_destroy(data);
+  return status;
+}
+
+// The producer threads of the concurrent check and the rows each one appends.
+#define CHECK_CONCURRENT_THREADS 4
+#define CHECK_CONCURRENT_ROWS 2000
+
+/**
+ * Represents the work of a producer thread of the concurrent check.
+ */
+struct check_concurrent_context {
+  /**
+   * The dataset the rows are appended to.
+   *
+   * @var struct dataset *
+   */
+  struct dataset *data;
+
+  /**
+   * The first row of the thread, which appends CHECK_CONCURRENT_ROWS rows.
+   *
+   * @var int
+   */
+  int first;
+};
+
+/**
+ * Appends the rows of a producer thread, one at a time and then by buffers.
+ *
+ * @param void *context
+ *   The check context, a dataset and the first row of the thread.
+ *
+ * @return void*
+ *   NULL if every append succeeded, or the context otherwise.
+ */
+static void *check_concurrent_producer(void *context) {
+  struct dataset *data = ((struct check_concurrent_context *)context)->data;
+  int first = ((struct check_concurrent_context *)context)->first;
+  void *failed = NULL;
+  for (int i = first; i < first + CHECK_CONCURRENT_ROWS / 2; i++) {
+    if (dataset_append_row_concurrent(data, check_row(i)) != 0) {
+      failed = context;
+    }
+  }
+  // The other half goes through buffers of 7 rows, the last one being shorter.
+  struct dataset_append_buffer buffer;
+  dataset_append_buffer_init(&buffer);
+  for (int i = first + CHECK_CONCURRENT_ROWS / 2; i < first + CHECK_CONCURRENT_ROWS; i++) {
+    dataset_append_buffer_push(&buffer, check_row(i));
+    if ((buffer.size == 7 || i == first + CHECK_CONCURRENT_ROWS - 1) && dataset_append_buffer_flush(data, &buffer) != 0) {
+      failed = context;
+    }
+  }
+  return failed;
+}
+
+/**
+ * Appends rows from several threads and walks the result in both directions.
+ *
+ * Each thread appends its own range of rows, which must all be found in the order
+ * the thread appended them.
+ *
+ * @return int
+ *   Returns 0 if the dataset is consistent, or -1 otherwise.
+ */
+static int check_concurrent_append() {
+  struct dataset *data = dataset_create();
+  struct check_concurrent_context contexts[CHECK_CONCURRENT_THREADS];
+  pthread_t threads[CHECK_CONCURRENT_THREADS];
+  int started = 0;
+  int status = 0;
+  for (; started < CHECK_CONCURRENT_THREADS; started++) {
+    contexts[started].data = data;
+    contexts[started].first = started * CHECK_CONCURRENT_ROWS;
+    if (pthread_create(&threads[started], NULL, check_concurrent_producer, &contexts[started]) != 0) {
+      status = -1;
+      break;
+    }
+  }
+  for (int t = 0; t < started; t++) {
+    void *failed = NULL;
+    if (pthread_join(threads[t], &failed) != 0 || failed != NULL) {
+      status = -1;
+    }
+  }
+  int64_t rows = (int64_t)started * CHECK_CONCURRENT_ROWS;
+  if (status == 0) {
+    status = check_links(data, rows);
+  }
+  // Every thread's rows come in order.
+  int next[CHECK_CONCURRENT_THREADS] = {0};
+  for (struct data_row *row = status == 0 ? data->iterator : NULL; row != NULL; row = row->next) {
+    int i = *(int *)row->inputs->entries[0]->data;
+    int thread = i / CHECK_CONCURRENT_ROWS;
+    if (thread < 0 || thread >= started || i % CHECK_CONCURRENT_ROWS != next[thread]++) {
+      status = -1;
+    }
+  }
+  dataset_destroy(data);
+  return status;
+}
+
+/**
+ * Splits a dataset into shards, saves them and loads them back.
+ *
+ * The 23 rows do not divide evenly into 4 shards, so the shard sizes differ.
+ *
+ * @param enum dataset_shard_mode mode
+ *   How the rows are distributed among shards.
+ *
+ * @return int
+ *   Returns 0 if the shards cover every row once and load back, or -1 otherwise.
+ */
+static int check_shards(enum dataset_shard_mode mode) {
+  const char *path = "libdataset_check.shard";
+  char shard_path[64];
+  int rows = 23;
+  int shards = 4;
+  struct dataset *data = dataset_create();
+  for (int i = 0; i < rows; i++) {
+    dataset_append_row(data, check_row(i));
+  }
+  int status = dataset_save_shards(data, path, shards, mode, DATA_ENTRY_TYPE_INT);
+  int owners[23];
+  memset(owners, -1, sizeof(owners));
+  for (int s = 0; status == 0 && s < shards; s++) {
+    struct dataset_view *view = dataset_shard(data, s, shards, mode);
+    snprintf(shard_path, sizeof(shard_path), "%s.%d", path, s);
+    struct dataset *loaded = dataset_load(shard_path);
+    if (view == NULL || loaded == NULL || loaded->size != view->size || view->size < rows / shards || view->size > rows / shards + 1) {
+      status = -1;
+    }
+    // Each row belongs to this shard only, in dataset order, and is loaded back.
+    struct data_row *row = status == 0 ? loaded->iterator : NULL;
+    for (int k = 0; status == 0 && k < view->size; k++, row = row->next) {
+      int i = *(int *)view->rows[k]->inputs->entries[0]->data;
+      if (owners[i] != -1 || (k > 0 && i <= *(int *)view->rows[k - 1]->inputs->entries[0]->data) || dataset_shard_of(i, rows, shards, mode) != s || !check_row_is(row, i)) {
+        status = -1;
+      }
+      owners[i] = s;
+    }
+    dataset_view_destroy(view);
+    dataset_destroy(loaded);
+    remove(shard_path);
+  }
+  for (int i = 0; status == 0 && i < rows; i++) {
+    status = owners[i] >= 0 ? 0 : -1;
+  }
+  // The whole dataset loads back row for row.
+  if (status == 0) {
+    status = dataset_save(data, path, DATA_ENTRY_TYPE_INT);
+  }
+  struct dataset *loaded = status == 0 ? dataset_load(path) : NULL;
+  if (status == 0 && (loaded == NULL || loaded->size != rows)) {
+    status = -1;
+  }
+  int i = 0;
+  for (struct data_row *row = status == 0 ? loaded->iterator : NULL; row != NULL; row = row->next, i++) {
+    if (!check_row_is(row, i)) {
+      status = -1;
+    }
+  }
+  dataset_destroy(loaded);
+  dataset_destroy(data);
+  remove(path);
+  return status;
+}
+
+/**
+ * Keeps the rows whose input is a multiple of the context.
+ *
+ * @param struct data_row *row
+ *   The row.
+ * @param void *context
+ *   The divisor, as an `int *`.
+ *
+ * @return int
+ *   1 to keep the row, 0 otherwise.
+ */
+static int check_multiple_of(struct data_row *row, void *context) {
+  return *(int *)row->inputs->entries[0]->data % *(int *)context == 0;
+}
+
+/**
+ * Builds the row following a row, failing for one input.
+ *
+ * @param struct data_row *row
+ *   The row.
+ * @param void *context
+ *   The input that fails, as an `int *`.
+ *
+ * @return struct data_row*
+ *   A new row made by `check_row`, or NULL for the failing input.
+ */
+static struct data_row *check_map_next(struct data_row *row, void *context) {
+  int i = *(int *)row->inputs->entries[0]->data;
+  return i == *(int *)context ? NULL : check_row(i + 1);
+}
+
+/**
+ * Turns a row into the row following it, failing for one input.
+ *
+ * @param struct data_row *row
+ *   The row.
+ * @param void *context
+ *   The input that fails, as an `int *`.
+ *
+ * @return int
+ *   Returns 0 on success, or -1 for the failing input, which is left unchanged.
+ */
+static int check_update_next(struct data_row *row, void *context) {
+  int i = *(int *)row->inputs->entries[0]->data;
+  if (i == *(int *)context) {
+    return -1;
+  }
+  *(int *)row->inputs->entries[0]->data = i + 1;
+  *(int *)row->inputs->entries[1]->data = -(i + 1);
+  *(int *)row->outputs->entries[0]->data = (i + 1) * (i + 1);
+  return 0;
+}
+
+/**
+ * Filters and maps a dataset on several threads.
+ *
+ * The results must keep the order of the rows, and a function failing for a
+ * single row must fail the whole map without leaking the rows already built.
+ *
+ * @return int
+ *   Returns 0 if every transform gives the expected rows, or -1 otherwise.
+ */
+static int check_transforms() {
+  int rows = 1000;
+  int threads = 4;
+  struct dataset *data = dataset_create();
+  for (int i = 0; i < rows; i++) {
+    dataset_append_row(data, check_row(i));
+  }
+  // A third of the rows are selected, in order.
+  int divisor = 3;
+  struct dataset_view *view = dataset_filter(data, check_multiple_of, &divisor, threads);
+  int status = view != NULL && view->size == (rows + 2) / 3 ? 0 : -1;
+  for (int k = 0; status == 0 && k < view->size; k++) {
+    status = check_row_is(view->rows[k], 3 * k) ? 0 : -1;
+  }
+  dataset_view_destroy(view);
+  // A map failing for one row gives no dataset, a valid one gives the next rows.
+  int failing = rows / 2 + 1;
+  struct dataset *mapped = dataset_map(data, check_map_next, &failing, threads);
+  if (mapped != NULL) {
+    status = -1;
+    dataset_destroy(mapped);
+  }
+  failing = -1;
+  mapped = status == 0 ? dataset_map(data, check_map_next, &failing, threads) : NULL;
+  if (status == 0 && (mapped == NULL || check_links(mapped, rows) != 0)) {
+    status = -1;
+  }
+  int i = 1;
+  for (struct data_row *row = status == 0 ? mapped->iterator : NULL; row != NULL; row = row->next, i++) {
+    if (!check_row_is(row, i)) {
+      status = -1;
+    }
+  }
+  dataset_destroy(mapped);
+  // The odd rows are removed in place.
+  divisor = 2;
+  if (status == 0 && (dataset_filter_in_place(data, check_multiple_of, &divisor, threads) != rows / 2 || check_links(data, rows / 2) != 0)) {
+    status = -1;
+  }
+  // An update failing for one row still updates the others.
+  failing = rows / 2;
+  if (status == 0 && dataset_map_in_place(data, check_update_next, &failing, threads) != -1) {
+    status = -1;
+  }
+  i = 0;
+  for (struct data_row *row = status == 0 ? data->iterator : NULL; row != NULL; row = row->next, i += 2) {
+    if (!check_row_is(row, i == failing ? i : i + 1)) {
+      status = -1;
+    }
+  }
+  dataset_destroy(data);
+  return status;
+}
+
+/**
+ * Moves rows between datasets with concat and with a sorted merge.
+ *
+ * The merged rows are keyed by their second input, with keys shared between the
+ * datasets, and row i of dataset d has the first input 100 * d + i.
+ *
+ * @return int
+ *   Returns 0 if the rows are moved in order and the sources left empty, or -1 otherwise.
+ */
+static int check_concat_merge() {
+  struct dataset *destination = dataset_create();
+  struct dataset *source = dataset_create();
+  for (int i = 0; i < 17; i++) {
+    dataset_append_row(i < 10 ? destination : source, check_row(i));
+  }
+  int status = dataset_concat(destination, source) == 0 && check_links(destination, 17) == 0 && check_links(source, 0) == 0 ? 0 : -1;
+  // Back into the emptied source, then from an empty one.
+  if (status == 0 && (dataset_concat(source, destination) != 0 || dataset_concat(source, destination) != 0 || check_links(source, 17) != 0 || check_links(destination, 0) != 0)) {
+    status = -1;
+  }
+  int i = 0;
+  for (struct data_row *row = status == 0 ? source->iterator : NULL; row != NULL; row = row->next, i++) {
+    if (!check_row_is(row, i)) {
+      status = -1;
+    }
+  }
+  dataset_destroy(destination);
+  dataset_destroy(source);
+  // Each sorted dataset has keys in common with the others.
+  int keys[3][5] = {{0, 0, 1, 2, 2}, {0, 1, 1, 2, -1}, {1, 2, 2, 3, -1}};
+  struct dataset *sorted[3];
+  for (int d = 0; d < 3; d++) {
+    sorted[d] = dataset_create();
+    for (int k = 0; k < 5 && keys[d][k] >= 0; k++) {
+      struct data_row *row = check_row(100 * d + k);
+      *(int *)row->inputs->entries[1]->data = keys[d][k];
+      dataset_append_row(sorted[d], row);
+    }
+  }
+  struct dataset *merged = status == 0 ? dataset_merge_sorted(sorted, 3, DATA_ROW_INPUTS, 1, DATA_ENTRY_TYPE_INT, DATASET_SORT_ASCENDING) : NULL;
+  if (status == 0 && (merged == NULL || check_links(merged, 13) != 0)) {
+    status = -1;
+  }
+  // Rows with equal keys keep the order of the datasets they come from.
+  struct data_row *row = status == 0 ? merged->iterator : NULL;
+  for (int key = 0; status == 0 && key <= 3; key++) {
+    for (int d = 0; d < 3; d++) {
+      for (int k = 0; status == 0 && k < 5; k++) {
+        if (keys[d][k] != key) {
+          continue;
+        }
+        if (row == NULL || *(int *)row->inputs->entries[0]->data != 100 * d + k) {
+          status = -1;
+        } else {
+          row = row->next;
+        }
+      }
+    }
+  }
+  for (int d = 0; d < 3; d++) {
+    if (status == 0 && check_links(sorted[d], 0) != 0) {
+      status = -1;
+    }
+    dataset_destroy(sorted[d]);
+  }
+  dataset_destroy(merged);
+  return status;
+}
+
+/**
+ * Checks that two datasets hold the same integer or vector entries.
+ *
+ * @param struct dataset *expected
+ *   The expected dataset.
+ * @param struct dataset *actual
+ *   The compared dataset.
+ * @param enum data_entry_type type
+ *   The type of the entries, DATA_ENTRY_TYPE_INT or DATA_ENTRY_TYPE_VECTOR.
+ *
+ * @return int
+ *   Returns 0 if the datasets are equal, or -1 otherwise.
+ */
+static int check_datasets_equal(struct dataset *expected, struct dataset *actual, enum data_entry_type type) {
+  if (expected == NULL || actual == NULL || expected->size != actual->size) {
+    return -1;
+  }
+  struct data_row *other = actual->iterator;
+  for (struct data_row *row = expected->iterator; row != NULL; row = row->next, other = other->next) {
+    for (int side = 0; side < 2; side++) {
+      struct data_entries *entries = side == 0 ? row->inputs : row->outputs;
+      struct data_entries *others = side == 0 ? other->inputs : other->outputs;
+      if (entries->size != others->size) {
+        return -1;
+      }
+      for (int64_t i = 0; i < entries->size; i++) {
+        if (type == DATA_ENTRY_TYPE_INT && *(int *)entries->entries[i]->data != *(int *)others->entries[i]->data) {
+          return -1;
+        }
+        struct vector *vector = entries->entries[i]->data;
+        struct vector *other_vector = others->entries[i]->data;
+        if (type == DATA_ENTRY_TYPE_VECTOR && (vector->length != other_vector->length || memcmp(vector->elements, other_vector->elements, (size_t)vector->length * sizeof(double)) != 0)) {
+          return -1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * Grows a string dataset in batches and keeps chained encoders in sync.
+ *
+ * An integer encoder reads the strings and a one-hot encoder reads its output.
+ * After the last batch, both outputs must match a one-shot encoding.
+ *
+ * @return int
+ *   Returns 0 if the encoders match the one-shot encodings, or -1 otherwise.
+ */
+static int check_encoder_sync() {
+  char tokens[] = "0123456789+";
+  int tokens_size = strlen(tokens);
+  int batches[] = {3, 0, 5, 1, 4};
+  struct dataset *strings = dataset_create();
+  struct dataset_encoder *ints = dataset_encoder_create_int(strings, tokens, tokens_size);
+  struct dataset_encoder *one_hot = ints != NULL ? dataset_encoder_create_one_hot(ints->output, tokens_size) : NULL;
+  int status = one_hot != NULL ? 0 : -1;
+  int rows = 0;
+  for (int b = 0; status == 0 && b < 5; b++) {
+    for (int k = 0; k < batches[b]; k++, rows++) {
+      char text[32];
+      struct data_row *row = data_row_create();
+      row->inputs = data_entries_create(1);
+      snprintf(text, sizeof(text), "%d+%d", rows * 7, rows * 13);
+      row->inputs->entries[0] = data_entry_create(strdup(text));
+      row->outputs = data_entries_create(1);
+      snprintf(text, sizeof(text), "%d", rows * 20);
+      row->outputs->entries[0] = data_entry_create(strdup(text));
+      dataset_append_row(strings, row);
+    }
+    // Each sync only encodes the new rows.
+    if (dataset_encoder_sync(ints) != batches[b] || dataset_encoder_sync(one_hot) != batches[b]) {
+      status = -1;
+    }
+  }
+  struct dataset *int_encoded = dataset_int_encode(strings, tokens, tokens_size);
+  struct dataset *one_hot_encoded = int_encoded != NULL ? dataset_one_hot_encode(int_encoded, tokens_size) : NULL;
+  if (status == 0) {
+    status = check_datasets_equal(int_encoded, ints->output, DATA_ENTRY_TYPE_INT);
+  }
+  if (status == 0) {
+    status = check_datasets_equal(one_hot_encoded, one_hot->output, DATA_ENTRY_TYPE_VECTOR);
+  }
+  check_vectors_destroy(one_hot_encoded);
+  check_vectors_destroy(one_hot != NULL ? one_hot->output : NULL);
+  dataset_destroy(one_hot_encoded);
+  dataset_destroy(int_encoded);
+  dataset_encoder_destroy(one_hot);
+  dataset_encoder_destroy(ints);
+  dataset_destroy(strings);
+  return status;
+}
+
+/**
+ * Checks whether a value is equal to the expected one up to rounding errors.
+ *
+ * @param double value
+ *   The value.
+ * @param double expected
+ *   The expected value.
+ *
+ * @return int
+ *   1 if the values are close, 0 otherwise.
+ */
+static int check_close(double value, double expected) {
+  return fabs(value - expected) <= 1e-9 * fmax(1, fabs(expected));
+}
+
+/**
+ * Checks column statistics against known values and against merged partial ones.
+ *
+ * @return int
+ *   Returns 0 if the statistics match, or -1 otherwise.
+ */
+static int check_column_stats() {
+  int rows = 1000;
+  struct dataset *data = dataset_create();
+  for (int i = 0; i < rows; i++) {
+    dataset_append_row(data, check_row(i));
+  }
+  // The inputs 0 to n - 1 have the mean (n - 1) / 2 and the variance (n^2 - 1) / 12.
+  struct dataset_column_stats stats;
+  int status = dataset_column_stats(data, DATA_ROW_INPUTS, 0, DATA_ENTRY_TYPE_INT, &stats);
+  if (status == 0 && (stats.count != (size_t)rows || stats.min != 0 || stats.max != rows - 1 || !check_close(stats.mean, (rows - 1) / 2.0) || !check_close(dataset_column_stats_variance(&stats), ((double)rows * rows - 1) / 12))) {
+    status = -1;
+  }
+  dataset_destroy(data);
+  // Values far from zero, compared with a two-pass computation.
+  double values[5000];
+  double sum = 0;
+  for (int i = 0; i < 5000; i++) {
+    values[i] = 1e6 + (i * 7919 % 1000) * 0.25;
+    sum += values[i];
+  }
+  double mean = sum / 5000;
+  double squares = 0;
+  for (int i = 0; i < 5000; i++) {
+    squares += (values[i] - mean) * (values[i] - mean);
+  }
+  // The first part one value at a time, the second as an array, then merged.
+  struct dataset_column_stats first;
+  struct dataset_column_stats second;
+  struct dataset_column_stats empty;
+  dataset_column_stats_init(&first);
+  dataset_column_stats_init(&second);
+  dataset_column_stats_init(&empty);
+  for (int i = 0; i < 1234; i++) {
+    dataset_column_stats_update(&first, values[i]);
+  }
+  dataset_column_stats_update_array(&second, values + 1234, 5000 - 1234);
+  dataset_column_stats_merge(&first, &empty);
+  dataset_column_stats_merge(&empty, &second);
+  dataset_column_stats_merge(&first, &empty);
+  if (status == 0 && (first.count != 5000 || first.min != 1e6 || first.max != 1e6 + 999 * 0.25 || !check_close(first.mean, mean) || !check_close(dataset_column_stats_variance(&first), squares / 5000))) {
+    status = -1;
+  }
+  return status;
+}
+
+/**
+ * Checks that a view holds distinct rows of its dataset, in dataset order.
+ *
+ * @param struct dataset_view *view
+ *   The view of rows made by `check_row`.
+ *
+ * @return int
+ *   Returns 0 if the inputs of the rows increase strictly, or -1 otherwise.
+ */
+static int check_view_ordered(struct dataset_view *view) {
+  for (int k = 1; view != NULL && k < view->size; k++) {
+    if (*(int *)view->rows[k - 1]->inputs->entries[0]->data >= *(int *)view->rows[k]->inputs->entries[0]->data) {
+      return -1;
+    }
+  }
+  return view != NULL ? 0 : -1;
+}
+
+/**
+ * Draws reservoir and stratified samples and checks their rows.
+ *
+ * The stratified sample uses the classes of the weighted sampling check, with 13,
+ * 4 and 3 rows.
+ *
+ * @return int
+ *   Returns 0 if the samples are deterministic and complete, or -1 otherwise.
+ */
+static int check_samples() {
+  int rows = 200;
+  struct dataset *data = dataset_create();
+  for (int i = 0; i < rows; i++) {
+    dataset_append_row(data, check_row(i));
+  }
+  // The same seed draws the same rows, another one draws other rows.
+  struct dataset_view *first = dataset_sample_reservoir(data, 30, 42);
+  struct dataset_view *second = dataset_sample_reservoir(data, 30, 42);
+  struct dataset_view *other = dataset_sample_reservoir(data, 30, 43);
+  int status = check_view_ordered(first) == 0 && check_view_ordered(second) == 0 && check_view_ordered(other) == 0 ? 0 : -1;
+  if (status == 0 && (first->size != 30 || second->size != 30 || other->size != 30 || memcmp(first->rows, second->rows, 30 * sizeof(struct data_row *)) != 0 || memcmp(first->rows, other->rows, 30 * sizeof(struct data_row *)) == 0)) {
+    status = -1;
+  }
+  dataset_view_destroy(first);
+  dataset_view_destroy(second);
+  dataset_view_destroy(other);
+  // A sample of at least the whole dataset holds every row.
+  for (int k = rows; status == 0 && k <= rows + 1; k++) {
+    struct dataset_view *all = dataset_sample_reservoir(data, k, 42);
+    status = check_view_ordered(all) == 0 && all->size == rows ? 0 : -1;
+    dataset_view_destroy(all);
+  }
+  // Rows 0 to 9 are in class 0, the next ones in class i % 3.
+  struct dataset *classes = dataset_create();
+  for (int i = 0; i < 20; i++) {
+    struct data_row *row = check_row(i);
+    *(int *)row->outputs->entries[0]->data = i < 10 ? 0 : i % 3;
+    dataset_append_row(classes, row);
+  }
+  struct dataset_view *stratified = dataset_sample_stratified(classes, 5, 42);
+  int counts[3] = {0};
+  if (status == 0 && check_view_ordered(stratified) != 0) {
+    status = -1;
+  }
+  for (int k = 0; status == 0 && k < stratified->size; k++) {
+    counts[*(int *)stratified->rows[k]->outputs->entries[0]->data]++;
+  }
+  if (status == 0 && (counts[0] != 5 || counts[1] != 4 || counts[2] != 3)) {
+    status = -1;
+  }
+  dataset_view_destroy(stratified);
+  dataset_destroy(classes);
+  dataset_destroy(data);
+  return status;
+}
+
+/**
+ * Compares the output keys of two rows made by `check_sort`.
+ *
+ * @param struct data_row *first
+ *   The first row.
+ * @param struct data_row *second
+ *   The second row.
+ * @param enum data_entry_type type
+ *   The type of the keys.
+ *
+ * @return int
+ *   A negative, zero or positive value as the first key is lower, equal or higher.
+ */
+static int check_sort_compare(struct data_row *first, struct data_row *second, enum data_entry_type type) {
+  void *a = first->outputs->entries[0]->data;
+  void *b = second->outputs->entries[0]->data;
+  if (type == DATA_ENTRY_TYPE_INT) {
+    return (*(int *)a > *(int *)b) - (*(int *)a < *(int *)b);
+  }
+  if (type == DATA_ENTRY_TYPE_DOUBLE) {
+    return (*(double *)a > *(double *)b) - (*(double *)a < *(double *)b);
+  }
+  return strcmp(a, b);
+}
+
+/**
+ * Sorts rows with duplicate keys and checks that equal keys keep their order.
+ *
+ * Row i has the input i and one of 7 keys as output, negative numbers and strings
+ * with shared prefixes included. Every tenth row has no output and must end up
+ * last.
+ *
+ * @param enum data_entry_type type
+ *   The type of the keys: DATA_ENTRY_TYPE_INT, DATA_ENTRY_TYPE_DOUBLE or DATA_ENTRY_TYPE_STRING.
+ * @param enum dataset_sort_order order
+ *   The order of the sort.
+ *
+ * @return int
+ *   Returns 0 if the rows are sorted and the sort is stable, or -1 otherwise.
+ */
+static int check_sort(enum data_entry_type type, enum dataset_sort_order order) {
+  const char *strings[] = {"b", "", "ab", "a", "ba", "abc", "b\xC3\xA9"};
+  int rows = 500;
+  struct dataset *data = dataset_create();
+  for (int i = 0; i < rows; i++) {
+    int key = i * 37 % 7;
+    struct data_row *row = data_row_create();
+    row->inputs = data_entries_create(1);
+    row->inputs->entries[0] = data_entry_create_int(i);
+    row->outputs = data_entries_create(i % 10 == 9 ? 0 : 1);
+    if (i % 10 != 9 && type == DATA_ENTRY_TYPE_INT) {
+      row->outputs->entries[0] = data_entry_create_int((key - 3) * 1000003);
+    } else if (i % 10 != 9 && type == DATA_ENTRY_TYPE_DOUBLE) {
+      row->outputs->entries[0] = data_entry_create_double((key - 3) * 1.5);
+    } else if (i % 10 != 9) {
+      row->outputs->entries[0] = data_entry_create(strdup(strings[key]));
+    }
+    dataset_append_row(data, row);
+  }
+  int status = dataset_sort_by(data, DATA_ROW_OUTPUTS, 0, type, order) == 0 ? check_links(data, rows) : -1;
+  int direction = order == DATASET_SORT_ASCENDING ? 1 : -1;
+  for (struct data_row *row = status == 0 ? data->iterator : NULL; row != NULL && row->next != NULL; row = row->next) {
+    struct data_row *next = row->next;
+    int keyed = row->outputs->size > 0;
+    int next_keyed = next->outputs->size > 0;
+    int comparison = keyed && next_keyed ? check_sort_compare(row, next, type) * direction : next_keyed - keyed;
+    // Keys follow the order and rows with equal keys keep their input order.
+    if (comparison > 0 || (comparison == 0 && *(int *)row->inputs->entries[0]->data >= *(int *)next->inputs->entries[0]->data)) {
+      status = -1;
+    }
+  }
+  dataset_destroy(data);
+  return status;
+}
+
 /**
  * Main function to control the flow of the program.
  *
@@ -26,16 +1437,132 @@ int main(int argc, char const *argv[]) {
   struct dataset *string_dataset = dataset_string_encode(int_dataset);
   // Print the string dataset.
   dataset_print(string_dataset, &data_entry_print_string);
+  // Hash the string dataset bigrams into sparse vectors.
+  struct dataset *hashed_dataset = dataset_hash_encode(string_dataset, 16, 2, 1);
+  // Print the hashed dataset.
+  dataset_print(hashed_dataset, &data_entry_print_sparse);
+  dataset_destroy(hashed_dataset);
   // Define the list of supported tokens to prepare the array for one hot encoding..
   char tokens[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', ' ', '\0'};
   int tokens_size = strlen(tokens);
   struct dataset *int_encoded_dataset = dataset_int_encode(string_dataset, tokens, tokens_size);
   // Print the integer encoded dataset.
   dataset_print(int_encoded_dataset, &data_entry_print_int);
+  // Encode the string dataset again with a compiled tokenizer that also knows multi-byte tokens.
+  char *vocabulary[] = {"0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "+", " ", "10", "20", "30"};
+  struct dataset_tokenizer *tokenizer = dataset_tokenizer_create(vocabulary, 15);
+  struct dataset *tokenized_dataset = dataset_tokenizer_encode_dataset(string_dataset, tokenizer);
+  // Print the tokenized dataset.
+  dataset_print(tokenized_dataset, &data_entry_print_int);
+  dataset_destroy(tokenized_dataset);
+  dataset_tokenizer_destroy(tokenizer);
   // One hot encode
   struct dataset *one_hot_encoded_dataset = dataset_one_hot_encode(int_encoded_dataset, tokens_size);
   // Print the One hot encoded dataset.
   dataset_print(one_hot_encoded_dataset, &data_entry_print_vector);
+  // One hot encode again, memoizing the vector of each token.
+  struct dataset_encode_cache *cache = dataset_encode_cache_create(tokens_size, DATA_ENTRY_TYPE_INT, DATA_ENTRY_TYPE_VECTOR);
+  struct dataset *cached_dataset = dataset_one_hot_encode_cached(int_encoded_dataset, tokens_size, cache);
+  struct dataset_encode_cache_stats cache_stats;
+  dataset_encode_cache_get_stats(cache, &cache_stats);
+  printf("One hot cache: %zu hits, %zu misses.\n", cache_stats.hits, cache_stats.misses);
+  dataset_destroy(cached_dataset);
+  dataset_encode_cache_destroy(cache);
+  // Decode the one-hot dataset back into the integer encoded dataset.
+  struct dataset *one_hot_decoded_dataset = dataset_one_hot_decode(one_hot_encoded_dataset);
+  // Print the One hot decoded dataset.
+  dataset_print(one_hot_decoded_dataset, &data_entry_print_int);
+  dataset_destroy(one_hot_decoded_dataset);
+  // Gather the integer encoded dataset into one-hot batches on background threads.
+  struct dataset_batch_layout input_layout = {DATA_ENTRY_TYPE_INT, 5, tokens_size};
+  struct dataset_batch_layout output_layout = {DATA_ENTRY_TYPE_INT, 3, tokens_size};
+  struct dataset_loader *loader = dataset_loader_create(int_encoded_dataset, 4, 2, 2, &input_layout, &output_layout);
+  struct dataset_batch *batch = NULL;
+  while ((batch = dataset_loader_next_batch(loader)) != NULL) {
+    printf("Batch #%d: %d rows of %d input and %d output values.\n", batch->index, batch->size, batch->input_width, batch->output_width);
+    dataset_loader_release_batch(loader, batch);
+  }
+  dataset_loader_destroy(loader);
+  // Draw a uniform sample of the integer dataset without copying any row.
+  struct dataset_view *sample = dataset_sample_reservoir(int_dataset, 3, 42);
+  printf("Sampled %d of %lld rows.\n", sample->size, (long long)int_dataset->size);
+  dataset_view_destroy(sample);
+  // Sort the integer dataset by sum in descending order.
+  dataset_sort_by(int_dataset, DATA_ROW_OUTPUTS, 0, DATA_ENTRY_TYPE_INT, DATASET_SORT_DESCENDING);
+  dataset_print(int_dataset, &data_entry_print_int);
+  // Compute the statistics of the sums.
+  struct dataset_column_stats stats;
+  dataset_column_stats(int_dataset, DATA_ROW_OUTPUTS, 0, DATA_ENTRY_TYPE_INT, &stats);
+  printf("Sums: min %g, max %g, mean %g, variance %g.\n", stats.min, stats.max, stats.mean, dataset_column_stats_variance(&stats));
+  // Copy the sums into a double column, one per row, and standardize it in place.
+  double *sums = malloc((size_t)int_dataset->size * sizeof(double));
+  int sums_size = 0;
+  for (struct data_row *row = int_dataset->iterator; row != NULL; row = row->next) {
+    sums[sums_size++] = *(int *)row->outputs->entries[0]->data;
+  }
+  struct dataset *sums_dataset = dataset_from_windows(sums, sums_size, 1, 0, 1);
+  free(sums);
+  dataset_standardize(sums_dataset, DATA_ROW_INPUTS, 0, DATA_ENTRY_TYPE_DOUBLE, &stats);
+  dataset_column_stats(sums_dataset, DATA_ROW_INPUTS, 0, DATA_ENTRY_TYPE_DOUBLE, &stats);
+  printf("Standardized sums: variance %.3f.\n", dataset_column_stats_variance(&stats));
+  dataset_destroy(sums_dataset);
+  // Check that exported and saved data reads back unchanged.
+  int status = EXIT_SUCCESS;
+  if (check_report("Plain text output", check_text_plain()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("NumPy round-trip", check_npy_round_trip()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Journal recovery", check_journal_recovery()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Label round-trip", check_label_round_trip()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Packed vectors", check_pack_round_trip()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Sliding windows", check_windows()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("64-bit sizes", check_large_sizes()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Weighted sampling", check_weighted_sampler()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Concurrent appends", check_concurrent_append()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Contiguous shards", check_shards(DATASET_SHARD_CONTIGUOUS)) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Round-robin shards", check_shards(DATASET_SHARD_ROUND_ROBIN)) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Parallel transforms", check_transforms()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Concat and merge", check_concat_merge()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Encoder sync", check_encoder_sync()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Column statistics", check_column_stats()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  if (check_report("Row samples", check_samples()) != EXIT_SUCCESS) {
+    status = EXIT_FAILURE;
+  }
+  enum data_entry_type sort_types[] = {DATA_ENTRY_TYPE_INT, DATA_ENTRY_TYPE_DOUBLE, DATA_ENTRY_TYPE_STRING};
+  const char *sort_names[] = {"Stable integer sort", "Stable double sort", "Stable string sort"};
+  for (int k = 0; k < 3; k++) {
+    if (check_report(sort_names[k], check_sort(sort_types[k], DATASET_SORT_ASCENDING) == 0 ? check_sort(sort_types[k], DATASET_SORT_DESCENDING) : -1) != EXIT_SUCCESS) {
+      status = EXIT_FAILURE;
+    }
+  }
   // Clean up memory.
   dataset_destroy(int_dataset);
   dataset_destroy(string_dataset);
@@ -45,6 +1572,6 @@ int main(int argc, char const *argv[]) {
   string_dataset = NULL;
   int_encoded_dataset = NULL;
   one_hot_encoded_dataset = NULL;
-  // Return success status.
-  return EXIT_SUCCESS;
+  // Return the status of the checks.
+  return status;
 }